@@ -2,15 +2,95 @@
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
 #include "hardware/pwm.h"
+#include "hardware/clocks.h"
 #include "pico/bootrom.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+#include "pico/flash.h"
+#include "pico/stdio/driver.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
 
 #include "lib/ssd1306.h"
 #include "lib/sensores.h"
-#include "lib/font.h" 
 #include "lib/ws2812b.h"
+#include "lib/color.h"
+#include "lib/color_class.h"
+#include "lib/sample_ring.h"
+#include "lib/prof.h"
+#include "lib/telemetry.h"
+#include "lib/sched.h"
+#include "lib/ui.h"
+#include "lib/filter.h"
+#include "lib/calib.h"
+#include "lib/flash_log.h"
+#include "lib/fade.h"
+#include "lib/pwm_seq.h"
+#include "lib/boot.h"
 
-// --- Constantes ---
-#define MAX_LUX 1000 // Valor máximo de lux para o cálculo de intensidade (ajuste conforme necessário)
+// --- Calibração (lib/calib.h) ---
+// Balanço de branco, escala de lux (antes MAX_LUX) e a última exposição
+// estável do GY-33 ficam no último setor da flash. 'w' no monitor serial
+// calibra o branco com a amostra atual, 'm' usa o lux atual como intensidade
+// máxima e 'c' mostra o registro em vigor.
+#define CALIB_TASK_PERIOD_US 1000000
+#define CALIB_TASK_DEADLINE_US 500000
+#define CALIB_STEP_STABLE_US 30000000 // Exposição parada por 30 s antes de gravar
+
+// --- Histórico na flash (lib/flash_log.h) ---
+// Uma amostra por segundo: ~11 bytes cada, ~12 h nos 512 KB do log. 'd' no
+// monitor serial envia o log inteiro pela telemetria (tools/telemetry_decode.py
+// --log) e 'l' mostra as estatísticas.
+#define LOG_INTERVAL_MS 1000
+#define LOG_TASK_PERIOD_US 20000
+#define LOG_TASK_DEADLINE_US 100000 // Apagar um setor para a flash por ~50 ms
+
+// --- Transições dos LEDs (lib/fade.h) ---
+// A tarefa dos LEDs só publica a cor alvo; um timer de 100 Hz com interrupção
+// no núcleo 1 anda um passo por vez e escreve o PWM e a matriz, trocando de
+// cor em FADE_STEPS passos (160 ms) em vez de saltar a cada amostra.
+#define FADE_TICK_US 10000
+
+// --- Classificação de cor (lib/color_class.h) ---
+// Classes que disparam o alerta do buzzer, além da luminosidade zero
+#define ALERT_CLASSES COLOR_CLASS_BIT(COLOR_CLASS_RED)
+
+static const color_class_config_t color_class_cfg = {
+    .gain_r = 256, .gain_g = 256, .gain_b = 256, // O balanço de branco já vem da calibração
+    .min_saturation = 48,                        // ~19%: abaixo disso é branco/cinza
+    .min_value = GY33_COUNTS_1X11(8),            // Maior canal mínimo (8 na exposição antiga)
+};
+
+// --- Filtros das leituras (lib/filter.h) ---
+// Cor: até ~100 amostras/s (uma por integração do GY-33, menos com pouca
+// luz), EMA com constante de ~8 amostras (80 ms ou mais) e faixa morta de
+// 1/128 do valor (mínimo de 2 contagens), que acompanha a escala dos canais
+// do fraco ao forte. Lux: ~5,5 amostras/s (conversão de até 180 ms do
+// BH1750), só EMA curta, sem mediana nem histerese. Uma leitura zero (alerta
+// de escuro do buzzer) passa direto e reinicia o filtro: com a mediana e a
+// EMA ela levaria ~14 amostras (~2,5 s) para sair de ~1000 lx. Para
+// reavaliar: colorlux_filter_replay sobre sim/data/filter_trace.csv.
+#define COLOR_FILTER_EMA_SHIFT 3
+#define COLOR_FILTER_BAND 2
+#define COLOR_FILTER_BAND_SHIFT 7
+#define LUX_FILTER_EMA_SHIFT 1
+#define LUX_FILTER_BAND 0
+
+// --- Tarefas (lib/sched.h) ---
+// Cada atividade roda na sua taxa natural; entre elas os núcleos dormem em WFE.
+// Intervalo de consulta do AVALID do GY-33: perto de um ciclo de ATIME
+// (2,4 ms), para pegar cada integração (9,6-240 ms) logo que termina
+#define COLOR_TASK_PERIOD_US 2500
+#define COLOR_TASK_DEADLINE_US 1000
+#define LUX_TASK_PERIOD_US 20000        // O BH1750 converte a cada 120-180 ms; só lê quando há valor novo
+#define LUX_TASK_DEADLINE_US 5000
+#define TELEMETRY_TASK_PERIOD_US 10000
+#define TELEMETRY_TASK_DEADLINE_US 5000
+#define LEDS_TASK_DEADLINE_US 5000      // Esporádica: disparada a cada amostra publicada
+#define DISPLAY_TASK_PERIOD_US 100000   // 10 Hz bastam para leitura no display
+#define DISPLAY_TASK_DEADLINE_US 50000
+#define CONSOLE_TASK_PERIOD_US 50000
+#define CONSOLE_TASK_DEADLINE_US 50000
 
 // --- Pinos ---
 #define BTN_BOOTSEL_PIN 6
@@ -33,6 +113,126 @@ const float DIVCLK = 16.0; // Divisor inteiro
 static uint slice_21;
 const uint16_t dc_values[] = {PERIOD * 0.3, 0}; // Duty Cycle de 30% e 0%
 
+// Alertas tocados pelo DMA no ritmo do wrap do PWM (lib/pwm_seq.h): a CPU só
+// troca de padrão quando o alerta muda. Luminosidade zero bipa no período
+// acima; classe de alerta alterna duas notas com o nível fixo.
+#define BUZZER_BEEP_MS 150
+#define BUZZER_SIREN_MS 250
+#define BUZZER_SIREN_LOW_HZ 440
+#define BUZZER_SIREN_HIGH_HZ 660
+#define BUZZER_BEEP_MAX 64       // Períodos de ~7,6 ms
+#define BUZZER_SIREN_MAX 320     // Um valor de TOP por período de cada nota
+
+typedef enum { BUZZER_ALERT_NONE, BUZZER_ALERT_DARK, BUZZER_ALERT_COLOR } buzzer_alert_t;
+
+static pwm_seq_t buzzer_seq;
+static uint32_t buzzer_beep[BUZZER_BEEP_MAX];
+static uint32_t buzzer_beep_len;
+static uint32_t buzzer_siren[BUZZER_SIREN_MAX];
+static uint32_t buzzer_siren_len;
+static uint16_t buzzer_siren_level;  // 30% da nota mais aguda
+static buzzer_alert_t buzzer_alert;
+
+// --- Comunicação entre núcleos ---
+// Núcleo 0 lê os sensores e publica amostras; núcleo 1 consome a mais recente
+// e atualiza LEDs, buzzer e display.
+static sample_ring_t sample_ring;
+
+// --- Estado do núcleo 0 ---
+static sensor_sample_t sensor_sample; // Próxima amostra a publicar
+static uint16_t sensor_lux;           // Última leitura do BH1750 (filtrada)
+static bool sensor_lux_valid;         // Já houve uma leitura do BH1750 desde o boot
+static filter_bank_t sensor_filter;
+static bool sensor_filter_active;     // Estado que o núcleo 0 aplicou por último
+static volatile bool filter_bypass;   // 'f' no monitor serial: amostras brutas (núcleo 1 escreve)
+
+// --- Estado do núcleo 1 ---
+static ssd1306_t ssd;
+static ui_t ui;
+static int ui_red, ui_green, ui_blue, ui_lux; // Campos numéricos do display
+static ws2812b_t *ws;
+static sensor_sample_t shown_sample;  // Última amostra aplicada aos LEDs
+static fade_t led_fade;               // Alvo escrito pela tarefa, passos pelo timer
+static repeating_timer_t fade_timer;
+static bool fade_ws_pending;          // Matriz ocupada no último passo: reenviar
+static bool display_dirty;            // shown_sample ainda não foi desenhada
+static calib_data_t calib;            // Carregada no boot, antes de lançar o núcleo 1
+static bool calib_dirty;              // Mudou pelo console: gravar na próxima rodada
+static uint8_t calib_step_seen;       // Exposição do GY-33 observada por último
+static uint64_t calib_step_since_us;  // Desde quando ela não muda
+static uint32_t log_last_ms;          // Última amostra registrada no histórico
+static bool log_dumping;              // Enviando o histórico pela telemetria
+static flash_log_cursor_t log_cursor;
+static uint8_t log_block[FLASH_PAGE_SIZE];
+static uint16_t log_block_num;        // Blocos enviados neste despejo
+static uint8_t log_chunk, log_chunks; // Trecho atual e trechos úteis do bloco
+
+// --- Medição de latência ---
+// Estágios medidos com lib/prof.h; 'p' no monitor serial imprime a tabela
+// (e as estatísticas das tarefas) e 'r' zera tudo.
+enum {
+    STAGE_SAMPLE_AGE,    // Leitura da cor até os LEDs
+    STAGE_TELEMETRY,     // Quadro de telemetria da amostra
+    STAGE_LEDS,          // Cor, alvo da transição e buzzer
+    STAGE_FADE,          // Passo da transição: PWM e matriz WS2812B (interrupção)
+    STAGE_DISPLAY_DRAW,  // Desenho no framebuffer
+    STAGE_DISPLAY_FLUSH, // Envio ao SSD1306
+    STAGE_COUNT
+};
+
+static const char *const stage_names[STAGE_COUNT] = {
+    "sample_age", "telemetry", "leds", "fade", "display_draw", "display_flush",
+};
+
+// --- Tarefas ---
+static void color_task_run(void *arg);
+static void lux_task_run(void *arg);
+static void telemetry_task_run(void *arg);
+static void leds_task_run(void *arg);
+static void display_task_run(void *arg);
+static void console_task_run(void *arg);
+static void calib_task_run(void *arg);
+static void log_task_run(void *arg);
+
+static sched_t sensors_sched; // Núcleo 0
+static sched_t outputs_sched; // Núcleo 1
+
+static sched_task_t color_task = {
+    .name = "color", .fn = color_task_run,
+    .period_us = COLOR_TASK_PERIOD_US, .deadline_us = COLOR_TASK_DEADLINE_US,
+};
+static sched_task_t lux_task = {
+    .name = "lux", .fn = lux_task_run,
+    .period_us = LUX_TASK_PERIOD_US, .deadline_us = LUX_TASK_DEADLINE_US,
+};
+static sched_task_t telemetry_task = {
+    .name = "telemetry", .fn = telemetry_task_run,
+    .period_us = TELEMETRY_TASK_PERIOD_US, .deadline_us = TELEMETRY_TASK_DEADLINE_US,
+    .offset_us = TELEMETRY_TASK_PERIOD_US / 2,
+};
+static sched_task_t leds_task = {
+    .name = "leds", .fn = leds_task_run,
+    .period_us = 0, .deadline_us = LEDS_TASK_DEADLINE_US,
+};
+static sched_task_t display_task = {
+    .name = "display", .fn = display_task_run,
+    .period_us = DISPLAY_TASK_PERIOD_US, .deadline_us = DISPLAY_TASK_DEADLINE_US,
+};
+static sched_task_t console_task = {
+    .name = "console", .fn = console_task_run,
+    .period_us = CONSOLE_TASK_PERIOD_US, .deadline_us = CONSOLE_TASK_DEADLINE_US,
+    .offset_us = CONSOLE_TASK_PERIOD_US / 2,
+};
+static sched_task_t log_task = {
+    .name = "log", .fn = log_task_run,
+    .period_us = LOG_TASK_PERIOD_US, .deadline_us = LOG_TASK_DEADLINE_US,
+    .offset_us = LOG_TASK_PERIOD_US / 2,
+};
+static sched_task_t calib_task = {
+    .name = "calib", .fn = calib_task_run,
+    .period_us = CALIB_TASK_PERIOD_US, .deadline_us = CALIB_TASK_DEADLINE_US,
+};
+
 // --- Funções Auxiliares ---
 
 // Função para configurar um pino para PWM
@@ -45,6 +245,59 @@ void init_pwm_pin(uint pin) {
     pwm_init(slice_num, &config, true);
 }
 
+// Destino da telemetria e único escritor do CDC USB, sempre no núcleo 0:
+// escreve só o que cabe no buffer do TinyUSB, sem esperar o host, pelo
+// driver do stdio_usb e portanto sob o mutex dele (o mesmo da tarefa USB em
+// segundo plano). Sem host conectado nada é aceito, a fila de telemetria
+// enche e os quadros seguintes são descartados e contados.
+static uint32_t telemetry_usb_sink(const uint8_t *data, uint32_t len) {
+    if (!tud_cdc_connected())
+        return 0;
+    uint32_t n = tud_cdc_write_available();
+    if (n > len)
+        n = len;
+    if (n)
+        stdio_usb.out_chars((const char *)data, (int)n);
+    return n;
+}
+
+// Saída do printf (dos dois núcleos): texto em quadros TELEMETRY_TYPE_TEXT
+// na fila da telemetria, para não cortar os quadros binários no CDC. Como o
+// stdio_usb, com a fila cheia espera só com o host conectado e por até
+// CONSOLE_OUT_TIMEOUT_US; a entrada continua vindo do stdio_usb. Só o
+// núcleo 0 esvazia a fila, então só ele espera, escoando-a ele mesmo (um
+// printf do boot não pode esperar por si próprio); no núcleo 1 o quadro que
+// não cabe é descartado e contado, como os da telemetria.
+#define CONSOLE_OUT_TIMEOUT_US 500000 // PICO_STDIO_USB_STDOUT_TIMEOUT_US
+
+static void console_out_chars(const char *buf, int len) {
+    absolute_time_t deadline = make_timeout_time_us(CONSOLE_OUT_TIMEOUT_US);
+    bool drainer = get_core_num() == 0;
+    while (len > 0) {
+        uint8_t n = len > TELEMETRY_MAX_PAYLOAD ? TELEMETRY_MAX_PAYLOAD : (uint8_t)len;
+        while (drainer && telemetry_free() < TELEMETRY_MAX_ENCODED && tud_cdc_connected() &&
+               !time_reached(deadline)) {
+            telemetry_drain(telemetry_usb_sink);
+            uint32_t save = save_and_disable_interrupts(); // Sem a tarefa USB em segundo plano no meio
+            tud_task();
+            restore_interrupts(save);
+            tight_loop_contents();
+        }
+        telemetry_send(TELEMETRY_TYPE_TEXT, time_us_32(), (const uint8_t *)buf, n);
+        buf += n;
+        len -= n;
+    }
+}
+
+static int console_in_chars(char *buf, int len) {
+    return stdio_usb.in_chars(buf, len);
+}
+
+static stdio_driver_t console_stdio = {
+    .out_chars = console_out_chars,
+    .in_chars = console_in_chars,
+};
+
 // Handler de interrupção para o botão BOOTSEL
 void gpio_irq_handler(uint gpio, uint32_t events) {
     if (gpio == BTN_BOOTSEL_PIN) {
@@ -62,26 +315,289 @@ void init_buzzer(uint gpio_pin, float clkdiv, uint16_t period) {
     pwm_set_enabled(slice, true);
 }
 
-// --- Função Principal ---
-int main() {
-    stdio_init_all();
-    sleep_ms(2000); // Pausa para inicializar o monitor serial
+// Monta as tabelas dos alertas e reserva os canais de DMA do buzzer
+static void buzzer_seq_init(void) {
+    uint32_t sys_hz = clock_get_hz(clk_sys);
+    uint32_t div16 = (uint32_t)(DIVCLK * 16);
+    uint32_t period_ns = pwm_seq_period_ns(sys_hz, div16, PERIOD);
+    uint32_t beep = pwm_seq_periods(period_ns, BUZZER_BEEP_MS);
+    uint32_t n = pwm_seq_build_hold(buzzer_beep, BUZZER_BEEP_MAX, PWM_SEQ_CC(0, dc_values[0]), beep);
+    buzzer_beep_len = n + pwm_seq_build_hold(buzzer_beep + n, BUZZER_BEEP_MAX - n, PWM_SEQ_CC(0, dc_values[1]), beep);
 
-    // --- Matriz de LEDs WS2812B ---
-    ws2812b_t *ws = init_ws2812b(pio0, WS2812B_PIN);
+    n = pwm_seq_build_tone(buzzer_siren, BUZZER_SIREN_MAX, sys_hz, div16, BUZZER_SIREN_LOW_HZ, BUZZER_SIREN_MS);
+    buzzer_siren_len = n + pwm_seq_build_tone(buzzer_siren + n, BUZZER_SIREN_MAX - n, sys_hz, div16,
+                                              BUZZER_SIREN_HIGH_HZ, BUZZER_SIREN_MS);
+    buzzer_siren_level = pwm_seq_tone_top(sys_hz, div16, BUZZER_SIREN_HIGH_HZ) * 3 / 10;
 
-    // --- Botão BOOTSEL ---
-    gpio_init(BTN_BOOTSEL_PIN);
-    gpio_set_dir(BTN_BOOTSEL_PIN, GPIO_IN);
-    gpio_pull_up(BTN_BOOTSEL_PIN);
-    gpio_set_irq_enabled_with_callback(BTN_BOOTSEL_PIN, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
+    pwm_seq_init(&buzzer_seq, pwm_gpio_to_slice_num(BUZZER_PIN));
+}
 
-    // --- I2C dos Sensores ---
-    i2c_init(I2C_PORT_SHARED, 400 * 1000);
-    gpio_set_function(SDA_PIN_SHARED, GPIO_FUNC_I2C);
-    gpio_set_function(SCL_PIN_SHARED, GPIO_FUNC_I2C);
-    gpio_pull_up(SDA_PIN_SHARED);
-    gpio_pull_up(SCL_PIN_SHARED);
+// Troca o padrão do buzzer; nada a fazer se o alerta não mudou
+static void buzzer_set_alert(buzzer_alert_t alert) {
+    if (alert == buzzer_alert) return;
+    buzzer_alert = alert;
+
+    uint slice = pwm_gpio_to_slice_num(BUZZER_PIN);
+    pwm_seq_stop(&buzzer_seq);
+    pwm_set_wrap(slice, PERIOD);
+    if (alert == BUZZER_ALERT_DARK) {
+        pwm_seq_start(&buzzer_seq, PWM_SEQ_REG_CC, buzzer_beep, buzzer_beep_len, true);
+    } else if (alert == BUZZER_ALERT_COLOR) {
+        pwm_set_gpio_level(BUZZER_PIN, buzzer_siren_level);
+        pwm_seq_start(&buzzer_seq, PWM_SEQ_REG_TOP, buzzer_siren, buzzer_siren_len, true);
+    } else {
+        pwm_set_gpio_level(BUZZER_PIN, dc_values[1]);
+    }
+}
+
+// Atualiza LEDs e buzzer a partir de uma amostra (núcleo 1)
+static void apply_leds(const sensor_sample_t *sample) {
+    // Balanço de branco da calibração
+    uint32_t r = calib_apply_gain(sample->r, calib.gain_r);
+    uint32_t g = calib_apply_gain(sample->g, calib.gain_g);
+    uint32_t b = calib_apply_gain(sample->b, calib.gain_b);
+    uint16_t lux = sample->lux;
+
+    // 1. Normaliza os valores de cor (0-255) pelo maior canal e
+    // 2. aplica a intensidade proporcional à luminosidade (aritmética inteira)
+    color_rgb8_t final = color_process(r, g, b, lux, calib.max_lux);
+
+    // 3. e 4. O LED RGB e a matriz WS2812B chegam à cor aos poucos (fade_timer_cb)
+    fade_set_target(&led_fade, final);
+
+    // 5. Emite o alerta do buzzer, caso a luminosidade esteja muito baixa ou a cor seja de uma classe de alerta
+    color_class_result_t cls = color_classify(&color_class_cfg, r, g, b);
+    if (lux < 1)
+        buzzer_set_alert(BUZZER_ALERT_DARK);
+    else if (ALERT_CLASSES & COLOR_CLASS_BIT(cls.cls))
+        buzzer_set_alert(BUZZER_ALERT_COLOR);
+    else
+        buzzer_set_alert(BUZZER_ALERT_NONE);
+}
+
+// Interrupção do timer (núcleo 1): um passo da transição e as saídas
+static bool fade_timer_cb(repeating_timer_t *rt) {
+    if (!fade_step(&led_fade) && !fade_ws_pending)
+        return true;
+
+    PROF_BEGIN(t_fade);
+    // O nível do PWM segue a gamma (quadrado) para uma percepção de brilho mais linear
+    pwm_set_gpio_level(RED_PIN, fade_pwm_level(&led_fade, 0));
+    pwm_set_gpio_level(GREEN_PIN, fade_pwm_level(&led_fade, 1));
+    pwm_set_gpio_level(BLUE_PIN, fade_pwm_level(&led_fade, 2));
+
+    // Matriz com a tabela de gamma própria (0-255); ocupada, tenta no próximo passo
+    color_rgb8_t c = fade_value(&led_fade);
+    fade_ws_pending = ws2812b_draw_rgb(ws, ZERO_GLYPH,
+                                       color_ws2812b_level(c.r),
+                                       color_ws2812b_level(c.g),
+                                       color_ws2812b_level(c.b)) == WS2812B_PRESENT_BUSY;
+    PROF_END(STAGE_FADE, t_fade);
+    return true;
+}
+
+// Monta a tela uma vez: rótulos fixos e campos de até 5 dígitos (lux em
+// uint16_t; cores na escala da exposição antiga, até 11264)
+static void display_layout() {
+    ui_init(&ui, &ssd);
+    ui_add_label(&ui, "CEPEDI TIC37", 8, 6);
+    ui_add_label(&ui, "EMBARCATECH", 20, 16);
+    ui_add_label(&ui, "Lux", 4, 30);
+    ui_lux = ui_add_big_number(&ui, 5, 2, 40, 26); // 2x: legível de longe
+    ui_red = ui_add_number(&ui, "R:", 5, 4, 46);
+    ui_green = ui_add_number(&ui, "G:", 5, 64, 46);
+    ui_blue = ui_add_number(&ui, "B:", 5, 4, 56);
+}
+
+// --- Núcleo 1: saídas ---
+
+// Esporádica: aplica a amostra mais recente assim que o núcleo 0 publica
+static void leds_task_run(void *arg) {
+    sensor_sample_t sample;
+    if (!sample_ring_pop_latest(&sample_ring, &sample))
+        return;
+
+    prof_record(STAGE_SAMPLE_AGE, time_us_32() - sample.timestamp_us);
+
+    // Amostra em um quadro binário (tools/telemetry_decode.py no host)
+    PROF_BEGIN(t_telemetry);
+    telemetry_send_sample(&sample);
+    PROF_END(STAGE_TELEMETRY, t_telemetry);
+
+    PROF_BEGIN(t_leds);
+    apply_leds(&sample);
+    PROF_END(STAGE_LEDS, t_leds);
+
+    shown_sample = sample;
+    display_dirty = true;
+}
+
+// Tempos do boot desde o reset ('b' no monitor serial)
+static void boot_print() {
+    printf("boot:");
+    for (int m = 0; m < BOOT_MARK_COUNT; m++) {
+        uint32_t us = boot_mark_us(m);
+        if (us)
+            printf(" %s %lu.%lu ms", boot_mark_name(m), (unsigned long)(us / 1000), (unsigned long)(us % 1000 / 100));
+        else
+            printf(" %s -", boot_mark_name(m));
+    }
+    printf("%s\n", boot_in_order() ? "" : " (fora de ordem)");
+}
+
+// Periódica: redesenha o display só se chegou amostra nova desde a última vez
+static void display_task_run(void *arg) {
+    if (!display_dirty)
+        return;
+    display_dirty = false;
+
+    PROF_BEGIN(t_draw);
+    ui_set_number(&ui, ui_red, GY33_TO_1X11(shown_sample.r));
+    ui_set_number(&ui, ui_green, GY33_TO_1X11(shown_sample.g));
+    ui_set_number(&ui, ui_blue, GY33_TO_1X11(shown_sample.b));
+    ui_set_number(&ui, ui_lux, shown_sample.lux);
+    bool changed = ui_render(&ui);
+    PROF_END(STAGE_DISPLAY_DRAW, t_draw);
+
+    if (!changed)
+        return;
+    PROF_BEGIN(t_flush);
+    ssd1306_send_data(&ssd);
+    PROF_END(STAGE_DISPLAY_FLUSH, t_flush);
+
+    if (!boot_mark_us(BOOT_FIRST_FRAME)) {
+        boot_mark(BOOT_FIRST_FRAME);
+        boot_print(); // Sem monitor aberto se perde; 'b' imprime de novo
+    }
+}
+
+// Ganhos que igualam os três canais ao maior deles numa superfície branca
+static void calib_white_balance(const sensor_sample_t *white) {
+    uint32_t max = white->r > white->g ? white->r : white->g;
+    max = max > white->b ? max : white->b;
+    if (!white->r || !white->g || !white->b)
+        return; // Sem leitura em algum canal: nada a igualar
+    uint32_t gr = ((uint32_t)max << 8) / white->r;
+    uint32_t gg = ((uint32_t)max << 8) / white->g;
+    uint32_t gb = ((uint32_t)max << 8) / white->b;
+    calib.gain_r = gr > 0xFFFF ? 0xFFFF : (uint16_t)gr;
+    calib.gain_g = gg > 0xFFFF ? 0xFFFF : (uint16_t)gg;
+    calib.gain_b = gb > 0xFFFF ? 0xFFFF : (uint16_t)gb;
+    calib_dirty = true;
+}
+
+// Comandos pelo stdio USB, sem bloquear:
+//   p  imprime as estatísticas de tempo e das tarefas; r  zera
+//   w  balanço de branco com a amostra atual; m  lux atual como máximo
+//   c  mostra a calibração; d  envia o histórico da flash pela telemetria
+//   l  estatísticas do histórico; b  tempos do boot
+//   f  liga/desliga os filtros (traços brutos pela telemetria)
+static void console_task_run(void *arg) {
+    int c = getchar_timeout_us(0);
+    if (c == 'p') {
+        prof_dump();
+        sched_dump(&sensors_sched);
+        sched_dump(&outputs_sched);
+    } else if (c == 'r') {
+        prof_reset();
+        sched_reset_stats(&sensors_sched);
+        sched_reset_stats(&outputs_sched);
+    } else if (c == 'w') {
+        calib_white_balance(&shown_sample);
+    } else if (c == 'm') {
+        calib.max_lux = shown_sample.lux ? shown_sample.lux : 1;
+        calib_dirty = true;
+    } else if (c == 'c') {
+        const calib_status_t *st = calib_status();
+        printf("calib: ganhos %u/%u/%u, max_lux %u, exposição %u; página %d, seq %lu, %lu gravações, %lu apagamentos\n",
+               calib.gain_r, calib.gain_g, calib.gain_b, calib.max_lux, calib.gy33_step,
+               st->slot, (unsigned long)st->seq, (unsigned long)st->writes, (unsigned long)st->erases);
+    } else if (c == 'd') {
+        flash_log_cursor_init(&log_cursor);
+        log_dumping = true;
+        log_block_num = 0;
+        log_chunks = 0;
+    } else if (c == 'l') {
+        const flash_log_stats_t *st = flash_log_stats();
+        printf("log: boot %u, %lu amostras, %lu bytes codificados, %lu páginas, %lu setores apagados, %lu blocos perdidos\n",
+               st->boot, (unsigned long)st->samples, (unsigned long)st->payload_bytes,
+               (unsigned long)st->pages_written, (unsigned long)st->sectors_erased,
+               (unsigned long)st->pages_dropped);
+    } else if (c == 'b') {
+        boot_print();
+    } else if (c == 'f') {
+        filter_bypass = !filter_bypass; // Para gravar traços brutos pela telemetria
+        printf("filtro %s\n", filter_bypass ? "desligado" : "ligado");
+    }
+}
+
+// Grava a calibração quando o console a muda ou quando a exposição
+// automática do GY-33 se firma num passo diferente do salvo. A gravação
+// para os dois núcleos por ~1 ms (~50 ms a cada 16, quando apaga o setor).
+static void calib_task_run(void *arg) {
+    uint64_t now = time_us_64();
+    uint8_t step = gy33_get_exposure_step();
+    if (step != calib_step_seen) {
+        calib_step_seen = step;
+        calib_step_since_us = now;
+    } else if (step != calib.gy33_step && now - calib_step_since_us >= CALIB_STEP_STABLE_US) {
+        calib.gy33_step = step;
+        calib_dirty = true;
+    }
+
+    if (calib_dirty) {
+        calib_dirty = false;
+        if (!calib_save(&calib))
+            printf("calib: falha ao gravar na flash\n");
+    }
+}
+
+// Envia o histórico em trechos enquanto houver espaço na fila de
+// telemetria, sem descartar quadros; continua na próxima rodada
+static void log_dump_step() {
+    while (telemetry_free() >= TELEMETRY_MAX_ENCODED) {
+        if (log_chunk == log_chunks) {
+            if (!flash_log_cursor_next(&log_cursor, log_block)) {
+                uint8_t payload[2] = {(uint8_t)log_block_num, (uint8_t)(log_block_num >> 8)};
+                telemetry_send(TELEMETRY_TYPE_LOG_END, time_us_32(), payload, sizeof(payload));
+                log_dumping = false;
+                return;
+            }
+            // Só os trechos com dados; o resto do bloco é 0xFF
+            uint32_t used = FLASH_LOG_HEADER_SIZE + (log_block[2] | (log_block[3] << 8)) + FLASH_LOG_CRC_SIZE;
+            log_chunks = (uint8_t)((used + TELEMETRY_LOG_CHUNK_SIZE - 1) / TELEMETRY_LOG_CHUNK_SIZE);
+            log_chunk = 0;
+            log_block_num++;
+        }
+        telemetry_send_log_chunk(time_us_32(), log_block_num - 1, log_chunk,
+                                 log_block + log_chunk * TELEMETRY_LOG_CHUNK_SIZE);
+        log_chunk++;
+    }
+}
+
+// Registra a amostra exibida a cada LOG_INTERVAL_MS, faz no máximo uma
+// operação de flash pendente e avança o despejo
+static void log_task_run(void *arg) {
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    if (shown_sample.timestamp_us && now_ms - log_last_ms >= LOG_INTERVAL_MS) {
+        flash_log_sample_t s = {
+            now_ms, shown_sample.r, shown_sample.g, shown_sample.b, shown_sample.c, shown_sample.lux,
+        };
+        flash_log_append(&s);
+        log_last_ms = now_ms;
+    }
+    flash_log_service();
+    if (log_dumping)
+        log_dump_step();
+}
+
+// Inicializa os periféricos de saída e as tarefas do núcleo 1 (a interrupção
+// de DMA da matriz fica no núcleo que chama esta função).
+static void outputs_init() {
+    boot_mark(BOOT_OUTPUTS_STARTED);
+
+    // --- Matriz de LEDs WS2812B ---
+    ws = init_ws2812b(pio0, WS2812B_PIN);
 
     // --- Display OLED SSD1306 ---
     i2c_init(I2C_PORT_DISP, 400 * 1000);
@@ -89,95 +605,190 @@ int main() {
     gpio_set_function(I2C_SCL_DISP, GPIO_FUNC_I2C);                    
     gpio_pull_up(I2C_SDA_DISP);                                        
     gpio_pull_up(I2C_SCL_DISP);                                        
-    ssd1306_t ssd;                                                     
     ssd1306_init(&ssd, WIDTH, HEIGHT, false, DISPLAY_ADDR, I2C_PORT_DISP); 
     ssd1306_config(&ssd);
-    ssd1306_fill(&ssd, false);                                              
+    display_layout();
+    ui_render(&ui); // Rótulos já na primeira tela, campos vazios até a primeira amostra
     ssd1306_send_data(&ssd);   
+    boot_mark(BOOT_DISPLAY_READY);
+
+    // --- Histórico ---
+    if (!flash_log_init()) // Acha o fim do log deixado pelo boot anterior
+        printf("log: desligado, a imagem do firmware invade a área do histórico\n");
 
     // --- Buzzer ---
     init_buzzer(BUZZER_PIN, DIVCLK, PERIOD);
+    buzzer_seq_init();
+
+    // --- LED RGB com PWM ---
+    init_pwm_pin(RED_PIN);
+    init_pwm_pin(GREEN_PIN);
+    init_pwm_pin(BLUE_PIN);
+
+    // --- Transições: alarme de hardware livre, interrupção neste núcleo ---
+    fade_init(&led_fade);
+    alarm_pool_t *fade_pool = alarm_pool_create_with_unused_hardware_alarm(1);
+    alarm_pool_add_repeating_timer_us(fade_pool, -FADE_TICK_US, fade_timer_cb, NULL, &fade_timer);
+
+    sched_add(&outputs_sched, &leds_task);
+    sched_add(&outputs_sched, &display_task);
+    sched_add(&outputs_sched, &console_task);
+    sched_add(&outputs_sched, &calib_task);
+    sched_add(&outputs_sched, &log_task);
+}
+
+static void core1_entry() {
+    outputs_init();
+    sched_run(&outputs_sched);
+}
+
+// --- Núcleo 0: sensores ---
+
+// Liga ou desliga o filtro conforme o pedido do console; ao religar os
+// filtros recomeçam do valor atual em vez de partir do estado antigo
+static bool sensor_filter_enabled() {
+    bool active = !filter_bypass;
+    if (active && !sensor_filter_active)
+        filter_bank_reset(&sensor_filter);
+    sensor_filter_active = active;
+    return active;
+}
+
+// Enfileira a leitura de cor quando uma integração termina e publica as
+// amostras novas. As transferências correm pela interrupção do I2C.
+static void color_task_run(void *arg) {
+    gy33_request_color();
+
+    // Amostra válida só com cor e lux: antes da primeira leitura do BH1750 o
+    // lux seria 0 e dispararia o alerta de escuro no boot. Até lá o BH1750 é
+    // consultado no ritmo desta tarefa, e a cor fica guardada no driver.
+    if (!sensor_lux_valid) {
+        lux_task_run(NULL);
+        if (!sensor_lux_valid)
+            return;
+    }
+
+    // Publica apenas amostras de cor novas (integração ainda não vista)
+    sensor_sample_t *sample = &sensor_sample;
+    uint32_t r, g, b, c;
+    if (!gy33_poll_color(&r, &g, &b, &c))
+        return;
+
+    if (sensor_filter_enabled()) {
+        r = filter_update(&sensor_filter.r, r);
+        g = filter_update(&sensor_filter.g, g);
+        b = filter_update(&sensor_filter.b, b);
+        c = filter_update(&sensor_filter.c, c);
+    }
+    sample->r = r;
+    sample->g = g;
+    sample->b = b;
+    sample->c = c;
+    sample->lux = sensor_lux;
+    sample->timestamp_us = (uint32_t)to_us_since_boot(gy33_sample_time());
+
+    // Publica para o núcleo 1 e o acorda do WFE
+    sample_ring_push(&sample_ring, sample);
+    sched_trigger(&leds_task);
+    sample->seq++;
+    boot_mark(BOOT_FIRST_SAMPLE);
+}
+
+static void lux_task_run(void *arg) {
+    uint16_t lux;
+    if (!bh1750_poll(&lux)) // Só lê o barramento quando há uma nova conversão
+        return;
+    bool filt = sensor_filter_enabled();
+    if (filt && lux == 0)
+        filter_reset(&sensor_filter.lux); // Escuro vale na hora; a próxima leitura recomeça dela mesma
+    else if (filt)
+        lux = filter_update(&sensor_filter.lux, lux);
+    sensor_lux = lux;
+    sensor_lux_valid = true;
+}
+
+static void telemetry_task_run(void *arg) {
+    telemetry_drain(telemetry_usb_sink); // Núcleo 0 também roda a tarefa USB
+}
+
+static void sensors_init() {
+    // --- I2C dos Sensores ---
+    i2c_init(I2C_PORT_SHARED, 400 * 1000);
+    gpio_set_function(SDA_PIN_SHARED, GPIO_FUNC_I2C);
+    gpio_set_function(SCL_PIN_SHARED, GPIO_FUNC_I2C);
+    gpio_pull_up(SDA_PIN_SHARED);
+    gpio_pull_up(SCL_PIN_SHARED);
+    i2c_async_init(I2C_PORT_SHARED); // Transações dos sensores pela interrupção do I2C
+
+    // --- Filtros ---
+    static const filter_config_t color_filter = {
+        .median = true, .ema_shift = COLOR_FILTER_EMA_SHIFT, .band = COLOR_FILTER_BAND,
+        .band_shift = COLOR_FILTER_BAND_SHIFT,
+    };
+    static const filter_config_t lux_filter = {
+        .median = false, .ema_shift = LUX_FILTER_EMA_SHIFT, .band = LUX_FILTER_BAND,
+    };
+    filter_bank_init(&sensor_filter, &color_filter, &lux_filter);
+    sensor_filter_active = true;
 
     // --- Sensores ---
     bh1750_power_on();
+    // Primeira leitura em baixa resolução (24 ms); o bh1750_poll() que a recebe
+    // passa o sensor para o modo contínuo, e nenhuma leitura bloqueia
+    bh1750_start();
     printf("BH1750 inicializado.\n");
     gy33_init();
     printf("GY-33 inicializado.\n");
 
-    // --- LED RGB com PWM ---
-    init_pwm_pin(RED_PIN);
-    init_pwm_pin(GREEN_PIN);
-    init_pwm_pin(BLUE_PIN);
+    sched_add(&sensors_sched, &color_task);
+    sched_add(&sensors_sched, &lux_task);
+    sched_add(&sensors_sched, &telemetry_task);
+    boot_mark(BOOT_SENSORS_STARTED);
+}
 
-    // --- Buffers para strings do display ---
-    char str_lux[10];
-    char str_red[5];
-    char str_green[5];
-    char str_blue[5];
-
-    // --- Loop Principal ---
-    while (1) {
-        // Leitura dos sensores
-        uint16_t r, g, b, c;
-        gy33_read_color(&r, &g, &b, &c);
-        uint16_t lux = bh1750_read_measurement();
-
-        printf("Cor: R=%d, G=%d, B=%d, C=%d | Luminosidade: %d lux\n", r, g, b, c, lux);
-
-        // --- Lógica de Controle dos LEDs ---
-        
-        // 1. Normaliza os valores de cor (0-255)
-        // Encontra o valor máximo entre r, g, b para manter a proporção da cor
-        uint16_t max_color = (r > g) ? r : g;
-        max_color = (max_color > b) ? max_color : b;
-        
-        uint8_t r_norm = 0, g_norm = 0, b_norm = 0;
-        if (max_color > 0) {
-            r_norm = (uint8_t)((r * 255.0f) / max_color);
-            g_norm = (uint8_t)((g * 255.0f) / max_color);
-            b_norm = (uint8_t)((b * 255.0f) / max_color);
-        }
+// Carrega a calibração da flash e a exposição inicial do GY-33. Roda antes
+// de lançar o núcleo 1, que passa a ser o dono de calib.
+static void calib_restore() {
+    if (calib_load(&calib))
+        printf("Calibração restaurada (seq %lu).\n", (unsigned long)calib_status()->seq);
+    else
+        printf("Sem calibração na flash, usando a padrão.\n");
+    if (calib.gy33_step != CALIB_STEP_UNSET)
+        gy33_preset_exposure_step(calib.gy33_step);
+    calib_step_seen = gy33_get_exposure_step();
+}
 
-        // 2. Calcula a intensidade baseada na luminosidade (0.0 a 1.0)
-        float intensity = (lux >= MAX_LUX) ? 1.0f : (float)lux / MAX_LUX;
-        
-        // 3. Aplica a intensidade aos valores de cor normalizados
-        uint8_t final_r = (uint8_t)(r_norm * intensity);
-        uint8_t final_g = (uint8_t)(g_norm * intensity);
-        uint8_t final_b = (uint8_t)(b_norm * intensity);
-
-        // 4. Atualiza o LED RGB com PWM
-        // O nível do PWM é ao quadrado para uma percepção de brilho mais linear (correção de gamma)
-        pwm_set_gpio_level(RED_PIN, final_r * final_r);
-        pwm_set_gpio_level(GREEN_PIN, final_g * final_g);
-        pwm_set_gpio_level(BLUE_PIN, final_b * final_b);
-
-        // 5. Atualiza a matriz de LEDs WS2812B com a nova função
-        // Passa os valores de cor e intensidade diretamente
-        ws2812b_draw_rgb(ws, ZERO_GLYPH, final_r, final_g, final_b);
-
-        // 6. Emite o alerta do buzzer, caso a luminosidade esteja muito baixa ou a cor vermelha seja identificada em maior parte
-        if(lux < 1 || (r > g && r > b))
-            pwm_set_gpio_level(BUZZER_PIN, dc_values[0]);
-        
-        else
-            pwm_set_gpio_level(BUZZER_PIN, dc_values[1]);
-        
-        // --- Atualização do Display ---
-        sprintf(str_red, "R:%d", r);
-        sprintf(str_green, "G:%d", g);
-        sprintf(str_blue, "B:%d", b);
-        sprintf(str_lux, "Lux:%d", lux);
-
-        ssd1306_fill(&ssd, false);
-        ssd1306_draw_string(&ssd, "CEPEDI TIC37", 8, 6);
-        ssd1306_draw_string(&ssd, "EMBARCATECH", 20, 16);
-        ssd1306_draw_string(&ssd, str_red, 14, 30);
-        ssd1306_draw_string(&ssd, str_green, 14, 40);
-        ssd1306_draw_string(&ssd, str_blue, 14, 50);
-        ssd1306_draw_string(&ssd, str_lux, 60, 40);
-        ssd1306_send_data(&ssd);
-        sleep_ms(250); // Reduz o delay para uma resposta mais rápida
-    }
+// Sequência de boot do núcleo 0. Não espera o USB: os sensores ligam antes
+// de lançar o núcleo 1, e as primeiras conversões correm enquanto ele
+// inicia matriz, display e histórico. O simulador chama esta mesma função e
+// depois outputs_init() no lugar do núcleo 1 (sim/boot_check.c confere a
+// ordem e os tempos).
+static void boot_core0() {
+    sample_ring_init(&sample_ring);
+    telemetry_init();
+    stdio_set_driver_enabled(&stdio_usb, false); // printf pela telemetria
+    stdio_set_driver_enabled(&console_stdio, true);
+    prof_init(stage_names, STAGE_COUNT);
+    sched_init(&sensors_sched);
+    sched_init(&outputs_sched);
+    calib_restore(); // Exposição do GY-33 antes da primeira integração
+    sensors_init();
+    flash_safe_execute_core_init(); // O núcleo 1 grava a calibração com este núcleo pausado
+    multicore_launch_core1(core1_entry);
+
+    // --- Botão BOOTSEL ---
+    gpio_init(BTN_BOOTSEL_PIN);
+    gpio_set_dir(BTN_BOOTSEL_PIN, GPIO_IN);
+    gpio_pull_up(BTN_BOOTSEL_PIN);
+    gpio_set_irq_enabled_with_callback(BTN_BOOTSEL_PIN, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
+}
+
+// --- Função Principal (núcleo 0: sensores) ---
+int main() {
+    stdio_init_all(); // Sem esperar o monitor serial: 'b' mostra os tempos do boot
+    boot_core0();
+
+    // --- Loop de Aquisição ---
+    sched_run(&sensors_sched);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,48 @@
+#include "boot.h"
+
+static volatile uint32_t boot_marks[BOOT_MARK_COUNT];
+
+static const char *const boot_mark_names[BOOT_MARK_COUNT] = {
+    "sensores", "saidas", "display", "primeira_amostra", "primeiro_quadro",
+};
+
+#define BOOT_BIT(m) (1u << (m))
+
+// Marcos que precisam ter acontecido antes de cada um
+static const uint8_t boot_mark_after[BOOT_MARK_COUNT] = {
+    [BOOT_SENSORS_STARTED] = 0,
+    [BOOT_OUTPUTS_STARTED] = BOOT_BIT(BOOT_SENSORS_STARTED),
+    [BOOT_DISPLAY_READY] = BOOT_BIT(BOOT_OUTPUTS_STARTED),
+    [BOOT_FIRST_SAMPLE] = BOOT_BIT(BOOT_SENSORS_STARTED),
+    [BOOT_FIRST_FRAME] = BOOT_BIT(BOOT_DISPLAY_READY) | BOOT_BIT(BOOT_FIRST_SAMPLE),
+};
+
+void boot_mark(boot_mark_t mark)
+{
+    if (boot_marks[mark]) return;
+    uint32_t now = time_us_32();
+    boot_marks[mark] = now ? now : 1; // 0 é "ainda não"
+}
+
+uint32_t boot_mark_us(boot_mark_t mark)
+{
+    return boot_marks[mark];
+}
+
+const char *boot_mark_name(boot_mark_t mark)
+{
+    return boot_mark_names[mark];
+}
+
+bool boot_in_order(void)
+{
+    for (int m = 0; m < BOOT_MARK_COUNT; m++) {
+        if (!boot_marks[m])
+            return false;
+        for (int before = 0; before < BOOT_MARK_COUNT; before++) {
+            if ((boot_mark_after[m] & BOOT_BIT(before)) && boot_marks[m] < boot_marks[before])
+                return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,31 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "pico/stdlib.h"
+
+// Marcos do boot em us desde o reset (time_us_32). Cada marco vale na
+// primeira vez em que é marcado e é escrito por um só núcleo, numa escrita
+// de 32 bits, então os dois núcleos marcam sem trava.
+//
+// A ordem esperada (boot_in_order): sensores ligados antes do núcleo 1
+// iniciar as saídas, para a primeira integração correr junto com o display;
+// o primeiro quadro com dados depois da primeira amostra válida (cor e lux)
+// e da tela inicial. Display e primeira amostra não dependem um do outro.
+
+typedef enum {
+    BOOT_SENSORS_STARTED,   // Sensores ligados, primeira conversão correndo
+    BOOT_OUTPUTS_STARTED,   // Núcleo 1 começou a iniciar as saídas
+    BOOT_DISPLAY_READY,     // Tela com os rótulos enviada
+    BOOT_FIRST_SAMPLE,      // Primeira amostra válida publicada
+    BOOT_FIRST_FRAME,       // Primeira amostra desenhada no display
+    BOOT_MARK_COUNT
+} boot_mark_t;
+
+void boot_mark(boot_mark_t mark);
+uint32_t boot_mark_us(boot_mark_t mark); // 0 enquanto o marco não aconteceu
+const char *boot_mark_name(boot_mark_t mark);
+
+// Todos os marcos aconteceram, cada um depois dos que ele exige
+bool boot_in_order(void);
+
+#endif // BOOT_H
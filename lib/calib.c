@@ -0,0 +1,138 @@
+#include "calib.h"
+#include <stddef.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+
+#define CALIB_FLASH_TIMEOUT_MS 100 // Espera pelo outro núcleo em flash_safe_execute
+
+_Static_assert(sizeof(calib_record_t) <= CALIB_SLOT_SIZE, "o registro precisa caber numa página");
+_Static_assert(sizeof(calib_record_t) == 28, "registro sem preenchimento: o CRC cobre todos os bytes");
+
+static calib_status_t calib_state = {-1, 0, 0, 0};
+static calib_record_t calib_current;           // Cópia do registro em vigor
+static uint8_t calib_page[CALIB_SLOT_SIZE];    // Página montada para programar
+
+static inline const uint8_t *calib_slot_ptr(int slot) {
+    return (const uint8_t *)(XIP_BASE + CALIB_FLASH_OFFSET) + slot * CALIB_SLOT_SIZE;
+}
+
+// CRC-32 (IEEE 802.3, refletido) bit a bit: só roda no boot e nas gravações
+uint32_t calib_crc32(const void *data, uint32_t len) {
+    const uint8_t *p = data;
+    uint32_t crc = 0xFFFFFFFFu;
+    while (len--) {
+        crc ^= *p++;
+        for (uint8_t i = 0; i < 8; i++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+void calib_defaults(calib_data_t *data) {
+    memset(data, 0, sizeof(*data));
+    data->gain_r = data->gain_g = data->gain_b = CALIB_GAIN_ONE;
+    data->max_lux = CALIB_DEFAULT_MAX_LUX;
+    data->gy33_step = CALIB_STEP_UNSET;
+}
+
+bool calib_record_valid(const calib_record_t *rec) {
+    return rec->magic == CALIB_MAGIC &&
+           rec->version == CALIB_VERSION &&
+           rec->size == sizeof(calib_data_t) &&
+           rec->crc == calib_crc32(rec, offsetof(calib_record_t, crc));
+}
+
+static bool calib_slot_erased(int slot) {
+    const uint8_t *p = calib_slot_ptr(slot);
+    for (uint32_t i = 0; i < CALIB_SLOT_SIZE; i++)
+        if (p[i] != 0xFF)
+            return false;
+    return true;
+}
+
+// Procura o registro válido mais novo. Retorna false (e os valores padrão)
+// se o setor estiver vazio ou nenhum registro for válido, por exemplo após
+// uma mudança de versão.
+bool calib_load(calib_data_t *data) {
+    calib_state.slot = -1;
+    calib_state.seq = 0;
+    for (int slot = 0; slot < CALIB_SLOTS; slot++) {
+        calib_record_t rec;
+        memcpy(&rec, calib_slot_ptr(slot), sizeof(rec)); // A flash pode estar desalinhada para o struct
+        if (!calib_record_valid(&rec))
+            continue;
+        if (calib_state.slot < 0 || (int32_t)(rec.seq - calib_state.seq) > 0) {
+            calib_state.slot = (int8_t)slot;
+            calib_state.seq = rec.seq;
+            calib_current = rec;
+        }
+    }
+
+    if (calib_state.slot < 0) {
+        calib_defaults(data);
+        return false;
+    }
+    *data = calib_current.data;
+    return true;
+}
+
+typedef struct {
+    uint32_t offset;
+    bool erase;
+} calib_flash_op_t;
+
+// Roda com as interrupções desligadas e o outro núcleo parado fora da flash
+static void calib_flash_op(void *param) {
+    const calib_flash_op_t *op = param;
+    if (op->erase)
+        flash_range_erase(CALIB_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(op->offset, calib_page, CALIB_SLOT_SIZE);
+}
+
+// Grava um registro novo na próxima página apagada depois do atual; sem
+// nenhuma, apaga o setor e recomeça da página 0. Bloqueia os dois núcleos
+// durante a operação (~1 ms programando, ~50 ms quando apaga).
+bool calib_save(const calib_data_t *data) {
+    if (calib_state.slot >= 0 && !memcmp(&calib_current.data, data, sizeof(*data)))
+        return true;
+
+    calib_record_t rec = {
+        .magic = CALIB_MAGIC,
+        .version = CALIB_VERSION,
+        .size = sizeof(calib_data_t),
+        .seq = calib_state.slot >= 0 ? calib_state.seq + 1 : 1,
+        .data = *data,
+    };
+    rec.crc = calib_crc32(&rec, offsetof(calib_record_t, crc));
+
+    // Páginas programadas pela metade (queda de energia) também são puladas
+    int slot = calib_state.slot + 1;
+    while (slot < CALIB_SLOTS && !calib_slot_erased(slot))
+        slot++;
+    calib_flash_op_t op = {.erase = slot >= CALIB_SLOTS};
+    if (op.erase)
+        slot = 0;
+    op.offset = CALIB_FLASH_OFFSET + slot * CALIB_SLOT_SIZE;
+
+    memset(calib_page, 0xFF, sizeof(calib_page));
+    memcpy(calib_page, &rec, sizeof(rec));
+    if (flash_safe_execute(calib_flash_op, &op, CALIB_FLASH_TIMEOUT_MS) != PICO_OK)
+        return false;
+
+    calib_state.writes++;
+    if (op.erase)
+        calib_state.erases++;
+
+    // Confere o que ficou na flash antes de adotar o registro
+    if (memcmp(calib_slot_ptr(slot), &rec, sizeof(rec)))
+        return false;
+    calib_current = rec;
+    calib_state.slot = (int8_t)slot;
+    calib_state.seq = rec.seq;
+    return true;
+}
+
+const calib_status_t *calib_status(void) {
+    return &calib_state;
+}
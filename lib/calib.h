@@ -0,0 +1,66 @@
+#ifndef CALIB_H
+#define CALIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/flash.h"
+#include "color.h"
+
+// Calibração persistida no último setor da flash, para que um boot a quente
+// já saia calibrado na primeira amostra.
+//
+// O setor é dividido em 16 páginas de 256 bytes; cada gravação programa a
+// próxima página apagada com um registro novo (número de sequência maior),
+// e o setor só é apagado quando todas estão usadas. Na leitura vale o
+// registro válido (magic, versão, tamanho e CRC-32) de maior sequência, então
+// uma gravação interrompida no meio deixa o registro anterior em vigor.
+// Gravar um conteúdo igual ao atual não toca na flash.
+
+#define CALIB_MAGIC 0x42494C43u // "CLIB"
+#define CALIB_VERSION 1
+#define CALIB_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+#define CALIB_SLOT_SIZE FLASH_PAGE_SIZE
+#define CALIB_SLOTS ((int)(FLASH_SECTOR_SIZE / CALIB_SLOT_SIZE))
+
+#define CALIB_GAIN_ONE 256
+#define CALIB_DEFAULT_MAX_LUX 1000 // Intensidade máxima dos LEDs a partir daqui
+#define CALIB_STEP_UNSET 0xFF      // Sem exposição salva: o driver usa a sua padrão
+
+typedef struct {
+    uint16_t gain_r, gain_g, gain_b; // Balanço de branco em Q8 (256 = 1,0)
+    uint16_t max_lux;                // Luminosidade de intensidade máxima
+    uint8_t gy33_step;               // Última exposição estável do GY-33
+    uint8_t reserved[3];
+} calib_data_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;    // sizeof(calib_data_t)
+    uint32_t seq;
+    calib_data_t data;
+    uint32_t crc;     // CRC-32 de todos os campos anteriores
+} calib_record_t;
+
+// Estado da última leitura/gravação, para diagnóstico
+typedef struct {
+    int8_t slot;      // Página do registro em vigor (-1 = nenhum)
+    uint32_t seq;
+    uint32_t writes;  // Gravações desde o boot
+    uint32_t erases;  // Apagamentos desde o boot
+} calib_status_t;
+
+// Aplica um ganho Q8 do balanço de branco, saturando em COLOR_CHANNEL_MAX
+static inline uint32_t calib_apply_gain(uint32_t v, uint16_t gain_q8) {
+    return color_apply_gain(v, gain_q8);
+}
+
+void calib_defaults(calib_data_t *data);
+bool calib_load(calib_data_t *data);
+bool calib_save(const calib_data_t *data);
+const calib_status_t *calib_status(void);
+
+bool calib_record_valid(const calib_record_t *rec);
+uint32_t calib_crc32(const void *data, uint32_t len);
+
+#endif // CALIB_H
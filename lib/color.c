@@ -0,0 +1,45 @@
+#include "color.h"
+
+// Mesma curva usada antes no loop principal (final * final)
+#define COLOR_GAMMA_PWM(i)     ((uint16_t)((i) * (i)))
+#define COLOR_GAMMA_WS2812B(i) ((uint8_t)(((i) * (i) + 255) >> 8))
+
+const uint16_t color_gamma_pwm[256] = { COLOR_T256(COLOR_GAMMA_PWM) };
+const uint8_t color_gamma_ws2812b[256] = { COLOR_T256(COLOR_GAMMA_WS2812B) };
+
+// Intensidade em Q16 (0 a 65536) a partir da luminosidade
+uint32_t color_intensity_q16(uint16_t lux, uint16_t max_lux) {
+    if (lux >= max_lux)
+        return COLOR_INTENSITY_ONE;
+    return ((uint32_t)lux << 16) / max_lux;
+}
+
+// Normaliza os canais para 0-255 mantendo a proporção (maior canal = 255).
+// Canais de até COLOR_CHANNEL_MAX (os do GY-33 vão até GY33_COUNTS_MAX, 23
+// bits). As divisões inteiras de 32 bits vão para o divisor de hardware do
+// SIO (pico_divider do SDK), ~8 ciclos cada, em vez da divisão float em
+// software.
+color_rgb8_t color_normalize(uint32_t r, uint32_t g, uint32_t b) {
+    color_rgb8_t out = {0, 0, 0};
+    uint32_t max_color = (r > g) ? r : g;
+    max_color = (max_color > b) ? max_color : b;
+
+    if (max_color > 0) {
+        out.r = (r * 255) / max_color;
+        out.g = (g * 255) / max_color;
+        out.b = (b * 255) / max_color;
+    }
+    return out;
+}
+
+color_rgb8_t color_scale(color_rgb8_t c, uint32_t intensity_q16) {
+    color_rgb8_t out;
+    out.r = (c.r * intensity_q16) >> 16;
+    out.g = (c.g * intensity_q16) >> 16;
+    out.b = (c.b * intensity_q16) >> 16;
+    return out;
+}
+
+color_rgb8_t color_process(uint32_t r, uint32_t g, uint32_t b, uint16_t lux, uint16_t max_lux) {
+    return color_scale(color_normalize(r, g, b), color_intensity_q16(lux, max_lux));
+}
@@ -0,0 +1,50 @@
+#ifndef COLOR_H
+#define COLOR_H
+
+#include <stdint.h>
+
+// Pipeline de cor em inteiros: normalização pelo maior canal, escala pela
+// luminosidade e correção de gamma por tabela. O Cortex-M0+ não tem FPU,
+// então nada aqui usa float.
+
+#define COLOR_INTENSITY_ONE 65536 // Intensidade máxima em Q16 (1.0)
+#define COLOR_CHANNEL_MAX 0xFFFFFFu // Canais de até 24 bits: canal * 255 cabe em 32 bits
+
+// Expansão de tabelas em tempo de compilação: F(i) é avaliado para i = 0..N-1
+#define COLOR_T4(F, i)   F(i), F((i) + 1), F((i) + 2), F((i) + 3)
+#define COLOR_T16(F, i)  COLOR_T4(F, i), COLOR_T4(F, (i) + 4), COLOR_T4(F, (i) + 8), COLOR_T4(F, (i) + 12)
+#define COLOR_T64(F, i)  COLOR_T16(F, i), COLOR_T16(F, (i) + 16), COLOR_T16(F, (i) + 32), COLOR_T16(F, (i) + 48)
+#define COLOR_T256(F)    COLOR_T64(F, 0), COLOR_T64(F, 64), COLOR_T64(F, 128), COLOR_T64(F, 192)
+
+typedef struct {
+    uint8_t r, g, b;
+} color_rgb8_t;
+
+// Tabelas de 256 entradas geradas em tempo de compilação
+extern const uint16_t color_gamma_pwm[256];    // v^2, nível direto para pwm_set_gpio_level (wrap 65535)
+extern const uint8_t color_gamma_ws2812b[256]; // v^2 / 256 arredondado para cima, 0-255
+
+uint32_t color_intensity_q16(uint16_t lux, uint16_t max_lux);
+color_rgb8_t color_normalize(uint32_t r, uint32_t g, uint32_t b);
+color_rgb8_t color_scale(color_rgb8_t c, uint32_t intensity_q16);
+color_rgb8_t color_process(uint32_t r, uint32_t g, uint32_t b, uint16_t lux, uint16_t max_lux);
+
+// Aplica um ganho Q8 (256 = 1,0) saturando em COLOR_CHANNEL_MAX. Separa os
+// 8 bits de baixo para não precisar do produto de 64 bits, que o M0+ faz em
+// software: (v >> 8) * ganho cabe em 32 bits com v de até 24 bits.
+static inline uint32_t color_apply_gain(uint32_t v, uint16_t gain_q8) {
+    if (v > COLOR_CHANNEL_MAX)
+        v = COLOR_CHANNEL_MAX;
+    uint32_t x = (v >> 8) * gain_q8 + (((v & 0xFF) * gain_q8) >> 8);
+    return x > COLOR_CHANNEL_MAX ? COLOR_CHANNEL_MAX : x;
+}
+
+static inline uint16_t color_pwm_level(uint8_t v) {
+    return color_gamma_pwm[v];
+}
+
+static inline uint8_t color_ws2812b_level(uint8_t v) {
+    return color_gamma_ws2812b[v];
+}
+
+#endif // COLOR_H
@@ -0,0 +1,92 @@
+#include "color_class.h"
+#include "color.h"
+
+// Recíproco de 8 bits em Q16, arredondado e saturado em 65535 (n = 1):
+// (x * color_recip8[n] + 128) >> 8 erra 256 * x / n por menos de 1 unidade,
+// fica em 0..255 para 0 <= x < n e dá 256 para x = n
+#define COLOR_RECIP8(i) ((uint16_t)((i) > 1 ? (65536u + (i) / 2) / (i) : (i) ? 65535u : 0))
+
+const uint16_t color_recip8[256] = { COLOR_T256(COLOR_RECIP8) };
+
+// Tabela matiz -> classe: cada entrada testa as faixas de COLOR_CLASS_HUES
+// em ordem, como uma cadeia de ternários avaliada pelo compilador
+#define COLOR_HUE_IN(h, lo, hi) \
+    ((lo) <= (hi) ? ((h) >= (lo) && (h) < (hi)) : ((h) >= (lo) || (h) < (hi)))
+#define COLOR_HUE_TEST(h, id, name, lo, hi) COLOR_HUE_IN(h, lo, hi) ? (id) :
+#define COLOR_HUE_CLASS(i) \
+    ((uint8_t)(COLOR_CLASS_HUES(COLOR_HUE_TEST, (i) << COLOR_HUE_LUT_SHIFT) COLOR_CLASS_NEUTRAL))
+
+const uint8_t color_hue_class[COLOR_HUE_LUT_SIZE] = {
+    COLOR_T64(COLOR_HUE_CLASS, 0), COLOR_T16(COLOR_HUE_CLASS, 64), COLOR_T16(COLOR_HUE_CLASS, 80),
+};
+
+_Static_assert(COLOR_HUE_LUT_SIZE == 96, "color_hue_class é expandida para 96 entradas");
+
+#define COLOR_CLASS_NAME(arg, id, name, lo, hi) [id] = name,
+
+static const char *const color_class_names[COLOR_CLASS_COUNT] = {
+    [COLOR_CLASS_DARK] = "escuro",
+    [COLOR_CLASS_NEUTRAL] = "neutro",
+    COLOR_CLASS_HUES(COLOR_CLASS_NAME, 0)
+};
+
+const char *color_class_name(color_class_t cls) {
+    return cls < COLOR_CLASS_COUNT ? color_class_names[cls] : "?";
+}
+
+// Fração x / c de um setor em 0..256 (256 só para x = c)
+static inline uint16_t color_hue_frac(uint8_t x, uint8_t c) {
+    return (uint16_t)(((uint32_t)x * color_recip8[c] + 128) >> 8);
+}
+
+color_class_result_t color_classify(const color_class_config_t *cfg,
+                                    uint32_t r, uint32_t g, uint32_t b) {
+    color_class_result_t res = {0, 0, 0, COLOR_CLASS_DARK};
+
+    r = color_apply_gain(r, cfg->gain_r);
+    g = color_apply_gain(g, cfg->gain_g);
+    b = color_apply_gain(b, cfg->gain_b);
+
+    uint32_t max = r > g ? r : g;
+    max = max > b ? max : b;
+    res.value = max;
+    if (max < cfg->min_value || max == 0)
+        return res;
+
+    // Reduz os canais a 8 bits mantendo a proporção; a matiz e a saturação
+    // só dependem das razões entre eles
+    uint8_t shift = 0;
+    while ((max >> shift) > 0xFF)
+        shift++;
+    uint8_t r8 = r >> shift, g8 = g >> shift, b8 = b >> shift;
+    uint8_t max8 = max >> shift;
+    uint8_t min8 = r8 < g8 ? r8 : g8;
+    min8 = min8 < b8 ? min8 : b8;
+    uint8_t chroma = max8 - min8;
+
+    uint16_t saturation = color_hue_frac(chroma, max8);
+    res.saturation = saturation > 0xFF ? 0xFF : (uint8_t)saturation;
+    if (res.saturation < cfg->min_saturation || chroma == 0) {
+        res.cls = COLOR_CLASS_NEUTRAL;
+        return res;
+    }
+
+    // Hexágono de matiz: setor pelo canal máximo, posição pela diferença
+    // entre os outros dois
+    int32_t hue;
+    if (max8 == r8)
+        hue = g8 >= b8 ? color_hue_frac(g8 - b8, chroma)
+                       : COLOR_HUE_TURN - color_hue_frac(b8 - g8, chroma);
+    else if (max8 == g8)
+        hue = b8 >= r8 ? 2 * COLOR_HUE_SECTOR + color_hue_frac(b8 - r8, chroma)
+                       : 2 * COLOR_HUE_SECTOR - color_hue_frac(r8 - b8, chroma);
+    else
+        hue = r8 >= g8 ? 4 * COLOR_HUE_SECTOR + color_hue_frac(r8 - g8, chroma)
+                       : 4 * COLOR_HUE_SECTOR - color_hue_frac(g8 - r8, chroma);
+    if (hue >= COLOR_HUE_TURN)
+        hue -= COLOR_HUE_TURN;
+
+    res.hue = (uint16_t)hue;
+    res.cls = (color_class_t)color_hue_class[hue >> COLOR_HUE_LUT_SHIFT];
+    return res;
+}
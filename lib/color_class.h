@@ -0,0 +1,62 @@
+#ifndef COLOR_CLASS_H
+#define COLOR_CLASS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Classificador de cor em inteiros: RGB -> matiz, saturação e valor em
+// ponto fixo, e matiz -> classe por uma tabela gerada em tempo de
+// compilação. Nenhuma divisão em tempo de execução: os quocientes usam a
+// tabela de recíprocos de 8 bits.
+//
+// Matiz em 1536 unidades por volta (256 por sexto: 0 vermelho, 256 amarelo,
+// 512 verde, 768 ciano, 1024 azul, 1280 magenta).
+#define COLOR_HUE_SECTOR 256
+#define COLOR_HUE_TURN (6 * COLOR_HUE_SECTOR)
+#define COLOR_HUE_LUT_SHIFT 4 // 96 entradas de 16 unidades (3,75 graus)
+#define COLOR_HUE_LUT_SIZE (COLOR_HUE_TURN >> COLOR_HUE_LUT_SHIFT)
+
+// Classes cromáticas: X(arg, id, nome, início, fim) com a faixa de matiz
+// [início, fim) em unidades, múltiplos de 16; início > fim dá a volta no 0.
+// A primeira faixa que contém a matiz vence.
+#define COLOR_CLASS_HUES(X, arg)                                   \
+    X(arg, COLOR_CLASS_RED,     "vermelho", 1472,   64) /* 345-15  */ \
+    X(arg, COLOR_CLASS_ORANGE,  "laranja",    64,  176) /*  15-41  */ \
+    X(arg, COLOR_CLASS_YELLOW,  "amarelo",   176,  304) /*  41-71  */ \
+    X(arg, COLOR_CLASS_GREEN,   "verde",     304,  704) /*  71-165 */ \
+    X(arg, COLOR_CLASS_CYAN,    "ciano",     704,  848) /* 165-199 */ \
+    X(arg, COLOR_CLASS_BLUE,    "azul",      848, 1104) /* 199-259 */ \
+    X(arg, COLOR_CLASS_MAGENTA, "magenta",  1104, 1472) /* 259-345 */
+
+#define COLOR_CLASS_ENUM(arg, id, name, lo, hi) id,
+
+typedef enum {
+    COLOR_CLASS_DARK,    // Valor abaixo de min_value
+    COLOR_CLASS_NEUTRAL, // Saturação abaixo de min_saturation (branco/cinza)
+    COLOR_CLASS_HUES(COLOR_CLASS_ENUM, 0)
+    COLOR_CLASS_COUNT
+} color_class_t;
+
+#define COLOR_CLASS_BIT(c) (1u << (c))
+
+typedef struct {
+    uint16_t gain_r, gain_g, gain_b; // Balanço de branco em Q8 (256 = 1,0)
+    uint8_t min_saturation;          // Q8: abaixo disso a cor é neutra
+    uint32_t min_value;              // Maior canal (após o ganho) abaixo disso é escuro
+} color_class_config_t;
+
+typedef struct {
+    uint16_t hue;       // 0..COLOR_HUE_TURN-1 (0 se neutra)
+    uint8_t saturation; // Q8
+    uint32_t value;     // Maior canal após o ganho
+    color_class_t cls;
+} color_class_result_t;
+
+extern const uint16_t color_recip8[256];              // 65536 / n arredondado (0 para n = 0)
+extern const uint8_t color_hue_class[COLOR_HUE_LUT_SIZE];
+
+color_class_result_t color_classify(const color_class_config_t *cfg,
+                                    uint32_t r, uint32_t g, uint32_t b);
+const char *color_class_name(color_class_t cls);
+
+#endif // COLOR_CLASS_H
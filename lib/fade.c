@@ -0,0 +1,51 @@
+#include "fade.h"
+
+void fade_init(fade_t *f) {
+    f->target = 0;
+    f->applied = 0;
+    for (int ch = 0; ch < FADE_CHANNELS; ch++) {
+        f->value_q16[ch] = 0;
+        f->step_q16[ch] = 0;
+    }
+    f->steps_left = 0;
+    f->steps = 0;
+}
+
+// Converte o alvo publicado em incrementos a partir do valor atual
+static void fade_retarget(fade_t *f, uint32_t target) {
+    f->applied = target;
+    for (int ch = 0; ch < FADE_CHANNELS; ch++) {
+        int32_t to = (int32_t)((target >> (16 - 8 * ch)) & 0xFF) << 16;
+        f->step_q16[ch] = (to - f->value_q16[ch]) / (int32_t)FADE_STEPS; // Potência de 2: vira deslocamento
+    }
+    f->steps_left = FADE_STEPS;
+}
+
+// Um passo do timer; true se o valor mudou (as saídas precisam ser escritas)
+bool fade_step(fade_t *f) {
+    uint32_t target = f->target; // Uma leitura: o alvo não muda no meio do passo
+    if (target != f->applied)
+        fade_retarget(f, target);
+    if (!f->steps_left)
+        return false;
+
+    f->steps++;
+    if (--f->steps_left == 0) {
+        // Último passo: exatamente no alvo, sem o resto do arredondamento
+        for (int ch = 0; ch < FADE_CHANNELS; ch++)
+            f->value_q16[ch] = (int32_t)((target >> (16 - 8 * ch)) & 0xFF) << 16;
+    } else {
+        for (int ch = 0; ch < FADE_CHANNELS; ch++)
+            f->value_q16[ch] += f->step_q16[ch];
+    }
+    return true;
+}
+
+color_rgb8_t fade_value(const fade_t *f) {
+    color_rgb8_t c = {
+        (uint8_t)(f->value_q16[0] >> 16),
+        (uint8_t)(f->value_q16[1] >> 16),
+        (uint8_t)(f->value_q16[2] >> 16),
+    };
+    return c;
+}
@@ -0,0 +1,53 @@
+#ifndef FADE_H
+#define FADE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "color.h"
+
+// Transições suaves de cor para as saídas (LED RGB por PWM e matriz
+// WS2812B). Quem produz a cor só publica o alvo com fade_set_target(), uma
+// escrita de 32 bits que pode vir de qualquer contexto sem trava; um timer
+// periódico chama fade_step(), que anda um passo em direção ao alvo.
+//
+// Cada canal guarda o valor em Q16 (0-255 com 16 bits de fração) e o
+// incremento por passo. A transição dura sempre 2^FADE_STEPS_SHIFT passos,
+// então o incremento é a diferença deslocada, sem divisão nem ao trocar o
+// alvo; cada passo é uma soma por canal e o último cai exatamente no alvo.
+// Um alvo novo no meio de uma transição parte do valor atual.
+//
+// Nada aqui depende do SDK: o relógio é quem chama fade_step(), o timer no
+// firmware e um contador de passos no host (sim/fade_check.c).
+
+#define FADE_CHANNELS 3
+#define FADE_STEPS_SHIFT 4                  // 16 passos por transição
+#define FADE_STEPS (1u << FADE_STEPS_SHIFT)
+#define FADE_TARGET_SET 0x01000000u         // Marca em fade_t.target: alvo publicado
+
+typedef struct {
+    volatile uint32_t target;   // FADE_TARGET_SET | r << 16 | g << 8 | b, escrito por fade_set_target
+    uint32_t applied;           // Último alvo já convertido em incrementos
+    int32_t value_q16[FADE_CHANNELS];
+    int32_t step_q16[FADE_CHANNELS];
+    uint16_t steps_left;        // 0: parado no alvo
+    uint32_t steps;             // Passos dados desde fade_init
+} fade_t;
+
+void fade_init(fade_t *f);
+
+static inline void fade_set_target(fade_t *f, color_rgb8_t c) {
+    f->target = FADE_TARGET_SET | (uint32_t)c.r << 16 | (uint32_t)c.g << 8 | c.b;
+}
+
+bool fade_step(fade_t *f);
+color_rgb8_t fade_value(const fade_t *f);
+
+// Nível de PWM com gamma quadrática calculada sobre o valor com fração, para
+// que a transição não ande em degraus de color_gamma_pwm nos níveis baixos.
+// Nos valores inteiros coincide com color_pwm_level().
+static inline uint16_t fade_pwm_level(const fade_t *f, int ch) {
+    uint32_t v = (uint32_t)f->value_q16[ch] >> 8; // Q8
+    return (uint16_t)((v * v) >> 16);
+}
+
+#endif // FADE_H
@@ -0,0 +1,93 @@
+#include "filter.h"
+
+#define FILTER_EMA_HALF (1u << (FILTER_EMA_FRAC - 1))
+
+void filter_init(filter_t *f, const filter_config_t *cfg) {
+    f->cfg = *cfg;
+    if (f->cfg.ema_shift > 8)
+        f->cfg.ema_shift = 8;
+    filter_reset(f);
+}
+
+// A próxima amostra reinicia os estágios com o próprio valor, sem transitório
+void filter_reset(filter_t *f) {
+    f->pos = 0;
+    f->primed = false;
+}
+
+#define FILTER_SORT2(a, b) do { if (a > b) { uint32_t t_ = a; a = b; b = t_; } } while (0)
+
+// Rede de ordenação parcial: 7 comparações, sem laços nem desvios por índice
+uint32_t filter_median5(const uint32_t v[FILTER_MEDIAN_SIZE]) {
+    uint32_t a = v[0], b = v[1], c = v[2], d = v[3], e = v[4];
+    FILTER_SORT2(a, b);
+    FILTER_SORT2(d, e);
+    FILTER_SORT2(a, d); // a é o menor dos quatro: descartado
+    FILTER_SORT2(b, e); // e é o maior dos quatro: descartado
+    FILTER_SORT2(b, c);
+    FILTER_SORT2(c, d);
+    FILTER_SORT2(b, c); // c é a mediana de b, c, d
+    return c;
+}
+
+uint32_t filter_update(filter_t *f, uint32_t x) {
+    const filter_config_t *cfg = &f->cfg;
+
+    if (x > FILTER_MAX_INPUT)
+        x = FILTER_MAX_INPUT;
+
+    if (!f->primed) {
+        for (uint8_t i = 0; i < FILTER_MEDIAN_SIZE; i++)
+            f->window[i] = x;
+        f->ema = (uint32_t)x << FILTER_EMA_FRAC;
+        f->out = x;
+        f->primed = true;
+        return x;
+    }
+
+    // 1. Mediana
+    if (cfg->median) {
+        f->window[f->pos] = x;
+        if (++f->pos == FILTER_MEDIAN_SIZE)
+            f->pos = 0;
+        x = filter_median5(f->window);
+    }
+
+    // 2. EMA: com entradas de até 23 bits a diferença cabe em 32 bits com
+    // sinal; o deslocamento aritmético faz o papel da multiplicação por alfa
+    if (cfg->ema_shift) {
+        int32_t diff = (int32_t)((uint32_t)x << FILTER_EMA_FRAC) - (int32_t)f->ema;
+        f->ema = (uint32_t)((int32_t)f->ema + (diff >> cfg->ema_shift));
+        x = (f->ema + FILTER_EMA_HALF) >> FILTER_EMA_FRAC;
+    }
+
+    // 3. Histerese: segura a saída dentro da faixa morta
+    uint32_t band = cfg->band;
+    if (cfg->band_shift && (f->out >> cfg->band_shift) > band)
+        band = f->out >> cfg->band_shift;
+    if (band) {
+        uint32_t lo = f->out > band ? f->out - band : 0;
+        uint32_t hi = f->out + band;
+        if (x >= lo && x <= hi)
+            return f->out;
+    }
+    f->out = x;
+    return x;
+}
+
+void filter_bank_init(filter_bank_t *bank, const filter_config_t *color_cfg,
+                      const filter_config_t *lux_cfg) {
+    filter_init(&bank->r, color_cfg);
+    filter_init(&bank->g, color_cfg);
+    filter_init(&bank->b, color_cfg);
+    filter_init(&bank->c, color_cfg);
+    filter_init(&bank->lux, lux_cfg);
+}
+
+void filter_bank_reset(filter_bank_t *bank) {
+    filter_reset(&bank->r);
+    filter_reset(&bank->g);
+    filter_reset(&bank->b);
+    filter_reset(&bank->c);
+    filter_reset(&bank->lux);
+}
@@ -0,0 +1,59 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Filtros de fluxo em ponto fixo para as leituras dos sensores. Cada canal
+// passa, em ordem, por três estágios opcionais, todos com trabalho constante
+// por amostra e sem float nem divisão:
+//
+//   mediana de 5  -> descarta picos isolados (atraso de 2 amostras)
+//   EMA           -> y += (x - y) / 2^shift, acumulador com 8 bits de fração
+//   histerese     -> a saída só muda quando a entrada se afasta mais que
+//                    band, ou que out / 2^band_shift se for maior
+//
+// A faixa relativa serve para canais com grande faixa dinâmica (os do GY-33
+// vão de unidades a milhões): uma faixa fixa ou congela as leituras fracas
+// ou não segura o ruído das fortes.
+//
+// Com o ruído tratado aqui os sensores podem usar integrações mais curtas
+// sem que LEDs, buzzer e display fiquem tremendo.
+
+#define FILTER_MEDIAN_SIZE 5
+#define FILTER_EMA_FRAC 8 // Bits de fração do acumulador da EMA
+#define FILTER_MAX_INPUT ((1u << (31 - FILTER_EMA_FRAC)) - 1) // Entradas até 23 bits
+
+typedef struct {
+    bool median;        // Liga a mediana de 5
+    uint8_t ema_shift;  // 0 = sem EMA; n = alfa de 1/2^n (1..8)
+    uint32_t band;      // 0 = sem faixa fixa
+    uint8_t band_shift; // 0 = sem faixa relativa; n = faixa de out / 2^n
+} filter_config_t;
+
+typedef struct {
+    filter_config_t cfg;
+    uint32_t window[FILTER_MEDIAN_SIZE]; // Janela circular da mediana
+    uint8_t pos;
+    uint32_t ema;      // Valor filtrado << FILTER_EMA_FRAC
+    uint32_t out;      // Última saída (estado da histerese)
+    bool primed;       // Já recebeu a primeira amostra
+} filter_t;
+
+// Um filtro por campo da amostra
+typedef struct {
+    filter_t r, g, b, c;
+    filter_t lux;
+} filter_bank_t;
+
+void filter_init(filter_t *f, const filter_config_t *cfg);
+void filter_reset(filter_t *f);
+uint32_t filter_update(filter_t *f, uint32_t x);
+
+uint32_t filter_median5(const uint32_t v[FILTER_MEDIAN_SIZE]);
+
+void filter_bank_init(filter_bank_t *bank, const filter_config_t *color_cfg,
+                      const filter_config_t *lux_cfg);
+void filter_bank_reset(filter_bank_t *bank);
+
+#endif // FILTER_H
@@ -0,0 +1,364 @@
+#include "flash_log.h"
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "calib.h" // calib_crc32
+
+// Uso em um único núcleo: append, service e o cursor rodam na mesma tarefa.
+
+#define FLASH_LOG_TIMEOUT_MS 100
+
+#ifndef FLASH_BINARY_END
+extern char __flash_binary_end; // Fim da imagem do firmware (linker script do SDK)
+#define FLASH_BINARY_END ((uintptr_t)&__flash_binary_end)
+#endif
+#define FLASH_LOG_MAX_ENCODED 24 // dt (5) + 4 canais zigzag de 25 bits (4) + lux de 17 bits (3)
+
+// Bloco em montagem
+static uint8_t log_open[FLASH_PAGE_SIZE];
+static uint16_t open_len, open_count;
+static flash_log_sample_t open_prev;
+
+// Blocos fechados esperando a flash
+static uint8_t log_queue[FLASH_LOG_QUEUE][FLASH_PAGE_SIZE];
+static uint8_t queue_first, queue_count;
+
+static bool log_enabled;    // A área do log não se sobrepõe à imagem do firmware
+static int log_head;        // Próxima página a programar
+static bool sector_ready;   // O setor de log_head já está apagado
+static uint32_t next_seq;
+static flash_log_stats_t stats;
+
+static inline const uint8_t *log_page_ptr(int page) {
+    return (const uint8_t *)(XIP_BASE + FLASH_LOG_OFFSET) + page * FLASH_PAGE_SIZE;
+}
+
+static inline uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t *p) {
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static inline void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+// --- Codificação ---
+
+static uint8_t put_varint(uint8_t *p, uint32_t v) {
+    uint8_t n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// Primeira amostra do bloco: valores absolutos; as demais: tempo desde a
+// anterior e diferenças com sinal
+static uint8_t encode_sample(uint8_t *p, const flash_log_sample_t *s, const flash_log_sample_t *prev) {
+    uint8_t n = 0;
+    if (!prev) {
+        n += put_varint(p + n, s->time_ms);
+        n += put_varint(p + n, s->r);
+        n += put_varint(p + n, s->g);
+        n += put_varint(p + n, s->b);
+        n += put_varint(p + n, s->c);
+        n += put_varint(p + n, s->lux);
+    } else {
+        n += put_varint(p + n, s->time_ms - prev->time_ms);
+        n += put_varint(p + n, zigzag((int32_t)(s->r - prev->r)));
+        n += put_varint(p + n, zigzag((int32_t)(s->g - prev->g)));
+        n += put_varint(p + n, zigzag((int32_t)(s->b - prev->b)));
+        n += put_varint(p + n, zigzag((int32_t)(s->c - prev->c)));
+        n += put_varint(p + n, zigzag((int32_t)s->lux - prev->lux));
+    }
+    return n;
+}
+
+// Fecha um bloco: cabeçalho, CRC logo após os dados e o resto em 0xFF (não
+// programa nada além do necessário)
+static void seal_block(uint8_t *block, uint16_t len, uint16_t count, uint32_t seq) {
+    put_u16(block, FLASH_LOG_MAGIC);
+    put_u16(block + 2, len);
+    put_u32(block + 4, seq);
+    put_u16(block + 8, stats.boot);
+    put_u16(block + 10, count);
+    uint32_t end = FLASH_LOG_HEADER_SIZE + len;
+    put_u32(block + end, calib_crc32(block, end));
+    memset(block + end + FLASH_LOG_CRC_SIZE, 0xFF, FLASH_PAGE_SIZE - end - FLASH_LOG_CRC_SIZE);
+}
+
+static void close_open_block(void) {
+    if (!open_count)
+        return;
+    if (queue_count == FLASH_LOG_QUEUE) {
+        stats.pages_dropped++; // A flash não acompanhou: perde o bloco inteiro
+    } else {
+        uint8_t *block = log_queue[(queue_first + queue_count) % FLASH_LOG_QUEUE];
+        memcpy(block, log_open, FLASH_PAGE_SIZE);
+        seal_block(block, open_len, open_count, next_seq++);
+        queue_count++;
+        stats.payload_bytes += open_len;
+    }
+    open_len = 0;
+    open_count = 0;
+}
+
+bool flash_log_append(const flash_log_sample_t *sample) {
+    if (!log_enabled)
+        return false;
+    uint8_t enc[FLASH_LOG_MAX_ENCODED];
+    uint8_t n = encode_sample(enc, sample, open_count ? &open_prev : NULL);
+    if (open_len + n > FLASH_LOG_DATA_SIZE) {
+        close_open_block();
+        n = encode_sample(enc, sample, NULL);
+    }
+    memcpy(log_open + FLASH_LOG_HEADER_SIZE + open_len, enc, n);
+    open_len += n;
+    open_count++;
+    open_prev = *sample;
+    stats.samples++;
+    return true;
+}
+
+// --- Leitura ---
+
+static bool header_plausible(const uint8_t *block) {
+    return get_u16(block) == FLASH_LOG_MAGIC && get_u16(block + 2) <= FLASH_LOG_DATA_SIZE;
+}
+
+bool flash_log_block_valid(const uint8_t *block) {
+    if (!header_plausible(block))
+        return false;
+    uint32_t end = FLASH_LOG_HEADER_SIZE + get_u16(block + 2);
+    return get_u32(block + end) == calib_crc32(block, end);
+}
+
+static bool get_varint(const uint8_t *p, uint32_t len, uint32_t *pos, uint32_t *v) {
+    uint32_t x = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        if (*pos >= len)
+            return false;
+        uint8_t byte = p[(*pos)++];
+        x |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *v = x;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Chama fn para cada amostra de um bloco válido; retorna quantas decodificou
+uint16_t flash_log_decode_block(const uint8_t *block, flash_log_sample_fn_t fn, void *ctx) {
+    if (!flash_log_block_valid(block))
+        return 0;
+    const uint8_t *data = block + FLASH_LOG_HEADER_SIZE;
+    uint32_t len = get_u16(block + 2), pos = 0;
+    uint16_t boot = get_u16(block + 8), count = get_u16(block + 10);
+    flash_log_sample_t s = {0};
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t v[6];
+        for (uint8_t k = 0; k < 6; k++)
+            if (!get_varint(data, len, &pos, &v[k]))
+                return i;
+        if (i == 0) {
+            s.time_ms = v[0];
+            s.r = v[1];
+            s.g = v[2];
+            s.b = v[3];
+            s.c = v[4];
+            s.lux = (uint16_t)v[5];
+        } else {
+            s.time_ms += v[0];
+            s.r += unzigzag(v[1]);
+            s.g += unzigzag(v[2]);
+            s.b += unzigzag(v[3]);
+            s.c += unzigzag(v[4]);
+            s.lux = (uint16_t)(s.lux + unzigzag(v[5]));
+        }
+        if (fn)
+            fn(ctx, boot, &s);
+    }
+    return count;
+}
+
+static bool page_erased(const uint8_t *p, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++)
+        if (p[i] != 0xFF)
+            return false;
+    return true;
+}
+
+// Bloco com cabeçalho plausível e maior seq abaixo de below
+static int find_newest(uint32_t below) {
+    int best = -1;
+    uint32_t best_seq = 0;
+    for (int page = 0; page < FLASH_LOG_PAGES; page++) {
+        const uint8_t *p = log_page_ptr(page);
+        if (!header_plausible(p))
+            continue;
+        uint32_t seq = get_u32(p + 4);
+        if (seq < below && (best < 0 || seq > best_seq)) {
+            best = page;
+            best_seq = seq;
+        }
+    }
+    return best;
+}
+
+// Acha o fim do log: o bloco válido mais novo. Um bloco programado pela
+// metade (queda de energia) tem o cabeçalho certo e o CRC errado, então é
+// ignorado e a escrita continua depois dele.
+bool flash_log_init(void) {
+    memset(&stats, 0, sizeof(stats));
+    open_len = open_count = 0;
+    queue_first = queue_count = 0;
+
+    // Uma imagem maior que o espaço abaixo do log seria apagada por ele
+    log_enabled = FLASH_BINARY_END - XIP_BASE <= FLASH_LOG_OFFSET;
+    if (!log_enabled)
+        return false;
+
+    uint32_t below = UINT32_MAX;
+    int newest;
+    while ((newest = find_newest(below)) >= 0 && !flash_log_block_valid(log_page_ptr(newest)))
+        below = get_u32(log_page_ptr(newest) + 4);
+
+    if (newest < 0) {
+        log_head = 0;
+        next_seq = 0;
+    } else {
+        const uint8_t *p = log_page_ptr(newest);
+        log_head = (newest + 1) % FLASH_LOG_PAGES;
+        next_seq = get_u32(p + 4) + 1;
+        stats.boot = get_u16(p + 8) + 1;
+    }
+
+    // Pula páginas sujas até o próximo setor, que será apagado de qualquer forma
+    while (log_head % FLASH_LOG_PAGES_PER_SECTOR &&
+           !page_erased(log_page_ptr(log_head), FLASH_PAGE_SIZE))
+        log_head = (log_head + 1) % FLASH_LOG_PAGES;
+    sector_ready = log_head % FLASH_LOG_PAGES_PER_SECTOR != 0;
+    return true;
+}
+
+// --- Gravação ---
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t *data; // NULL: apagar o setor
+} flash_log_op_t;
+
+static void flash_log_op(void *param) {
+    const flash_log_op_t *op = param;
+    if (op->data)
+        flash_range_program(op->offset, op->data, FLASH_PAGE_SIZE);
+    else
+        flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+}
+
+bool flash_log_pending(void) {
+    return queue_count != 0;
+}
+
+// Uma operação por chamada: apagar o setor que começa em log_head (se ainda
+// não estiver limpo) ou programar o bloco mais antigo da fila
+bool flash_log_service(void) {
+    if (!queue_count)
+        return false;
+
+    uint32_t page_offset = FLASH_LOG_OFFSET + (uint32_t)log_head * FLASH_PAGE_SIZE;
+    if (!sector_ready) {
+        sector_ready = true;
+        if (!page_erased(log_page_ptr(log_head), FLASH_SECTOR_SIZE)) {
+            flash_log_op_t op = {page_offset, NULL};
+            if (flash_safe_execute(flash_log_op, &op, FLASH_LOG_TIMEOUT_MS) != PICO_OK) {
+                sector_ready = false;
+                return false;
+            }
+            stats.sectors_erased++;
+            return true;
+        }
+    }
+
+    flash_log_op_t op = {page_offset, log_queue[queue_first]};
+    if (flash_safe_execute(flash_log_op, &op, FLASH_LOG_TIMEOUT_MS) != PICO_OK)
+        return false;
+    stats.pages_written++;
+    queue_first = (queue_first + 1) % FLASH_LOG_QUEUE;
+    queue_count--;
+    log_head = (log_head + 1) % FLASH_LOG_PAGES;
+    if (log_head % FLASH_LOG_PAGES_PER_SECTOR == 0)
+        sector_ready = false;
+    return true;
+}
+
+const flash_log_stats_t *flash_log_stats(void) {
+    return &stats;
+}
+
+// --- Cursor ---
+// A volta pela flash começa em log_head, onde estão os blocos mais antigos.
+
+void flash_log_cursor_init(flash_log_cursor_t *cur) {
+    cur->ram_seq = 0;
+    cur->ram_done = false;
+    cur->page = -1;
+    cur->remaining = FLASH_LOG_PAGES;
+}
+
+bool flash_log_cursor_next(flash_log_cursor_t *cur, uint8_t block[FLASH_PAGE_SIZE]) {
+    if (!log_enabled)
+        return false;
+    if (!cur->ram_done) {
+        // Pelo seq, e não pela posição: a fila pode andar entre as chamadas
+        for (uint8_t i = 0; i < queue_count; i++) {
+            const uint8_t *q = log_queue[(queue_first + i) % FLASH_LOG_QUEUE];
+            uint32_t seq = get_u32(q + 4);
+            if (seq >= cur->ram_seq) {
+                cur->ram_seq = seq + 1;
+                memcpy(block, q, FLASH_PAGE_SIZE);
+                return true;
+            }
+        }
+        cur->ram_done = true;
+        if (open_count) {
+            memcpy(block, log_open, FLASH_PAGE_SIZE);
+            seal_block(block, open_len, open_count, next_seq); // Mesmo seq que terá ao fechar
+            return true;
+        }
+    }
+
+    if (cur->page < 0)
+        cur->page = log_head;
+    while (cur->remaining > 0) {
+        const uint8_t *p = log_page_ptr(cur->page);
+        cur->page = (cur->page + 1) % FLASH_LOG_PAGES;
+        cur->remaining--;
+        if (flash_log_block_valid(p)) {
+            memcpy(block, p, FLASH_PAGE_SIZE);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,87 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/flash.h"
+
+// Histórico de amostras num log circular na flash, logo abaixo do setor da
+// calibração, para guardar horas de cor/lux sem host USB conectado.
+//
+// As amostras são codificadas em RAM num bloco do tamanho de uma página
+// (256 bytes): a primeira em valor absoluto e as seguintes como diferença
+// para a anterior, em zigzag + varint (LEB128), o que deixa leituras
+// estáveis com 1 byte por campo. Blocos cheios vão para uma fila e
+// flash_log_service() faz no máximo uma operação de flash por chamada
+// (apagar o setor seguinte ou programar uma página), para rodar como tarefa
+// de fundo. Ao entrar num setor novo ele é apagado, descartando os 16
+// blocos mais antigos.
+//
+// Bloco (little-endian):
+//   magic    u16  FLASH_LOG_MAGIC
+//   len      u16  Bytes de dados
+//   seq      u32  Número do bloco, crescente entre boots
+//   boot     u16  Contador de boots
+//   count    u16  Amostras no bloco
+//   dados    len  Amostras codificadas (ver flash_log.c)
+//   crc      u32  CRC-32 de magic..dados
+//
+// Decodificador no host: tools/telemetry_decode.py --log
+
+#define FLASH_LOG_MAGIC 0x474C // "LG"
+#define FLASH_LOG_SIZE (512 * 1024)
+#define FLASH_LOG_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE - FLASH_LOG_SIZE) // Abaixo da calibração
+#define FLASH_LOG_PAGES ((int)(FLASH_LOG_SIZE / FLASH_PAGE_SIZE))
+#define FLASH_LOG_PAGES_PER_SECTOR ((int)(FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE))
+#define FLASH_LOG_HEADER_SIZE 12
+#define FLASH_LOG_CRC_SIZE 4
+#define FLASH_LOG_DATA_SIZE (FLASH_PAGE_SIZE - FLASH_LOG_HEADER_SIZE - FLASH_LOG_CRC_SIZE)
+#define FLASH_LOG_QUEUE 2 // Blocos cheios aguardando a flash
+
+typedef struct {
+    uint32_t time_ms; // Desde o boot
+    uint32_t r, g, b, c; // Canais do GY-33, normalizados (ver sensores.h)
+    uint16_t lux;
+} flash_log_sample_t;
+
+#define FLASH_LOG_RAW_SAMPLE_SIZE 22 // Mesma amostra sem compressão
+
+typedef struct {
+    uint16_t boot;
+    uint32_t samples;         // Amostras aceitas desde o boot
+    uint32_t payload_bytes;   // Bytes de amostras codificadas em blocos fechados
+    uint32_t pages_written;
+    uint32_t sectors_erased;
+    uint32_t pages_dropped;   // Fila cheia: bloco perdido
+} flash_log_stats_t;
+
+typedef void (*flash_log_sample_fn_t)(void *ctx, uint16_t boot, const flash_log_sample_t *sample);
+
+// false se a imagem do firmware passa do início do log: apagar os setores
+// dele destruiria o próprio código, então o log fica desligado (append
+// recusa as amostras e o cursor não lê nada)
+bool flash_log_init(void);
+bool flash_log_append(const flash_log_sample_t *sample);
+bool flash_log_service(void);
+bool flash_log_pending(void);
+const flash_log_stats_t *flash_log_stats(void);
+
+// Leitura de todos os blocos: primeiro os que ainda estão em RAM (o aberto
+// vai fechado numa cópia e continua recebendo amostras), depois a flash do
+// mais antigo ao mais novo. Um bloco pode vir duas vezes com o mesmo seq se
+// for programado durante a leitura; quem lê ordena por seq e descarta a
+// repetição (fica a de mais amostras).
+typedef struct {
+    uint32_t ram_seq; // Próximo seq aceito da fila em RAM
+    bool ram_done;
+    int page;         // Próxima página da flash a visitar (-1 = ainda não começou)
+    int remaining;    // Páginas da flash ainda por visitar
+} flash_log_cursor_t;
+
+void flash_log_cursor_init(flash_log_cursor_t *cur);
+bool flash_log_cursor_next(flash_log_cursor_t *cur, uint8_t block[FLASH_PAGE_SIZE]);
+
+bool flash_log_block_valid(const uint8_t *block);
+uint16_t flash_log_decode_block(const uint8_t *block, flash_log_sample_fn_t fn, void *ctx);
+
+#endif // FLASH_LOG_H
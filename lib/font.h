@@ -1,4 +1,21 @@
-static uint8_t font[] = {
+#ifndef FONT_H
+#define FONT_H
+
+// Fonte 8x8, uma coluna por byte (bit 0 no topo), de ' ' a '~'.
+// Os dígitos ficam em macros para que ssd1306.c gere também as versões
+// ampliadas 2x e 3x em tempo de compilação.
+#define FONT_GLYPH_0 0x3E, 0x7F, 0x59, 0x4D, 0x47, 0x7F, 0x3E, 0x00
+#define FONT_GLYPH_1 0x00, 0x40, 0x42, 0x7F, 0x7F, 0x40, 0x40, 0x00
+#define FONT_GLYPH_2 0x72, 0x7B, 0x49, 0x49, 0x49, 0x4F, 0x46, 0x00
+#define FONT_GLYPH_3 0x41, 0x41, 0x49, 0x49, 0x49, 0x7F, 0x36, 0x00
+#define FONT_GLYPH_4 0x1E, 0x1E, 0x10, 0x10, 0x7F, 0x7F, 0x10, 0x00
+#define FONT_GLYPH_5 0x27, 0x67, 0x45, 0x45, 0x45, 0x7D, 0x39, 0x00
+#define FONT_GLYPH_6 0x3E, 0x7F, 0x49, 0x49, 0x49, 0x79, 0x30, 0x00
+#define FONT_GLYPH_7 0x01, 0x01, 0x61, 0x71, 0x19, 0x0F, 0x07, 0x00
+#define FONT_GLYPH_8 0x36, 0x7F, 0x49, 0x49, 0x49, 0x7F, 0x36, 0x00
+#define FONT_GLYPH_9 0x06, 0x4F, 0x49, 0x49, 0x49, 0x7F, 0x3E, 0x00
+
+static const uint8_t font[] = {
 
 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //  
 0x00, 0x00, 0x00, 0x5F, 0x5F, 0x00, 0x00, 0x00, // !
@@ -17,16 +34,16 @@ static uint8_t font[] = {
 0x00, 0x00, 0x00, 0x60, 0x60, 0x00, 0x00, 0x00, // .
 0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00, // /
 
-0x3E, 0x7F, 0x59, 0x4D, 0x47, 0x7F, 0x3E, 0x00, // 0
-0x00, 0x40, 0x42, 0x7F, 0x7F, 0x40, 0x40, 0x00, // 1
-0x72, 0x7B, 0x49, 0x49, 0x49, 0x4F, 0x46, 0x00, // 2
-0x41, 0x41, 0x49, 0x49, 0x49, 0x7F, 0x36, 0x00, // 3
-0x1E, 0x1E, 0x10, 0x10, 0x7F, 0x7F, 0x10, 0x00, // 4
-0x27, 0x67, 0x45, 0x45, 0x45, 0x7D, 0x39, 0x00, // 5
-0x3E, 0x7F, 0x49, 0x49, 0x49, 0x79, 0x30, 0x00, // 6
-0x01, 0x01, 0x61, 0x71, 0x19, 0x0F, 0x07, 0x00, // 7
-0x36, 0x7F, 0x49, 0x49, 0x49, 0x7F, 0x36, 0x00, // 8
-0x06, 0x4F, 0x49, 0x49, 0x49, 0x7F, 0x3E, 0x00, // 9
+FONT_GLYPH_0, // 0
+FONT_GLYPH_1, // 1
+FONT_GLYPH_2, // 2
+FONT_GLYPH_3, // 3
+FONT_GLYPH_4, // 4
+FONT_GLYPH_5, // 5
+FONT_GLYPH_6, // 6
+FONT_GLYPH_7, // 7
+FONT_GLYPH_8, // 8
+FONT_GLYPH_9, // 9
 
 0x00, 0x00, 0x00, 0x66, 0x66, 0x00, 0x00, 0x00, // :
 0x00, 0x00, 0x80, 0xE6, 0x66, 0x00, 0x00, 0x00, // ;
@@ -101,4 +118,6 @@ static uint8_t font[] = {
 0x00, 0x41, 0x41, 0x77, 0x3E, 0x08, 0x08, 0x00, // }
 0x02, 0x03, 0x01, 0x03, 0x02, 0x03, 0x01, 0x00  // ~
 
-};
\ No newline at end of file
+};
+
+#endif // FONT_H
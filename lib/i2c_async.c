@@ -0,0 +1,174 @@
+#include "i2c_async.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#define I2C_ASYNC_QUEUE_MASK (I2C_ASYNC_QUEUE_SIZE - 1)
+#define I2C_ASYNC_FIFO_DEPTH 16
+
+static i2c_inst_t *async_i2c;
+static i2c_async_txn_t *queue[I2C_ASYNC_QUEUE_SIZE];
+static volatile uint32_t queue_head, queue_tail;
+
+// Estado da transação em andamento (acessado só pela interrupção)
+static i2c_async_txn_t *volatile current;
+static uint16_t cmd_index;  // Comandos já escritos em IC_DATA_CMD
+static uint16_t rx_index;   // Bytes já lidos
+static bool aborted;
+
+static void i2c_async_start(i2c_async_txn_t *txn) {
+    i2c_hw_t *hw = i2c_get_hw(async_i2c);
+
+    current = txn;
+    cmd_index = 0;
+    rx_index = 0;
+    aborted = false;
+
+    // O endereço alvo só pode ser trocado com o controlador desabilitado
+    hw->enable = 0;
+    hw->tar = txn->addr;
+    hw->enable = 1;
+
+    // Descarta STOP/abort pendentes de transferências anteriores
+    (void)hw->clr_stop_det;
+    (void)hw->clr_tx_abrt;
+
+    hw->intr_mask = I2C_IC_INTR_MASK_M_TX_EMPTY_BITS |
+                    I2C_IC_INTR_MASK_M_RX_FULL_BITS |
+                    I2C_IC_INTR_MASK_M_TX_ABRT_BITS |
+                    I2C_IC_INTR_MASK_M_STOP_DET_BITS;
+}
+
+static void i2c_async_start_next() {
+    if (queue_tail == queue_head) {
+        current = NULL;
+        i2c_get_hw(async_i2c)->intr_mask = 0;
+        return;
+    }
+    i2c_async_txn_t *txn = queue[queue_tail & I2C_ASYNC_QUEUE_MASK];
+    queue_tail++;
+    i2c_async_start(txn);
+}
+
+static void i2c_async_drain_rx(i2c_hw_t *hw) {
+    while (hw->rxflr && rx_index < current->rx_len)
+        current->rx[rx_index++] = (uint8_t)hw->data_cmd;
+}
+
+static void i2c_async_fill_tx(i2c_hw_t *hw) {
+    uint16_t total = current->tx_len + current->rx_len;
+
+    while (cmd_index < total && hw->txflr < I2C_ASYNC_FIFO_DEPTH) {
+        uint32_t cmd;
+        if (cmd_index < current->tx_len) {
+            cmd = current->tx[cmd_index];
+        } else {
+            // Não pede mais leituras do que cabem na FIFO de recepção
+            if (cmd_index - current->tx_len - rx_index >= I2C_ASYNC_FIFO_DEPTH)
+                break;
+            cmd = I2C_IC_DATA_CMD_CMD_BITS;
+            if (cmd_index == current->tx_len && current->tx_len)
+                cmd |= I2C_IC_DATA_CMD_RESTART_BITS;
+        }
+        if (cmd_index == total - 1)
+            cmd |= I2C_IC_DATA_CMD_STOP_BITS;
+        hw->data_cmd = cmd;
+        cmd_index++;
+    }
+
+    if (cmd_index == total)
+        hw->intr_mask &= ~I2C_IC_INTR_MASK_M_TX_EMPTY_BITS;
+}
+
+static void i2c_async_irq_handler() {
+    i2c_hw_t *hw = i2c_get_hw(async_i2c);
+    uint32_t stat = hw->intr_stat;
+
+    if (!current) {
+        hw->intr_mask = 0;
+        return;
+    }
+
+    if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        current->abort_source = hw->tx_abrt_source;
+        (void)hw->clr_tx_abrt;
+        aborted = true;
+        hw->intr_mask &= ~I2C_IC_INTR_MASK_M_TX_EMPTY_BITS;
+    }
+
+    if (stat & I2C_IC_INTR_STAT_R_RX_FULL_BITS)
+        i2c_async_drain_rx(hw);
+
+    if ((stat & I2C_IC_INTR_STAT_R_TX_EMPTY_BITS) && !aborted)
+        i2c_async_fill_tx(hw);
+
+    // STOP encerra a transação, com sucesso ou após um abort
+    if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+        i2c_async_drain_rx(hw);
+
+        i2c_async_txn_t *txn = current;
+        bool ok = !aborted && rx_index == txn->rx_len;
+        txn->status = ok ? I2C_ASYNC_DONE : I2C_ASYNC_ERROR;
+        i2c_async_start_next();
+        if (txn->callback)
+            txn->callback(txn);
+    }
+}
+
+void i2c_async_init(i2c_inst_t *i2c) {
+    async_i2c = i2c;
+    queue_head = queue_tail = 0;
+    current = NULL;
+
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    hw->intr_mask = 0;
+    hw->rx_tl = 0;                          // RX_FULL com 1 byte na FIFO
+    hw->tx_tl = I2C_ASYNC_FIFO_DEPTH / 2;   // TX_EMPTY com a FIFO pela metade
+
+    uint irq = (i2c == i2c0) ? I2C0_IRQ : I2C1_IRQ;
+    irq_set_exclusive_handler(irq, i2c_async_irq_handler);
+    irq_set_enabled(irq, true);
+}
+
+// Enfileira a transação. Retorna false com a fila cheia, se a transação
+// ainda estiver pendente ou se não houver nada a transferir.
+bool i2c_async_submit(i2c_async_txn_t *txn) {
+    if (txn->status == I2C_ASYNC_PENDING || (txn->tx_len == 0 && txn->rx_len == 0))
+        return false;
+
+    uint32_t save = save_and_disable_interrupts();
+    if (queue_head - queue_tail >= I2C_ASYNC_QUEUE_SIZE) {
+        restore_interrupts(save);
+        return false;
+    }
+    txn->status = I2C_ASYNC_PENDING;
+    txn->abort_source = 0;
+    if (!current) {
+        i2c_async_start(txn);
+    } else {
+        queue[queue_head & I2C_ASYNC_QUEUE_MASK] = txn;
+        queue_head++;
+    }
+    restore_interrupts(save);
+    return true;
+}
+
+bool i2c_async_busy() {
+    return current != NULL;
+}
+
+void i2c_async_wait(const i2c_async_txn_t *txn) {
+    while (txn->status == I2C_ASYNC_PENDING)
+        tight_loop_contents();
+}
+
+// Enfileira e aguarda; para inicialização e chamadas fora do caminho crítico.
+bool i2c_async_transfer_blocking(i2c_async_txn_t *txn) {
+    while (!i2c_async_submit(txn)) {
+        if (txn->tx_len == 0 && txn->rx_len == 0)
+            return false;
+        tight_loop_contents();
+    }
+    i2c_async_wait(txn);
+    return txn->status == I2C_ASYNC_DONE;
+}
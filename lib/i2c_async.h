@@ -0,0 +1,47 @@
+#ifndef I2C_ASYNC_H
+#define I2C_ASYNC_H
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+// Fila de transações I2C assíncronas, executadas pela interrupção do
+// controlador: a CPU só entra para alimentar/esvaziar as FIFOs de 16 bytes
+// e é liberada durante os bytes no barramento.
+//
+// Cada transação é uma escrita, uma leitura, ou escrita seguida de leitura com
+// repeated start (tx_len > 0 e rx_len > 0). A memória da transação e dos
+// buffers pertence a quem a enfileira e deve permanecer válida até o fim.
+
+#define I2C_ASYNC_QUEUE_SIZE 8 // Potência de 2
+
+typedef enum {
+    I2C_ASYNC_IDLE,    // Nunca enviada
+    I2C_ASYNC_PENDING, // Na fila ou em andamento
+    I2C_ASYNC_DONE,    // Concluída com sucesso
+    I2C_ASYNC_ERROR    // Abortada (NACK, perda de arbitragem...)
+} i2c_async_status_t;
+
+typedef struct i2c_async_txn i2c_async_txn_t;
+
+// Chamado em contexto de interrupção ao fim da transação
+typedef void (*i2c_async_callback_t)(i2c_async_txn_t *txn);
+
+struct i2c_async_txn {
+    uint8_t addr;
+    const uint8_t *tx;
+    uint8_t tx_len;
+    uint8_t *rx;
+    uint8_t rx_len;
+    i2c_async_callback_t callback; // Opcional
+    void *user_data;
+    volatile i2c_async_status_t status;
+    uint32_t abort_source;         // IC_TX_ABRT_SOURCE em caso de erro
+};
+
+void i2c_async_init(i2c_inst_t *i2c);
+bool i2c_async_submit(i2c_async_txn_t *txn);
+bool i2c_async_busy();
+void i2c_async_wait(const i2c_async_txn_t *txn);
+bool i2c_async_transfer_blocking(i2c_async_txn_t *txn);
+
+#endif // I2C_ASYNC_H
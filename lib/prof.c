@@ -0,0 +1,71 @@
+#include "prof.h"
+
+#if PROF_ENABLED
+
+#include <stdio.h>
+#include <string.h>
+
+static prof_stat_t prof_stats[PROF_MAX_STAGES];
+static const char *const *prof_names;
+static uint prof_count;
+
+void prof_init(const char *const *names, uint count) {
+    prof_names = names;
+    prof_count = count < PROF_MAX_STAGES ? count : PROF_MAX_STAGES;
+    prof_reset();
+}
+
+void prof_reset() {
+    memset(prof_stats, 0, sizeof(prof_stats));
+    for (uint i = 0; i < PROF_MAX_STAGES; i++)
+        prof_stats[i].min_us = UINT32_MAX;
+}
+
+// Índice do balde = número de bits significativos de us
+uint prof_bucket(uint32_t us) {
+    uint bucket = us ? 32 - __builtin_clz(us) : 0;
+    return bucket < PROF_BUCKETS ? bucket : PROF_BUCKETS - 1;
+}
+
+void prof_record(uint stage, uint32_t us) {
+    if (stage >= prof_count)
+        return;
+    prof_stat_t *s = &prof_stats[stage];
+    s->count++;
+    s->sum_us += us;
+    if (us < s->min_us) s->min_us = us;
+    if (us > s->max_us) s->max_us = us;
+    s->hist[prof_bucket(us)]++;
+}
+
+const prof_stat_t *prof_get(uint stage) {
+    return stage < prof_count ? &prof_stats[stage] : NULL;
+}
+
+// Tabela com uma linha por estágio e os baldes não vazios pelo limite
+// superior em us ("<=1023:12" = 12 medidas entre 512 e 1023 us)
+void prof_dump() {
+    printf("%-14s %8s %8s %8s %8s\n", "estagio", "n", "min_us", "media_us", "max_us");
+    for (uint i = 0; i < prof_count; i++) {
+        const prof_stat_t *s = &prof_stats[i];
+        if (!s->count) {
+            printf("%-14s %8d %8s %8s %8s\n", prof_names[i], 0, "-", "-", "-");
+            continue;
+        }
+        printf("%-14s %8lu %8lu %8lu %8lu\n", prof_names[i], (unsigned long)s->count,
+               (unsigned long)s->min_us, (unsigned long)(s->sum_us / s->count),
+               (unsigned long)s->max_us);
+        printf("  ");
+        for (uint b = 0; b < PROF_BUCKETS; b++) {
+            if (!s->hist[b])
+                continue;
+            if (b == PROF_BUCKETS - 1)
+                printf(" >=%lu:%lu", 1ul << (b - 1), (unsigned long)s->hist[b]);
+            else
+                printf(" <=%lu:%lu", (1ul << b) - 1, (unsigned long)s->hist[b]);
+        }
+        printf("\n");
+    }
+}
+
+#endif // PROF_ENABLED
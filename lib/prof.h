@@ -0,0 +1,58 @@
+#ifndef PROF_H
+#define PROF_H
+
+#include "pico/stdlib.h"
+
+// Medição de latência por estágio do loop. Cada estágio acumula contagem,
+// mínimo, máximo, soma e um histograma em potências de 2, tudo em RAM fixa.
+// Marcar um trecho custa duas leituras de time_us_32 e uma chamada.
+//
+//     PROF_BEGIN(t);
+//     ...
+//     PROF_END(PROF_STAGE_X, t);
+//
+// Com PROF_ENABLED = 0 as macros e funções somem do binário.
+//
+// Cada estágio deve ser registrado por um único núcleo; o dump lê sem trava
+// e pode mostrar uma amostra pela metade, o que é aceitável para diagnóstico.
+
+#ifndef PROF_ENABLED
+#define PROF_ENABLED 1
+#endif
+
+#define PROF_MAX_STAGES 12
+#define PROF_BUCKETS 24 // Balde 0: 0 us; balde k: [2^(k-1), 2^k) us; o último acumula o resto
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t hist[PROF_BUCKETS];
+} prof_stat_t;
+
+#if PROF_ENABLED
+
+#define PROF_BEGIN(t) uint32_t t = time_us_32()
+#define PROF_END(stage, t) prof_record((stage), time_us_32() - (t))
+
+void prof_init(const char *const *names, uint count);
+void prof_reset();
+void prof_record(uint stage, uint32_t us);
+const prof_stat_t *prof_get(uint stage);
+uint prof_bucket(uint32_t us);
+void prof_dump();
+
+#else
+
+#define PROF_BEGIN(t) ((void)0)
+#define PROF_END(stage, t) ((void)0)
+
+#define prof_init(names, count) ((void)0)
+#define prof_reset() ((void)0)
+#define prof_record(stage, us) ((void)0)
+#define prof_dump() ((void)0)
+
+#endif // PROF_ENABLED
+
+#endif // PROF_H
@@ -0,0 +1,124 @@
+#include "pwm_seq.h"
+#include "hardware/dma.h"
+#include "hardware/pwm.h"
+
+void pwm_seq_init(pwm_seq_t *s, uint slice)
+{
+    s->slice = slice;
+    s->data_channel = dma_claim_unused_channel(true);
+    s->ctrl_channel = dma_claim_unused_channel(true);
+    s->table = NULL;
+    s->count = 0;
+    s->loop = false;
+}
+
+// Canal de dados: um valor por wrap da fatia, sem cadeia
+static dma_channel_config pwm_seq_data_config(const pwm_seq_t *s)
+{
+    dma_channel_config dc = dma_channel_get_default_config(s->data_channel);
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+    channel_config_set_read_increment(&dc, true);
+    channel_config_set_write_increment(&dc, false);
+    channel_config_set_dreq(&dc, pwm_get_dreq(s->slice));
+    return dc;
+}
+
+void pwm_seq_start(pwm_seq_t *s, pwm_seq_reg_t reg, const uint32_t *table, uint32_t count, bool loop)
+{
+    pwm_seq_stop(s);
+    if (!count) return;
+    s->table = table;
+    s->count = count;
+    s->loop = loop;
+
+    // Controle: uma palavra (o endereço da tabela) no alias de READ_ADDR com
+    // disparo do canal de dados; TRANS_COUNT recarrega o valor configurado
+    dma_channel_config cc = dma_channel_get_default_config(s->ctrl_channel);
+    channel_config_set_transfer_data_size(&cc, DMA_SIZE_32);
+    channel_config_set_read_increment(&cc, false);
+    channel_config_set_write_increment(&cc, false);
+    dma_channel_configure(s->ctrl_channel, &cc, &dma_hw->ch[s->data_channel].al3_read_addr_trig,
+                          &s->table, 1, false);
+
+    // Dados: em laço, encadeia no controle
+    dma_channel_config dc = pwm_seq_data_config(s);
+    if (loop) channel_config_set_chain_to(&dc, s->ctrl_channel);
+    volatile void *dst = reg == PWM_SEQ_REG_TOP ? (volatile void *)&pwm_hw->slice[s->slice].top
+                                                : (volatile void *)&pwm_hw->slice[s->slice].cc;
+    dma_channel_configure(s->data_channel, &dc, dst, table, count, true);
+}
+
+void pwm_seq_stop(pwm_seq_t *s)
+{
+    if (!s->count) return;
+    // Desfaz a cadeia antes de abortar, senão o fim da tabela pode redisparar
+    // o controle entre os dois abortos
+    dma_channel_config dc = pwm_seq_data_config(s);
+    dma_channel_set_config(s->data_channel, &dc, false);
+    dma_channel_abort(s->ctrl_channel);
+    dma_channel_abort(s->data_channel);
+    s->count = 0;
+    s->loop = false;
+}
+
+bool pwm_seq_is_busy(const pwm_seq_t *s)
+{
+    if (!s->count) return false;
+    return dma_channel_is_busy(s->data_channel) || (s->loop && dma_channel_is_busy(s->ctrl_channel));
+}
+
+uint32_t pwm_seq_period_ns(uint32_t sys_hz, uint32_t div16, uint16_t top)
+{
+    return (uint32_t)(((uint64_t)(top + 1u) * div16 * 1000000000u + 8u * sys_hz) / (16u * (uint64_t)sys_hz));
+}
+
+uint32_t pwm_seq_periods(uint32_t period_ns, uint32_t ms)
+{
+    uint32_t n = (uint32_t)(((uint64_t)ms * 1000000u + period_ns / 2) / period_ns);
+    return n ? n : 1;
+}
+
+uint16_t pwm_seq_tone_top(uint32_t sys_hz, uint32_t div16, uint32_t hz)
+{
+    uint64_t counts = ((uint64_t)sys_hz * 16u + (uint64_t)div16 * hz / 2) / ((uint64_t)div16 * hz);
+    if (counts < 2) return 1;
+    if (counts > 65536) return 65535;
+    return (uint16_t)(counts - 1);
+}
+
+uint32_t pwm_seq_build_hold(uint32_t *table, uint32_t max, uint32_t value, uint32_t periods)
+{
+    if (periods > max) return 0;
+    for (uint32_t i = 0; i < periods; i++)
+        table[i] = value;
+    return periods;
+}
+
+// Mesma gamma de fade_pwm_level(): quadrado do valor em Q8
+static uint16_t pwm_seq_gamma_q16(int32_t v_q16)
+{
+    uint32_t v = (uint32_t)v_q16 >> 8;
+    return (uint16_t)((v * v) >> 16);
+}
+
+uint32_t pwm_seq_build_ramp(uint32_t *table, uint32_t max, uint32_t periods,
+                            uint8_t a0, uint8_t b0, uint8_t a1, uint8_t b1)
+{
+    if (!periods || periods > max) return 0;
+    int64_t da = ((int64_t)a1 - a0) << 16;
+    int64_t db = ((int64_t)b1 - b0) << 16;
+    for (uint32_t i = 1; i <= periods; i++) {
+        int32_t a = ((int32_t)a0 << 16) + (int32_t)(da * i / periods);
+        int32_t b = ((int32_t)b0 << 16) + (int32_t)(db * i / periods);
+        table[i - 1] = PWM_SEQ_CC(pwm_seq_gamma_q16(a), pwm_seq_gamma_q16(b));
+    }
+    return periods;
+}
+
+uint32_t pwm_seq_build_tone(uint32_t *table, uint32_t max, uint32_t sys_hz, uint32_t div16,
+                            uint32_t hz, uint32_t ms)
+{
+    if (!hz) return 0;
+    uint16_t top = pwm_seq_tone_top(sys_hz, div16, hz);
+    return pwm_seq_build_hold(table, max, top, pwm_seq_periods(pwm_seq_period_ns(sys_hz, div16, top), ms));
+}
@@ -0,0 +1,82 @@
+#ifndef PWM_SEQ_H
+#define PWM_SEQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+// Sequências de PWM tocadas pelo DMA: um canal copia uma tabela pré-calculada
+// para um registrador da fatia, um valor por período do PWM, no ritmo do DREQ
+// de wrap da fatia. Depois de iniciada a sequência não usa a CPU: em laço, um
+// segundo canal (controle) regrava o endereço de leitura do primeiro no fim da
+// tabela e o redispara pela cadeia, sem interrupção.
+//
+// O registrador de destino é o CC da fatia (nível do canal A nos 16 bits
+// baixos, do B nos altos; PWM_SEQ_CC) para rampas de LED e bipes, ou o TOP
+// para trocar a nota do buzzer com o nível fixo. As tabelas precisam
+// continuar válidas enquanto a sequência toca.
+//
+// Os geradores de tabela não dependem do SDK e são verificados no host
+// (sim/pwm_seq_check.c).
+
+#define PWM_SEQ_CC(a, b) ((uint32_t)(uint16_t)(a) | (uint32_t)(uint16_t)(b) << 16)
+
+typedef enum {
+    PWM_SEQ_REG_CC,     // Níveis dos canais A e B
+    PWM_SEQ_REG_TOP     // Wrap (período) da fatia
+} pwm_seq_reg_t;
+
+typedef struct {
+    uint slice;
+    int data_channel;           // Tabela -> registrador, pacing pelo wrap
+    int ctrl_channel;           // Rearma data_channel no fim da tabela (laço)
+    const uint32_t *table;      // Lido pelo canal de controle
+    uint32_t count;
+    bool loop;
+} pwm_seq_t;
+
+// Reserva os dois canais de DMA para a fatia
+void pwm_seq_init(pwm_seq_t *s, uint slice);
+
+// Toca count valores de table em reg, o primeiro no próximo wrap. Uma
+// sequência em andamento é interrompida antes.
+void pwm_seq_start(pwm_seq_t *s, pwm_seq_reg_t reg, const uint32_t *table, uint32_t count, bool loop);
+
+// Interrompe; a saída fica com o último valor escrito
+void pwm_seq_stop(pwm_seq_t *s);
+
+// Em laço, ocupado até pwm_seq_stop(); uma vez, até o último valor
+bool pwm_seq_is_busy(const pwm_seq_t *s);
+
+// --- Tempo ---
+// div16: divisor de clock da fatia com 4 bits de fração (o formato do
+// registrador DIV), por exemplo 16.0 -> 256
+
+uint32_t pwm_seq_period_ns(uint32_t sys_hz, uint32_t div16, uint16_t top);
+
+// Períodos de period_ns em ms (ao menos 1)
+uint32_t pwm_seq_periods(uint32_t period_ns, uint32_t ms);
+
+// TOP para uma nota de hz, limitado a 16 bits
+uint16_t pwm_seq_tone_top(uint32_t sys_hz, uint32_t div16, uint32_t hz);
+
+// --- Tabelas ---
+// Cada gerador escreve a partir de table e retorna quantos valores escreveu,
+// ou 0 se não couberem em max. Para encadear partes, chame de novo a partir
+// de table + n.
+
+// value repetido por periods períodos (um degrau de bipe, uma pausa)
+uint32_t pwm_seq_build_hold(uint32_t *table, uint32_t max, uint32_t value, uint32_t periods);
+
+// Rampa de periods valores de CC de (a0, b0) a (a1, b1), com a gamma
+// quadrática de fade_pwm_level() sobre a fração; o último valor é o alvo
+// exato (color_pwm_level)
+uint32_t pwm_seq_build_ramp(uint32_t *table, uint32_t max, uint32_t periods,
+                            uint8_t a0, uint8_t b0, uint8_t a1, uint8_t b1);
+
+// Nota de hz por ms como valores de TOP; cada valor dura um período da
+// própria nota, então a quantidade depende da frequência
+uint32_t pwm_seq_build_tone(uint32_t *table, uint32_t max, uint32_t sys_hz, uint32_t div16,
+                            uint32_t hz, uint32_t ms);
+
+#endif // PWM_SEQ_H
@@ -0,0 +1,47 @@
+#include "sample_ring.h"
+#include "hardware/sync.h"
+
+#define SAMPLE_RING_MASK (SAMPLE_RING_SIZE - 1)
+
+void sample_ring_init(sample_ring_t *ring) {
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+}
+
+// Produtor: nunca bloqueia; com a fila cheia a amostra é descartada e contada.
+bool sample_ring_push(sample_ring_t *ring, const sensor_sample_t *sample) {
+    uint32_t head = ring->head;
+    if (head - ring->tail >= SAMPLE_RING_SIZE) {
+        ring->dropped++;
+        return false;
+    }
+    ring->items[head & SAMPLE_RING_MASK] = *sample;
+    __mem_fence_release(); // Conteúdo visível antes do novo head
+    ring->head = head + 1;
+    return true;
+}
+
+// Consumidor: retira a amostra mais antiga.
+bool sample_ring_pop(sample_ring_t *ring, sensor_sample_t *sample) {
+    uint32_t tail = ring->tail;
+    if (tail == ring->head)
+        return false;
+    __mem_fence_acquire();
+    *sample = ring->items[tail & SAMPLE_RING_MASK];
+    __mem_fence_release(); // Leitura concluída antes de liberar a posição
+    ring->tail = tail + 1;
+    return true;
+}
+
+// Consumidor: descarta as pendentes e retira só a mais recente.
+bool sample_ring_pop_latest(sample_ring_t *ring, sensor_sample_t *sample) {
+    uint32_t head = ring->head;
+    if (ring->tail == head)
+        return false;
+    __mem_fence_acquire();
+    *sample = ring->items[(head - 1) & SAMPLE_RING_MASK];
+    __mem_fence_release();
+    ring->tail = head;
+    return true;
+}
@@ -0,0 +1,32 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Fila circular sem trava, um produtor (núcleo 0, sensores) e um consumidor
+// (núcleo 1, saídas). Cada índice só é escrito por um dos lados; as barreiras
+// de memória garantem que o consumidor nunca veja uma amostra incompleta.
+
+#define SAMPLE_RING_SIZE 8 // Potência de 2
+
+typedef struct {
+    uint32_t r, g, b, c;   // Canais do GY-33, normalizados (ver sensores.h)
+    uint16_t lux;          // Luminosidade do BH1750
+    uint32_t timestamp_us; // Instante da leitura (time_us_32)
+    uint32_t seq;          // Número de sequência da amostra
+} sensor_sample_t;
+
+typedef struct {
+    sensor_sample_t items[SAMPLE_RING_SIZE];
+    volatile uint32_t head; // Escrito apenas pelo produtor
+    volatile uint32_t tail; // Escrito apenas pelo consumidor
+    uint32_t dropped;       // Amostras descartadas com a fila cheia (produtor)
+} sample_ring_t;
+
+void sample_ring_init(sample_ring_t *ring);
+bool sample_ring_push(sample_ring_t *ring, const sensor_sample_t *sample);
+bool sample_ring_pop(sample_ring_t *ring, sensor_sample_t *sample);
+bool sample_ring_pop_latest(sample_ring_t *ring, sensor_sample_t *sample);
+
+#endif // SAMPLE_RING_H
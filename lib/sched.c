@@ -0,0 +1,156 @@
+#include "sched.h"
+#include <stdio.h>
+
+void sched_init(sched_t *s) {
+    s->count = 0;
+    if (!s->stats_lock)
+        s->stats_lock = spin_lock_init(spin_lock_claim_unused(true));
+}
+
+bool sched_add(sched_t *s, sched_task_t *task) {
+    if (s->count == SCHED_MAX_TASKS || !task->fn)
+        return false;
+    task->next_release = time_us_64() + task->offset_us;
+    task->triggered = false;
+    s->tasks[s->count++] = task;
+    return true;
+}
+
+// Libera uma tarefa esporádica. Pode ser chamada do outro núcleo: o SEV
+// acorda o escalonador dele se estiver em WFE.
+void sched_trigger(sched_task_t *task) {
+    task->trigger_time = time_us_32();
+    __mem_fence_release();
+    task->triggered = true;
+    __sev();
+}
+
+// Instante de liberação da tarefa, se estiver pronta em now
+static bool sched_ready(const sched_task_t *t, uint64_t now, uint64_t *release) {
+    if (t->period_us) {
+        *release = t->next_release;
+        return now >= t->next_release;
+    }
+    if (!t->triggered)
+        return false;
+    __mem_fence_acquire();
+    *release = now - (uint32_t)((uint32_t)now - t->trigger_time);
+    return true;
+}
+
+static void sched_execute(sched_t *s, sched_task_t *t, uint64_t release, uint64_t start) {
+    if (!t->period_us)
+        t->triggered = false; // Antes de rodar: um novo disparo durante a execução não se perde
+
+    t->fn(t->arg);
+    uint64_t end = time_us_64();
+
+    // Mantém a fase; se ficou mais de um período para trás, pula as
+    // liberações vencidas em vez de rodar várias seguidas
+    uint64_t next = release + t->period_us;
+    uint32_t missed = 0;
+    if (t->period_us && end >= next + t->period_us) {
+        missed = (uint32_t)((end - next) / t->period_us);
+        next += (uint64_t)missed * t->period_us;
+    }
+    if (t->period_us)
+        t->next_release = next;
+
+    uint32_t late = (uint32_t)(start - release);
+    uint32_t exec = (uint32_t)(end - start);
+    uint32_t save = spin_lock_blocking(s->stats_lock);
+    t->runs++;
+    t->late_sum_us += late;
+    t->exec_sum_us += exec;
+    if (late > t->late_max_us) t->late_max_us = late;
+    if (exec > t->exec_max_us) t->exec_max_us = exec;
+    if (end - release > t->deadline_us) t->overruns++;
+    t->skipped += missed;
+    spin_unlock(s->stats_lock, save);
+}
+
+// Roda todas as tarefas prontas, a de prazo mais cedo primeiro, e retorna a
+// próxima liberação periódica (UINT64_MAX se só há esporádicas).
+uint64_t sched_run_pending(sched_t *s) {
+    while (1) {
+        uint64_t now = time_us_64();
+        sched_task_t *best = NULL;
+        uint64_t best_release = 0, best_deadline = UINT64_MAX;
+
+        for (uint i = 0; i < s->count; i++) {
+            uint64_t release;
+            if (!sched_ready(s->tasks[i], now, &release))
+                continue;
+            uint64_t deadline = release + s->tasks[i]->deadline_us;
+            if (!best || deadline < best_deadline) {
+                best = s->tasks[i];
+                best_release = release;
+                best_deadline = deadline;
+            }
+        }
+        if (!best)
+            break;
+        sched_execute(s, best, best_release, now);
+    }
+
+    uint64_t next = UINT64_MAX;
+    for (uint i = 0; i < s->count; i++) {
+        if (s->tasks[i]->period_us && s->tasks[i]->next_release < next)
+            next = s->tasks[i]->next_release;
+    }
+    return next;
+}
+
+bool sched_has_pending(const sched_t *s) {
+    for (uint i = 0; i < s->count; i++) {
+        if (!s->tasks[i]->period_us && s->tasks[i]->triggered)
+            return true;
+    }
+    return false;
+}
+
+// Laço do núcleo: nunca retorna. Um disparo entre a varredura e o WFE não se
+// perde, porque o SEV deixa o evento pendente e o WFE retorna na hora.
+void sched_run(sched_t *s) {
+    while (1) {
+        uint64_t next = sched_run_pending(s);
+        if (sched_has_pending(s))
+            continue;
+        if (next == UINT64_MAX)
+            __wfe();
+        else
+            best_effort_wfe_or_timeout(from_us_since_boot(next));
+    }
+}
+
+void sched_reset_stats(sched_t *s) {
+    uint32_t save = spin_lock_blocking(s->stats_lock);
+    for (uint i = 0; i < s->count; i++) {
+        sched_task_t *t = s->tasks[i];
+        t->runs = t->overruns = t->skipped = 0;
+        t->late_max_us = t->exec_max_us = 0;
+        t->late_sum_us = t->exec_sum_us = 0;
+    }
+    spin_unlock(s->stats_lock, save);
+}
+
+// Copia as estatísticas sob a trava e imprime fora dela
+void sched_dump(const sched_t *s) {
+    sched_task_t copy[SCHED_MAX_TASKS];
+    uint32_t save = spin_lock_blocking(s->stats_lock);
+    for (uint i = 0; i < s->count; i++)
+        copy[i] = *s->tasks[i];
+    spin_unlock(s->stats_lock, save);
+
+    printf("%-10s %7s %7s %7s %5s %5s %8s %8s %8s %8s\n", "tarefa", "periodo", "prazo", "n",
+           "estou", "pulo", "atr_med", "atr_max", "exec_med", "exec_max");
+    for (uint i = 0; i < s->count; i++) {
+        const sched_task_t *t = &copy[i];
+        uint32_t runs = t->runs ? t->runs : 1;
+        printf("%-10s %7lu %7lu %7lu %5lu %5lu %8lu %8lu %8lu %8lu\n", t->name,
+               (unsigned long)t->period_us, (unsigned long)t->deadline_us, (unsigned long)t->runs,
+               (unsigned long)t->overruns, (unsigned long)t->skipped,
+               (unsigned long)(t->late_sum_us / runs), (unsigned long)t->late_max_us,
+               (unsigned long)(t->exec_sum_us / runs), (unsigned long)t->exec_max_us);
+    }
+}
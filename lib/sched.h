@@ -0,0 +1,64 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Escalonador cooperativo multi-taxa, um por núcleo. Cada tarefa tem período
+// e prazo próprios; entre os disparos o núcleo dorme em WFE com o alarme do
+// SDK (best_effort_wfe_or_timeout) marcando a próxima liberação.
+//
+// Tarefas com period_us = 0 são esporádicas: só rodam quando alguém chama
+// sched_trigger(), inclusive do outro núcleo. Quando várias tarefas estão
+// prontas, roda primeiro a de prazo absoluto mais cedo (EDF).
+//
+// Por tarefa são registrados atraso de início (jitter em relação à
+// liberação), tempo de execução, estouros de prazo e liberações puladas
+// quando a tarefa ficou mais de um período atrasada. As estatísticas ficam
+// sob a trava de spin do escalonador, para que sched_reset_stats() e
+// sched_dump() possam ser chamadas do outro núcleo.
+
+#define SCHED_MAX_TASKS 8
+
+typedef void (*sched_fn_t)(void *arg);
+
+typedef struct {
+    // Configuração
+    const char *name;
+    sched_fn_t fn;
+    void *arg;
+    uint32_t period_us;   // 0 = esporádica
+    uint32_t deadline_us; // Relativo à liberação
+    uint32_t offset_us;   // Primeira liberação após sched_add()
+
+    // Estado
+    uint64_t next_release;
+    volatile bool triggered;
+    volatile uint32_t trigger_time; // time_us_32 do disparo
+
+    // Estatísticas
+    uint32_t runs;
+    uint32_t overruns;    // Terminou depois do prazo
+    uint32_t skipped;     // Liberações perdidas por atraso
+    uint32_t late_max_us;
+    uint64_t late_sum_us;
+    uint32_t exec_max_us;
+    uint64_t exec_sum_us;
+} sched_task_t;
+
+typedef struct {
+    sched_task_t *tasks[SCHED_MAX_TASKS];
+    uint count;
+    spin_lock_t *stats_lock;
+} sched_t;
+
+void sched_init(sched_t *s);
+bool sched_add(sched_t *s, sched_task_t *task);
+void sched_trigger(sched_task_t *task);
+uint64_t sched_run_pending(sched_t *s);
+bool sched_has_pending(const sched_t *s);
+void sched_run(sched_t *s);
+void sched_reset_stats(sched_t *s);
+void sched_dump(const sched_t *s);
+
+#endif // SCHED_H
@@ -1,46 +1,380 @@
 #include "sensores.h"
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "hardware/sync.h"
+
+// All sensor traffic goes through the i2c_async queue on I2C_PORT_SHARED:
+// requests are queued and completed from the I2C interrupt, so the CPU is
+// free while bytes are on the bus. i2c_async_init() must be called after
+// i2c_init() and before any function below.
 
 // --- BH1750 Functions ---
-void _bh1750_i2c_write_byte(uint8_t byte) {
-    i2c_write_blocking(I2C_PORT_SHARED, BH1750_I2C_ADDR, &byte, 1, false);
+// The sensor is put into continuous H-resolution mode once; after that it
+// refreshes its data register on its own every conversion period, so reads
+// never have to wait. bh1750_poll() only queues a read when a new
+// conversion is due and otherwise returns immediately.
+//
+// The first value comes from a one-time L-resolution measurement (24 ms
+// instead of 180 ms) so the first valid sample after boot does not wait for
+// a full H-resolution conversion; the next poll switches to continuous mode.
+static bh1750_state_t bh1750_state = BH1750_STATE_OFF;
+static volatile absolute_time_t bh1750_ready_at;    // When the next conversion is guaranteed to be available
+static volatile absolute_time_t bh1750_sampled_at;  // When the last value was read
+static volatile uint16_t bh1750_last_lux;
+static volatile bool bh1750_fresh;                  // A read completed since the last poll
+static volatile bool bh1750_quick;                  // The pending/last read is the one-time L-res one
+
+static const uint8_t bh1750_power_cmd = _POWER_ON_C;
+static const uint8_t bh1750_mode_cmd = _CONT_HRES_C;
+static const uint8_t bh1750_quick_cmd = _ONE_TIME_LRES_C;
+static uint8_t bh1750_rx[2];
+static i2c_async_txn_t bh1750_power_txn;
+static i2c_async_txn_t bh1750_mode_txn;
+static i2c_async_txn_t bh1750_read_txn;
+
+static void bh1750_read_done(i2c_async_txn_t *txn) {
+    if (txn->status != I2C_ASYNC_DONE) {
+        bh1750_ready_at = get_absolute_time(); // Retry on the next poll
+        return;
+    }
+    // lux = raw / 1.2, kept in integer math
+    bh1750_last_lux = (((uint32_t)bh1750_rx[0] << 8) | bh1750_rx[1]) * 5 / 6;
+    bh1750_sampled_at = get_absolute_time();
+    if (!bh1750_quick) // After the quick read the next poll restarts the conversions
+        bh1750_ready_at = delayed_by_ms(bh1750_sampled_at, BH1750_CONV_TIME_MS);
+    bh1750_state = BH1750_STATE_RUNNING;
+    bh1750_fresh = true;
+}
+
+static void _bh1750_submit_cmd(i2c_async_txn_t *txn, const uint8_t *cmd) {
+    txn->addr = BH1750_I2C_ADDR;
+    txn->tx = cmd;
+    txn->tx_len = 1;
+    txn->rx_len = 0;
+    i2c_async_submit(txn);
 }
 
 void bh1750_power_on() {
-    _bh1750_i2c_write_byte(_POWER_ON_C);
+    _bh1750_submit_cmd(&bh1750_power_txn, &bh1750_power_cmd);
+}
+
+// Starts with a one-time L-resolution measurement, ready in
+// BH1750_LRES_TIME_MS instead of a full H-resolution conversion. The poll
+// that picks it up switches the sensor to continuous H-resolution mode.
+void bh1750_start() {
+    _bh1750_submit_cmd(&bh1750_mode_txn, &bh1750_quick_cmd);
+    bh1750_quick = true;
+    bh1750_ready_at = make_timeout_time_ms(BH1750_LRES_TIME_MS);
+    bh1750_state = BH1750_STATE_CONVERTING;
+}
+
+// The one-time measurement powers the sensor down: power it up again and
+// enter continuous H-resolution mode
+static void bh1750_enter_continuous() {
+    bh1750_quick = false;
+    _bh1750_submit_cmd(&bh1750_power_txn, &bh1750_power_cmd);
+    _bh1750_submit_cmd(&bh1750_mode_txn, &bh1750_mode_cmd);
+    bh1750_ready_at = make_timeout_time_ms(BH1750_CONV_TIME_MS);
+}
+
+// Returns true and updates *lux only when a fresh value arrived since the
+// last call; otherwise *lux gets the last known value. When a conversion is
+// due, a read is queued and its result shows up on a later call. Never blocks.
+bool bh1750_poll(uint16_t *lux) {
+    if (bh1750_fresh) {
+        bh1750_fresh = false;
+        if (bh1750_quick)
+            bh1750_enter_continuous();
+        if (lux) *lux = bh1750_last_lux;
+        return true;
+    }
+
+    if (bh1750_state != BH1750_STATE_OFF &&
+        bh1750_read_txn.status != I2C_ASYNC_PENDING &&
+        time_reached(bh1750_ready_at)) {
+        bh1750_read_txn.addr = BH1750_I2C_ADDR;
+        bh1750_read_txn.tx_len = 0;
+        bh1750_read_txn.rx = bh1750_rx;
+        bh1750_read_txn.rx_len = 2;
+        bh1750_read_txn.callback = bh1750_read_done;
+        i2c_async_submit(&bh1750_read_txn);
+    }
+
+    if (lux) *lux = bh1750_last_lux;
+    return false;
+}
+
+absolute_time_t bh1750_sample_ready_at() {
+    return bh1750_ready_at;
+}
+
+absolute_time_t bh1750_sample_time() {
+    return bh1750_sampled_at;
 }
 
+bh1750_state_t bh1750_get_state() {
+    return bh1750_state;
+}
+
+// Returns the latest lux value without blocking (queues a read if one is due).
 uint16_t bh1750_read_measurement() {
-    _bh1750_i2c_write_byte(_CONT_HRES_C);
-    sleep_ms(200);
-    uint8_t buff[2];
-    i2c_read_blocking(I2C_PORT_SHARED, BH1750_I2C_ADDR, buff, 2, false);
-    return (((uint16_t)buff[0] << 8) | buff[1]) / 1.2;
+    uint16_t lux;
+    bh1750_poll(&lux);
+    return lux;
 }
 
 // --- GY-33 Functions ---
+// A color sample is a single auto-increment burst of STATUS..BDATAH (9 bytes)
+// in one write+read transaction. With PERS = 0 and AIEN set the sensor
+// raises AINT at the end of every RGBC cycle; it is cleared after each read,
+// so AINT set means the data belongs to an integration not seen before, and
+// all four channels come from that same integration. Requests are also
+// gated by time so the bus is idle while an integration is running.
+static const uint8_t gy33_burst_cmd = STATUS_REG | GY33_CMD_AUTO_INC;
+static const uint8_t gy33_clear_int_cmd = GY33_CMD_CLEAR_INT;
+static uint8_t gy33_burst_rx[9];
+static i2c_async_txn_t gy33_burst_txn;
+static i2c_async_txn_t gy33_clear_txn;
+static volatile absolute_time_t gy33_ready_at;
+static volatile absolute_time_t gy33_sampled_at;
+static volatile uint32_t gy33_last[4];   // c, r, g, b (normalized)
+static volatile bool gy33_fresh;
+
+// Auto-exposure steps, ordered by sensitivity (gain x cycles). For each
+// sensitivity the shortest integration is used, so gain is raised before
+// integration time and bright scenes get the highest sample rate.
+typedef struct {
+    uint8_t gain;          // CONTROL register value
+    uint8_t cycles;        // Integration cycles (ATIME = 256 - cycles)
+    uint16_t sensitivity;  // gain multiplier x cycles
+} gy33_exposure_t;
+
+static const gy33_exposure_t gy33_exposures[] = {
+    {GY33_GAIN_1X,    4,    4},  //   9.6 ms
+    {GY33_GAIN_4X,    4,   16},
+    {GY33_GAIN_16X,   4,   64},
+    {GY33_GAIN_60X,   4,  240},
+    {GY33_GAIN_60X,  11,  660},  //  26.4 ms
+    {GY33_GAIN_60X,  42, 2520},  // 100.8 ms
+    {GY33_GAIN_60X, 100, 6000},  // 240.0 ms
+};
+#define GY33_EXPOSURE_STEPS (sizeof(gy33_exposures) / sizeof(gy33_exposures[0]))
+
+static volatile uint8_t gy33_step = GY33_AE_DEFAULT_STEP;
+static bool gy33_auto_exposure = true;
+static volatile bool gy33_discard;        // Next cycle may mix old and new settings
+static uint8_t gy33_cfg_buf[2][2];
+static i2c_async_txn_t gy33_cfg_txn[2];
+
+static inline uint32_t gy33_full_scale(uint8_t step) {
+    uint32_t fs = (uint32_t)gy33_exposures[step].cycles * 1024;
+    return fs > 65535 ? 65535 : fs;
+}
+
+static inline uint32_t gy33_integration_us(uint8_t step) {
+    return (uint32_t)gy33_exposures[step].cycles * GY33_CYCLE_US;
+}
+
+// Counts at step 'to' expected for a reading of 'clear' taken at step 'from'
+static inline uint32_t gy33_project(uint16_t clear, uint8_t from, uint8_t to) {
+    return (uint32_t)clear * gy33_exposures[to].sensitivity / gy33_exposures[from].sensitivity;
+}
+
+// Picks the exposure for the next cycle from the clear channel. The current
+// step is kept while it has at least half the target counts, is not close to
+// saturation and a shorter step would not also give twice the target; this
+// band keeps it from oscillating between neighbours.
+static uint8_t gy33_select_exposure(uint8_t step, uint16_t clear) {
+    uint32_t fs = gy33_full_scale(step);
+
+    // Saturated: the real level is unknown, back off one step
+    if (clear >= fs * 9 / 10)
+        return step > 0 ? step - 1 : 0;
+
+    if (clear >= GY33_AE_TARGET_COUNTS / 2 &&
+        (step == 0 || gy33_project(clear, step, step - 1) < 2 * GY33_AE_TARGET_COUNTS))
+        return step;
+
+    // Shortest step that reaches the target without getting near full scale
+    for (uint8_t i = 0; i < GY33_EXPOSURE_STEPS; i++) {
+        uint32_t projected = gy33_project(clear, step, i);
+        if (projected >= GY33_AE_TARGET_COUNTS && projected < gy33_full_scale(i) * 3 / 4)
+            return i;
+    }
+    return gy33_project(clear, step, 0) >= GY33_AE_TARGET_COUNTS ? 0 : GY33_EXPOSURE_STEPS - 1;
+}
+
+// Scales raw counts of the given step to the reference exposure. The
+// reference is the most sensitive step, so the factor is never below 1 and
+// 65535 * 6000 still fits in 32 bits.
+static inline uint32_t gy33_normalize(uint16_t raw, uint8_t step) {
+    return (uint32_t)raw * GY33_REF_SENSITIVITY / gy33_exposures[step].sensitivity;
+}
+
+static void gy33_queue_write(i2c_async_txn_t *txn, uint8_t *buf, uint8_t reg, uint8_t value) {
+    buf[0] = reg;
+    buf[1] = value;
+    txn->addr = GY33_I2C_ADDR;
+    txn->tx = buf;
+    txn->tx_len = 2;
+    txn->rx_len = 0;
+    i2c_async_submit(txn);
+}
+
+// Queues the ATIME/CONTROL writes for a step (safe from the I2C callback)
+static void gy33_apply_exposure(uint8_t step) {
+    gy33_step = step;
+    gy33_queue_write(&gy33_cfg_txn[0], gy33_cfg_buf[0], ATIME_REG, 256 - gy33_exposures[step].cycles);
+    gy33_queue_write(&gy33_cfg_txn[1], gy33_cfg_buf[1], CONTROL_REG, gy33_exposures[step].gain);
+    gy33_discard = true;
+}
+
 void gy33_write_register(uint8_t reg, uint8_t value) {
     uint8_t buffer[2] = {reg, value};
-    i2c_write_blocking(I2C_PORT_SHARED, GY33_I2C_ADDR, buffer, 2, false);
+    i2c_async_txn_t txn = {
+        .addr = GY33_I2C_ADDR,
+        .tx = buffer,
+        .tx_len = 2,
+    };
+    i2c_async_transfer_blocking(&txn);
 }
 
 uint16_t gy33_read_register(uint8_t reg) {
-    uint8_t buffer[2];
-    i2c_write_blocking(I2C_PORT_SHARED, GY33_I2C_ADDR, &reg, 1, true);
-    i2c_read_blocking(I2C_PORT_SHARED, GY33_I2C_ADDR, buffer, 2, false);
+    uint8_t buffer[2] = {0, 0};
+    i2c_async_txn_t txn = {
+        .addr = GY33_I2C_ADDR,
+        .tx = &reg,
+        .tx_len = 1,
+        .rx = buffer,
+        .rx_len = 2,
+    };
+    i2c_async_transfer_blocking(&txn);
     return (buffer[1] << 8) | buffer[0];
 }
 
+// Sets the step gy33_init() starts from (e.g. restored from flash), so the
+// first integration already uses it. Call before gy33_init().
+void gy33_preset_exposure_step(uint8_t step) {
+    if (step < GY33_EXPOSURE_STEPS)
+        gy33_step = step;
+}
+
 void gy33_init() {
-    gy33_write_register(ENABLE_REG, 0x03);
-    gy33_write_register(ATIME_REG, 0xF5);
-    gy33_write_register(CONTROL_REG, 0x00);
+    gy33_write_register(ENABLE_REG, GY33_ENABLE_PON | GY33_ENABLE_AEN | GY33_ENABLE_AIEN);
+    gy33_write_register(ATIME_REG, 256 - gy33_exposures[gy33_step].cycles);
+    gy33_write_register(CONTROL_REG, gy33_exposures[gy33_step].gain);
+    gy33_write_register(PERS_REG, 0x00);
+    gy33_ready_at = make_timeout_time_us(gy33_integration_us(gy33_step));
+}
+
+static void gy33_burst_done(i2c_async_txn_t *txn) {
+    uint8_t status = gy33_burst_rx[0];
+
+    if (txn->status != I2C_ASYNC_DONE || !(status & GY33_STATUS_AVALID) || !(status & GY33_STATUS_AINT)) {
+        gy33_ready_at = make_timeout_time_us(GY33_RETRY_US);
+        return;
+    }
+
+    uint8_t step = gy33_step;
+    if (gy33_discard) {
+        // First cycle after an exposure change: drop it
+        gy33_discard = false;
+    } else {
+        uint16_t raw[4];
+        for (uint8_t i = 0; i < 4; i++) {
+            raw[i] = (gy33_burst_rx[2 + 2 * i] << 8) | gy33_burst_rx[1 + 2 * i];
+            gy33_last[i] = gy33_normalize(raw[i], step);
+        }
+        gy33_sampled_at = get_absolute_time();
+        gy33_fresh = true;
+
+        if (gy33_auto_exposure) {
+            uint8_t next = gy33_select_exposure(step, raw[0]);
+            if (next != step) {
+                gy33_apply_exposure(next);
+                step = next;
+            }
+        }
+    }
+    gy33_ready_at = make_timeout_time_us(gy33_integration_us(step));
+
+    // Acknowledge this cycle so the next AINT marks a new integration
+    gy33_clear_txn.addr = GY33_I2C_ADDR;
+    gy33_clear_txn.tx = &gy33_clear_int_cmd;
+    gy33_clear_txn.tx_len = 1;
+    gy33_clear_txn.rx_len = 0;
+    i2c_async_submit(&gy33_clear_txn);
+}
+
+// Queues the burst read if a new integration is due. Returns false if a
+// request is still in flight or the current integration has not ended.
+bool gy33_request_color() {
+    if (gy33_color_pending() || !time_reached(gy33_ready_at))
+        return false;
+
+    gy33_burst_txn.addr = GY33_I2C_ADDR;
+    gy33_burst_txn.tx = &gy33_burst_cmd;
+    gy33_burst_txn.tx_len = 1;
+    gy33_burst_txn.rx = gy33_burst_rx;
+    gy33_burst_txn.rx_len = sizeof(gy33_burst_rx);
+    gy33_burst_txn.callback = gy33_burst_done;
+    return i2c_async_submit(&gy33_burst_txn);
 }
 
-void gy33_read_color(uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *c) {
-    *c = gy33_read_register(CDATA_REG);
-    *r = gy33_read_register(RDATA_REG);
-    *g = gy33_read_register(GDATA_REG);
-    *b = gy33_read_register(BDATA_REG);
-}
\ No newline at end of file
+bool gy33_color_pending() {
+    return gy33_burst_txn.status == I2C_ASYNC_PENDING ||
+           gy33_clear_txn.status == I2C_ASYNC_PENDING ||
+           gy33_cfg_txn[0].status == I2C_ASYNC_PENDING ||
+           gy33_cfg_txn[1].status == I2C_ASYNC_PENDING;
+}
+
+// Fills the outputs with the latest sample and returns true if it is fresh,
+// i.e. from an integration not reported before. Never blocks.
+bool gy33_poll_color(uint32_t *r, uint32_t *g, uint32_t *b, uint32_t *c) {
+    uint32_t save = save_and_disable_interrupts(); // Channels must come from one callback
+    bool fresh = gy33_fresh;
+    gy33_fresh = false;
+    *c = gy33_last[0];
+    *r = gy33_last[1];
+    *g = gy33_last[2];
+    *b = gy33_last[3];
+    restore_interrupts(save);
+    return fresh;
+}
+
+absolute_time_t gy33_sample_time() {
+    return gy33_sampled_at;
+}
+
+void gy33_set_auto_exposure(bool enabled) {
+    gy33_auto_exposure = enabled;
+}
+
+uint8_t gy33_exposure_step_count() {
+    return GY33_EXPOSURE_STEPS;
+}
+
+uint8_t gy33_get_exposure_step() {
+    return gy33_step;
+}
+
+// Selects a fixed exposure step (e.g. restored at boot). Call between samples.
+void gy33_set_exposure_step(uint8_t step) {
+    if (step >= GY33_EXPOSURE_STEPS || gy33_color_pending())
+        return;
+    gy33_apply_exposure(step);
+    gy33_ready_at = make_timeout_time_us(gy33_integration_us(step));
+}
+
+void gy33_get_exposure(uint8_t *gain, uint8_t *atime) {
+    *gain = gy33_exposures[gy33_step].gain;
+    *atime = 256 - gy33_exposures[gy33_step].cycles;
+}
+
+// Blocks until a fresh sample is available.
+void gy33_read_color(uint32_t *r, uint32_t *g, uint32_t *b, uint32_t *c) {
+    while (!gy33_poll_color(r, g, b, c)) {
+        gy33_request_color();
+        tight_loop_contents();
+    }
+}
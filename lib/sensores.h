@@ -3,6 +3,7 @@
 
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "i2c_async.h"
 
 // I2C Port and Pins
 #define I2C_PORT_SHARED i2c0
@@ -13,23 +14,77 @@
 #define GY33_I2C_ADDR 0x29
 #define ENABLE_REG 0x80
 #define ATIME_REG 0x81
+#define PERS_REG 0x8C
 #define CONTROL_REG 0x8F
+#define STATUS_REG 0x93
 #define CDATA_REG 0x94
 #define RDATA_REG 0x96
 #define GDATA_REG 0x98
 #define BDATA_REG 0x9A
+#define GY33_CMD_AUTO_INC 0x20     // Command type: auto-increment burst
+#define GY33_CMD_CLEAR_INT 0xE6    // Special function: clear RGBC interrupt
+#define GY33_ENABLE_PON 0x01
+#define GY33_ENABLE_AEN 0x02
+#define GY33_ENABLE_AIEN 0x10
+#define GY33_STATUS_AVALID 0x01    // An integration cycle has completed
+#define GY33_STATUS_AINT 0x10      // RGBC interrupt (set every cycle with PERS = 0)
+#define GY33_CYCLE_US 2400         // One ATIME integration cycle
+#define GY33_RETRY_US 2400         // Poll interval while waiting for a cycle to finish
+
+// GY-33 auto-exposure. Counts are normalized to the most sensitive step
+// (60x gain, 100 cycles), so raw counts of every step map to at least one
+// published count and dim scenes keep their full resolution. That needs
+// 23 bits (up to GY33_COUNTS_MAX), hence 32-bit channels. GY33_COUNTS_1X11
+// and GY33_TO_1X11 convert from and to counts of the fixed exposure used
+// before (1x gain, ATIME 0xF5 = 11 cycles), which downstream thresholds and
+// the display were tuned for.
+#define GY33_GAIN_1X 0x00
+#define GY33_GAIN_4X 0x01
+#define GY33_GAIN_16X 0x02
+#define GY33_GAIN_60X 0x03
+#define GY33_REF_SENSITIVITY 6000      // gain x cycles of the reference exposure (last step)
+#define GY33_COUNTS_MAX (1024u * GY33_REF_SENSITIVITY) // Full scale at 1x gain, normalized
+#define GY33_COUNTS_1X11(n) ((uint32_t)(n) * GY33_REF_SENSITIVITY / 11)
+#define GY33_TO_1X11(counts) ((uint32_t)(counts) * 11 / GY33_REF_SENSITIVITY)
+#define GY33_AE_TARGET_COUNTS 1024     // Minimum clear counts considered "enough"
+#define GY33_AE_DEFAULT_STEP 2
 
 // BH1750 Sensor Definitions
 #define BH1750_I2C_ADDR 0x23
 #define _POWER_ON_C 0x01
 #define _CONT_HRES_C 0x10
+#define _ONE_TIME_LRES_C 0x23
+#define BH1750_CONV_TIME_MS 180 // Max H-resolution conversion time (datasheet)
+#define BH1750_LRES_TIME_MS 24  // Max L-resolution conversion time (4 lx steps)
+
+// BH1750 driver states
+typedef enum {
+    BH1750_STATE_OFF,        // Not powered / not configured
+    BH1750_STATE_CONVERTING, // Measurement started, first conversion pending
+    BH1750_STATE_RUNNING     // At least one conversion available
+} bh1750_state_t;
 
 // Function prototypes for BH1750
 void bh1750_power_on();
+void bh1750_start();
+bool bh1750_poll(uint16_t *lux);
+absolute_time_t bh1750_sample_ready_at();
+absolute_time_t bh1750_sample_time();
+bh1750_state_t bh1750_get_state();
 uint16_t bh1750_read_measurement();
 
 // Function prototypes for GY-33
+void gy33_preset_exposure_step(uint8_t step);
 void gy33_init();
-void gy33_read_color(uint16_t *r, uint16_t *g, uint16_t *b, uint16_t *c);
+bool gy33_request_color();
+bool gy33_color_pending();
+bool gy33_poll_color(uint32_t *r, uint32_t *g, uint32_t *b, uint32_t *c);
+absolute_time_t gy33_sample_time();
+void gy33_set_auto_exposure(bool enabled);
+uint8_t gy33_exposure_step_count();
+uint8_t gy33_get_exposure_step();
+void gy33_set_exposure_step(uint8_t step);
+void gy33_get_exposure(uint8_t *gain, uint8_t *atime);
+void gy33_read_color(uint32_t *r, uint32_t *g, uint32_t *b, uint32_t *c);
 
 #endif // SENSORES_H
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "ssd1306.h"
 #include "font.h"
+#include <string.h>
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
   ssd->width = width;
@@ -11,34 +12,56 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->shadow = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->flush_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->flush_buffer[0] = 0x40;
+  ssd1306_invalidate(ssd);
 }
 
+static void ssd1306_clear_dirty(ssd1306_t *ssd) {
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    ssd->dirty_min[p] = 0xFF;
+    ssd->dirty_max[p] = 0;
+  }
+}
+
+static inline void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1) {
+  if (x0 < ssd->dirty_min[page])
+    ssd->dirty_min[page] = x0;
+  if (x1 > ssd->dirty_max[page])
+    ssd->dirty_max[page] = x1;
+}
+
+// Força o próximo ssd1306_send_data() a enviar o framebuffer inteiro
+// (conteúdo do painel desconhecido, após config ou reset).
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  ssd->full_refresh = true;
+  ssd1306_clear_dirty(ssd);
+}
+
+// Sequência de inicialização, enviada em uma única transação
+static const uint8_t ssd1306_init_sequence[] = {
+  SET_DISP | 0x00,
+  SET_MEM_ADDR, 0x01,
+  SET_DISP_START_LINE | 0x00,
+  SET_SEG_REMAP | 0x01,
+  SET_MUX_RATIO, HEIGHT - 1,
+  SET_COM_OUT_DIR | 0x08,
+  SET_DISP_OFFSET, 0x00,
+  SET_COM_PIN_CFG, 0x12,
+  SET_DISP_CLK_DIV, 0x80,
+  SET_PRECHARGE, 0xF1,
+  SET_VCOM_DESEL, 0x30,
+  SET_CONTRAST, 0xFF,
+  SET_ENTIRE_ON,
+  SET_NORM_INV,
+  SET_CHARGE_PUMP, 0x14,
+  SET_DISP | 0x01
+};
+
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
+  ssd1306_command_list(ssd, ssd1306_init_sequence, sizeof(ssd1306_init_sequence));
+  ssd1306_invalidate(ssd);
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
@@ -52,13 +75,30 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   );
 }
 
-void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
+// Envia vários comandos em uma transação: byte de controle 0x00 (Co = 0)
+// seguido da lista de comandos.
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t len) {
+  uint8_t buffer[SSD1306_CMD_LIST_MAX + 1];
+  buffer[0] = 0x00;
+  while (len) {
+    size_t chunk = len > SSD1306_CMD_LIST_MAX ? SSD1306_CMD_LIST_MAX : len;
+    memcpy(buffer + 1, commands, chunk);
+    i2c_write_blocking(ssd->i2c_port, ssd->address, buffer, chunk + 1, false);
+    commands += chunk;
+    len -= chunk;
+  }
+}
+
+static void ssd1306_set_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  const uint8_t window[] = {
+    SET_COL_ADDR, x0, x1,
+    SET_PAGE_ADDR, p0, p1
+  };
+  ssd1306_command_list(ssd, window, sizeof(window));
+}
+
+static void ssd1306_send_full(ssd1306_t *ssd) {
+  ssd1306_set_window(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
   i2c_write_blocking(
     ssd->i2c_port,
     ssd->address,
@@ -66,135 +106,371 @@ void ssd1306_send_data(ssd1306_t *ssd) {
     ssd->bufsize,
     false
   );
+  memcpy(ssd->shadow, ssd->ram_buffer, ssd->bufsize);
+  ssd->full_refresh = false;
+  ssd1306_clear_dirty(ssd);
 }
 
+static void ssd1306_send_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  uint8_t rows = p1 - p0 + 1;
+  uint8_t *dst = ssd->flush_buffer + 1;
+
+  // Modo de endereçamento vertical: a janela é percorrida coluna a coluna
+  for (uint8_t x = x0; x <= x1; ++x) {
+    uint8_t *src = ssd->ram_buffer + 1 + x * ssd->pages + p0;
+    memcpy(dst, src, rows);
+    memcpy(ssd->shadow + 1 + x * ssd->pages + p0, src, rows);
+    dst += rows;
+  }
+
+  ssd1306_set_window(ssd, x0, x1, p0, p1);
+  i2c_write_blocking(
+    ssd->i2c_port,
+    ssd->address,
+    ssd->flush_buffer,
+    dst - ssd->flush_buffer,
+    false
+  );
+}
+
+// Envia apenas as regiões que mudaram desde o último flush.
+// As faixas marcadas como sujas são recortadas contra o conteúdo já enviado,
+// então redesenhar o mesmo conteúdo não gera tráfego no barramento. Escolhe
+// entre uma janela única (retângulo envolvente), uma janela por página ou o
+// quadro inteiro, conforme o que colocar menos bytes no barramento.
+void ssd1306_send_data(ssd1306_t *ssd) {
+  if (ssd->full_refresh) {
+    ssd1306_send_full(ssd);
+    return;
+  }
+
+  uint8_t lo[SSD1306_MAX_PAGES], hi[SSD1306_MAX_PAGES];
+  uint8_t x0 = 0xFF, x1 = 0, p0 = 0xFF, p1 = 0;
+  size_t per_page_cost = 0;
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    uint8_t l = ssd->dirty_min[p], h = ssd->dirty_max[p];
+    while (l <= h && ssd->ram_buffer[1 + l * ssd->pages + p] == ssd->shadow[1 + l * ssd->pages + p])
+      ++l;
+    while (h > l && ssd->ram_buffer[1 + h * ssd->pages + p] == ssd->shadow[1 + h * ssd->pages + p])
+      --h;
+    lo[p] = l;
+    hi[p] = h;
+    if (l > h)
+      continue;
+    per_page_cost += SSD1306_WINDOW_COST + (h - l + 1);
+    if (l < x0) x0 = l;
+    if (h > x1) x1 = h;
+    if (p < p0) p0 = p;
+    p1 = p;
+  }
+  ssd1306_clear_dirty(ssd);
+
+  if (p0 == 0xFF)
+    return;
+
+  size_t box_cost = SSD1306_WINDOW_COST + (size_t)(x1 - x0 + 1) * (p1 - p0 + 1);
+  size_t full_cost = SSD1306_WINDOW_COST + ssd->bufsize - 1;
+
+  if (full_cost <= box_cost && full_cost <= per_page_cost) {
+    ssd1306_send_full(ssd);
+  } else if (box_cost <= per_page_cost) {
+    ssd1306_send_window(ssd, x0, x1, p0, p1);
+  } else {
+    for (uint8_t p = p0; p <= p1; ++p)
+      if (lo[p] <= hi[p])
+        ssd1306_send_window(ssd, lo[p], hi[p], p, p);
+  }
+}
+
+static void ssd1306_mark_dirty_rect(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y0, uint8_t y1) {
+  for (uint8_t p = y0 >> 3; p <= (y1 >> 3); ++p)
+    ssd1306_mark_dirty(ssd, p, x0, x1);
+}
+
+// Escreve o bit de (x, y) no byte de página correspondente.
+// Layout do ram_buffer (endereçamento vertical): 1 + x * pages + y / 8.
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint16_t index = (y >> 3) + x * ssd->pages + 1;
   uint8_t pixel = (y & 0b111);
+  ssd1306_mark_dirty(ssd, y >> 3, x, x);
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
   else
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// Preenche os pixels y0..y1 da coluna x. No endereçamento vertical as páginas
+// de uma coluna são bytes consecutivos: só a primeira e a última recebem
+// escrita mascarada, as do meio são sobrescritas inteiras.
+// Coordenadas já recortadas e y0 <= y1.
+static void ssd1306_span(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+  uint8_t *col = ssd->ram_buffer + 1 + x * ssd->pages;
+  uint8_t p0 = y0 >> 3, p1 = y1 >> 3;
+  uint8_t first = 0xFF << (y0 & 7);
+  uint8_t last = 0xFF >> (7 - (y1 & 7));
 
+  if (p0 == p1) {
+    first &= last;
+    col[p0] = value ? (col[p0] | first) : (col[p0] & ~first);
+    return;
+  }
+
+  col[p0] = value ? (col[p0] | first) : (col[p0] & ~first);
+  memset(col + p0 + 1, value ? 0xFF : 0x00, p1 - p0 - 1);
+  col[p1] = value ? (col[p1] | last) : (col[p1] & ~last);
+}
+
+// memset direto no framebuffer (a versão anterior por pixel fazia 8192 chamadas)
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
+  ssd1306_mark_dirty_rect(ssd, 0, ssd->width - 1, 0, ssd->height - 1);
 }
 
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  if (width == 0 || height == 0 || left >= ssd->width || top >= ssd->height)
+    return;
 
+  uint16_t right = left + width - 1;
+  uint16_t bottom = top + height - 1;
 
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
+  if (!fill) {
+    ssd1306_hline(ssd, left, right > 0xFF ? 0xFF : right, top, value);
+    if (bottom < ssd->height)
+      ssd1306_hline(ssd, left, right > 0xFF ? 0xFF : right, bottom, value);
+    ssd1306_vline(ssd, left, top, bottom > 0xFF ? 0xFF : bottom, value);
+    if (right < ssd->width)
+      ssd1306_vline(ssd, right, top, bottom > 0xFF ? 0xFF : bottom, value);
+    return;
   }
 
-  if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
-  }
+  // Preenchido: borda e interior têm o mesmo valor, então é um span por coluna
+  if (right >= ssd->width)
+    right = ssd->width - 1;
+  if (bottom >= ssd->height)
+    bottom = ssd->height - 1;
+  for (uint8_t x = left; x <= right; ++x)
+    ssd1306_span(ssd, x, top, bottom, value);
+  ssd1306_mark_dirty_rect(ssd, left, right, top, bottom);
 }
 
+// Bresenham percorrendo o framebuffer por índice de byte e máscara de bit,
+// sem recalcular o endereço a cada pixel.
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
-    int dx = abs(x1 - x0);
-    int dy = abs(y1 - y0);
-
-    int sx = (x0 < x1) ? 1 : -1;
-    int sy = (y0 < y1) ? 1 : -1;
+  if (y0 == y1) {
+    ssd1306_hline(ssd, x0 < x1 ? x0 : x1, x0 < x1 ? x1 : x0, y0, value);
+    return;
+  }
+  if (x0 == x1) {
+    ssd1306_vline(ssd, x0, y0 < y1 ? y0 : y1, y0 < y1 ? y1 : y0, value);
+    return;
+  }
 
-    int err = dx - dy;
+  int dx = abs(x1 - x0);
+  int dy = abs(y1 - y0);
+  int sx = (x0 < x1) ? 1 : -1;
+  int sy = (y0 < y1) ? 1 : -1;
+  int err = dx - dy;
 
-    while (true) {
-        ssd1306_pixel(ssd, x0, y0, value); // Desenha o pixel atual
+  int x = x0, y = y0;
+  int index = 1 + x * ssd->pages + (y >> 3);
+  int step_x = sx * ssd->pages;
+  uint8_t mask = 1 << (y & 7);
 
-        if (x0 == x1 && y0 == y1) break; // Termina quando alcança o ponto final
+  while (true) {
+    if (x < ssd->width && y < ssd->height) {
+      if (value)
+        ssd->ram_buffer[index] |= mask;
+      else
+        ssd->ram_buffer[index] &= ~mask;
+    }
 
-        int e2 = err * 2;
+    if (x == x1 && y == y1)
+      break;
 
-        if (e2 > -dy) {
-            err -= dy;
-            x0 += sx;
+    int e2 = err * 2;
+    if (e2 > -dy) {
+      err -= dy;
+      x += sx;
+      index += step_x;
+    }
+    if (e2 < dx) {
+      err += dx;
+      y += sy;
+      if (sy > 0) {
+        mask <<= 1;
+        if (!mask) {
+          mask = 0x01;
+          ++index;
         }
-
-        if (e2 < dx) {
-            err += dx;
-            y0 += sy;
+      } else {
+        mask >>= 1;
+        if (!mask) {
+          mask = 0x80;
+          --index;
         }
+      }
     }
-}
+  }
 
+  uint8_t xa = x0 < x1 ? x0 : x1, xb = x0 < x1 ? x1 : x0;
+  uint8_t ya = y0 < y1 ? y0 : y1, yb = y0 < y1 ? y1 : y0;
+  if (xa >= ssd->width || ya >= ssd->height)
+    return;
+  if (xb >= ssd->width)
+    xb = ssd->width - 1;
+  if (yb >= ssd->height)
+    yb = ssd->height - 1;
+  ssd1306_mark_dirty_rect(ssd, xa, xb, ya, yb);
+}
 
+// Linha horizontal: mesmo bit em bytes separados por 'pages' posições
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  if (y >= ssd->height || x0 >= ssd->width || x0 > x1)
+    return;
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+
+  uint8_t *byte = ssd->ram_buffer + 1 + x0 * ssd->pages + (y >> 3);
+  uint8_t mask = 1 << (y & 7);
+  uint8_t count = x1 - x0 + 1;
+  if (value) {
+    for (; count; --count, byte += ssd->pages)
+      *byte |= mask;
+  } else {
+    mask = ~mask;
+    for (; count; --count, byte += ssd->pages)
+      *byte &= mask;
+  }
+  ssd1306_mark_dirty(ssd, y >> 3, x0, x1);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  if (x >= ssd->width || y0 >= ssd->height || y0 > y1)
+    return;
+  if (y1 >= ssd->height)
+    y1 = ssd->height - 1;
+  ssd1306_span(ssd, x, y0, y1, value);
+  ssd1306_mark_dirty_rect(ssd, x, x, y0, y1);
+}
+
+// --- Texto ---
+// Os glifos já estão no formato do framebuffer (uma coluna por byte, bit 0
+// no topo), então desenhar é copiar colunas: com y múltiplo de 8 cada coluna
+// é um byte inteiro; senão ela se divide entre duas páginas com máscara.
+// Os caracteres são opacos (apagam o fundo da célula).
+
+// Ampliação dos dígitos em tempo de compilação: cada bit da coluna vira
+// `s` bits, e cada coluna é repetida `s` vezes no desenho.
+#define SSD1306_XBIT(b, k, s) ((((b) >> (k)) & 1u) * (((1u << (s)) - 1u) << ((k) * (s))))
+#define SSD1306_XCOL(b, s) (SSD1306_XBIT(b, 0, s) | SSD1306_XBIT(b, 1, s) | SSD1306_XBIT(b, 2, s) | \
+                            SSD1306_XBIT(b, 3, s) | SSD1306_XBIT(b, 4, s) | SSD1306_XBIT(b, 5, s) | \
+                            SSD1306_XBIT(b, 6, s) | SSD1306_XBIT(b, 7, s))
+#define SSD1306_XGLYPH_(s, a, b, c, d, e, f, g, h) \
+  { SSD1306_XCOL(a, s), SSD1306_XCOL(b, s), SSD1306_XCOL(c, s), SSD1306_XCOL(d, s), \
+    SSD1306_XCOL(e, s), SSD1306_XCOL(f, s), SSD1306_XCOL(g, s), SSD1306_XCOL(h, s) }
+#define SSD1306_XGLYPH(s, glyph) SSD1306_XGLYPH_(s, glyph)
+#define SSD1306_XDIGITS(s) { \
+  SSD1306_XGLYPH(s, FONT_GLYPH_0), SSD1306_XGLYPH(s, FONT_GLYPH_1), SSD1306_XGLYPH(s, FONT_GLYPH_2), \
+  SSD1306_XGLYPH(s, FONT_GLYPH_3), SSD1306_XGLYPH(s, FONT_GLYPH_4), SSD1306_XGLYPH(s, FONT_GLYPH_5), \
+  SSD1306_XGLYPH(s, FONT_GLYPH_6), SSD1306_XGLYPH(s, FONT_GLYPH_7), SSD1306_XGLYPH(s, FONT_GLYPH_8), \
+  SSD1306_XGLYPH(s, FONT_GLYPH_9) }
+
+static const uint16_t font_digits_x2[10][8] = SSD1306_XDIGITS(2); // 16 pixels por coluna
+static const uint32_t font_digits_x3[10][8] = SSD1306_XDIGITS(3); // 24 pixels por coluna
+
+// Copia uma coluna de `rows` pixels (bits 0..rows-1, rows <= 24) para (x, y),
+// recortando o que passa da última página. Coordenadas já validadas.
+static inline void ssd1306_blit_column(ssd1306_t *ssd, uint8_t x, uint8_t y, uint32_t bits, uint8_t rows) {
+  uint8_t *col = ssd->ram_buffer + 1 + x * ssd->pages;
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 7;
+  uint32_t mask = ((1u << rows) - 1u) << shift;
+
+  bits <<= shift;
+  for (; mask && page < ssd->pages; ++page, bits >>= 8, mask >>= 8)
+    col[page] = (col[page] & ~mask) | (uint8_t)bits;
 }
 
-// Função para desenhar um caractere
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
-  uint16_t index = 0;
+  if (x >= ssd->width || y >= ssd->height)
+    return;
 
-  // Verifica o caractere e calcula o índice correspondente na fonte
-  if (c >= ' ' && c <= '~') // Verifica se o caractere está na faixa ASCII válida
-  {
-    index = (c - ' ') * 8; // Calcula o índice baseado na posição do caractere na tabela ASCII
-  }
-  else
-  {
-    // Caractere inválido, desenha um espaço (ou pode ser tratado de outra forma)
-    index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
-  }
+  // Caractere fora da faixa ASCII da fonte vira espaço (índice 0)
+  const uint8_t *glyph = font + ((c >= ' ' && c <= '~') ? (c - ' ') * 8 : 0);
+  uint8_t w = (ssd->width - x < 8) ? ssd->width - x : 8;
+  uint8_t *col = ssd->ram_buffer + 1 + x * ssd->pages + (y >> 3);
+  uint8_t shift = y & 7;
 
-  // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
-  {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
+  if (!shift) {
+    // Alinhado: um byte por coluna
+    for (uint8_t i = 0; i < w; ++i, col += ssd->pages)
+      *col = glyph[i];
+  } else {
+    // Desalinhado: parte baixa do glifo no fim da página y/8, resto no início da seguinte
+    bool second = (y >> 3) + 1 < ssd->pages;
+    uint8_t keep_lo = 0xFF >> (8 - shift);
+    uint8_t keep_hi = 0xFF << shift;
+    for (uint8_t i = 0; i < w; ++i, col += ssd->pages) {
+      col[0] = (col[0] & keep_lo) | (uint8_t)(glyph[i] << shift);
+      if (second)
+        col[1] = (col[1] & keep_hi) | (glyph[i] >> (8 - shift));
     }
   }
+
+  uint8_t bottom = (ssd->height - y < 8) ? ssd->height - 1 : y + 7;
+  ssd1306_mark_dirty_rect(ssd, x, x + w - 1, y, bottom);
 }
 
-// Função para desenhar uma string
+// Desenha uma string, quebrando a linha quando o próximo caractere não cabe
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
 {
   while (*str)
   {
-    ssd1306_draw_char(ssd, *str++, x, y);
-    x += 8;
-    if (x + 8 >= ssd->width)
+    if (x + 8 > ssd->width)
     {
       x = 0;
       y += 8;
     }
-    if (y + 8 >= ssd->height)
+    if (y + 8 > ssd->height)
     {
       break;
     }
+    ssd1306_draw_char(ssd, *str++, x, y);
+    x += 8;
+  }
+}
+
+// Dígitos ampliados 2x ou 3x a partir das tabelas pré-expandidas; outros
+// caracteres viram espaço (apagam a célula). Escala 1 usa a fonte normal.
+// Não quebra linha: o que passa da borda é recortado.
+void ssd1306_draw_string_scaled(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y, uint8_t scale)
+{
+  if (scale <= 1) {
+    ssd1306_draw_string(ssd, str, x, y);
+    return;
+  }
+  if (scale > 3 || y >= ssd->height)
+    return;
+
+  uint8_t rows = 8 * scale;
+  uint16_t x0 = x;
+  for (; *str && x < ssd->width; ++str) {
+    char c = *str;
+    bool digit = c >= '0' && c <= '9';
+    for (uint8_t i = 0; i < 8; ++i) {
+      uint32_t bits = 0;
+      if (digit)
+        bits = (scale == 2) ? font_digits_x2[c - '0'][i] : font_digits_x3[c - '0'][i];
+      for (uint8_t r = 0; r < scale && x < ssd->width; ++r, ++x)
+        ssd1306_blit_column(ssd, x, y, bits, rows);
+    }
   }
-}
\ No newline at end of file
+
+  if (x > x0) {
+    uint16_t bottom = y + rows - 1;
+    ssd1306_mark_dirty_rect(ssd, x0, x - 1, y, bottom >= ssd->height ? ssd->height - 1 : bottom);
+  }
+}
@@ -1,9 +1,18 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 
 #define WIDTH 128
 #define HEIGHT 64
+#define SSD1306_MAX_PAGES 8
+#define SSD1306_WINDOW_CMDS 6   // SET_COL_ADDR x0 x1 SET_PAGE_ADDR p0 p1
+// Bytes no barramento de uma janela além dos dados: a transação de comandos
+// (endereço + controle + 6 comandos) e a abertura da de dados (endereço + controle)
+#define SSD1306_WINDOW_COST ((2 + SSD1306_WINDOW_CMDS) + 2)
+#define SSD1306_CMD_LIST_MAX 32 // Comandos por transação em ssd1306_command_list()
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -32,12 +41,19 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  uint8_t *shadow;                        // Conteúdo enviado no último flush
+  uint8_t *flush_buffer;                  // Buffer de montagem para janelas parciais
+  uint8_t dirty_min[SSD1306_MAX_PAGES];   // Faixa de colunas alterada por página
+  uint8_t dirty_max[SSD1306_MAX_PAGES];   // (min > max indica página limpa)
+  bool full_refresh;
 } ssd1306_t;
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t len);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_invalidate(ssd1306_t *ssd);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -46,4 +62,7 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+void ssd1306_draw_string_scaled(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y, uint8_t scale);
+
+#endif // SSD1306_H
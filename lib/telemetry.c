@@ -0,0 +1,157 @@
+#include "telemetry.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+#define TELEMETRY_RING_MASK (TELEMETRY_RING_SIZE - 1)
+
+static uint8_t ring[TELEMETRY_RING_SIZE];
+static volatile uint32_t ring_head; // Escrito pelos produtores, sob producer_lock
+static volatile uint32_t ring_tail; // Escrito apenas pelo consumidor
+static uint32_t frame_seq;
+static volatile uint32_t frames_dropped;
+static spin_lock_t *producer_lock; // seq, head e descartes entre os produtores
+
+void telemetry_init() {
+    if (!producer_lock)
+        producer_lock = spin_lock_init(spin_lock_claim_unused(true));
+    ring_head = 0;
+    ring_tail = 0;
+    frame_seq = 0;
+    frames_dropped = 0;
+}
+
+uint8_t telemetry_crc8(const uint8_t *data, uint32_t len) {
+    uint8_t crc = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+// COBS: cada bloco começa com a distância até o próximo zero (ou 0xFF para
+// 254 bytes sem zero), então a saída não contém 0x00. Retorna o tamanho
+// codificado, sem o delimitador.
+uint32_t telemetry_cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst) {
+    uint32_t code_pos = 0;
+    uint32_t out = 1;
+    uint8_t code = 1;
+
+    for (uint32_t i = 0; i < len; i++) {
+        if (src[i]) {
+            dst[out++] = src[i];
+            code++;
+        }
+        if (!src[i] || code == 0xFF) {
+            dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        }
+    }
+    dst[code_pos] = code;
+    return out;
+}
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+// Produtor: monta e enfileira um quadro; false se foi descartado.
+bool telemetry_send(uint8_t type, uint32_t time_us, const uint8_t *payload, uint8_t len) {
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    uint8_t encoded[TELEMETRY_MAX_ENCODED];
+
+    if (len > TELEMETRY_MAX_PAYLOAD)
+        return false;
+
+    // Só o seq depende da ordem entre os produtores: ele, o CRC e o COBS
+    // ficam dentro da trava
+    frame[0] = type;
+    put_u32(frame + 5, time_us);
+    memcpy(frame + TELEMETRY_HEADER_SIZE, payload, len);
+    uint32_t frame_len = TELEMETRY_HEADER_SIZE + len + 1;
+
+    uint32_t save = spin_lock_blocking(producer_lock);
+    put_u32(frame + 1, frame_seq++);
+    frame[frame_len - 1] = telemetry_crc8(frame, frame_len - 1);
+    uint32_t n = telemetry_cobs_encode(frame, frame_len, encoded);
+    encoded[n++] = 0x00;
+
+    uint32_t head = ring_head;
+    if (TELEMETRY_RING_SIZE - (head - ring_tail) < n) {
+        frames_dropped++;
+        spin_unlock(producer_lock, save);
+        return false;
+    }
+    uint32_t pos = head & TELEMETRY_RING_MASK;
+    uint32_t first = TELEMETRY_RING_SIZE - pos;
+    if (first > n)
+        first = n;
+    memcpy(ring + pos, encoded, first);
+    memcpy(ring, encoded + first, n - first);
+    __mem_fence_release(); // Bytes visíveis antes do novo head
+    ring_head = head + n;
+    spin_unlock(producer_lock, save);
+    return true;
+}
+
+bool telemetry_send_sample(const sensor_sample_t *sample) {
+    uint8_t payload[22];
+    put_u32(payload, sample->seq);
+    put_u32(payload + 4, sample->r);
+    put_u32(payload + 8, sample->g);
+    put_u32(payload + 12, sample->b);
+    put_u32(payload + 16, sample->c);
+    put_u16(payload + 20, sample->lux);
+    return telemetry_send(TELEMETRY_TYPE_SAMPLE, sample->timestamp_us, payload, sizeof(payload));
+}
+
+// Trecho de um bloco do log da flash; o host remonta pelo número do bloco
+bool telemetry_send_log_chunk(uint32_t time_us, uint16_t block, uint8_t chunk, const uint8_t *data) {
+    uint8_t payload[3 + TELEMETRY_LOG_CHUNK_SIZE];
+    put_u16(payload, block);
+    payload[2] = chunk;
+    memcpy(payload + 3, data, TELEMETRY_LOG_CHUNK_SIZE);
+    return telemetry_send(TELEMETRY_TYPE_LOG_CHUNK, time_us, payload, sizeof(payload));
+}
+
+// Bytes livres na fila (produtor): com TELEMETRY_MAX_ENCODED livres o
+// próximo quadro certamente cabe
+uint32_t telemetry_free() {
+    return TELEMETRY_RING_SIZE - (ring_head - ring_tail);
+}
+
+// Consumidor: entrega os bytes pendentes ao destino em até dois trechos
+// contíguos, parando quando ele não aceita mais. Retorna os bytes entregues.
+uint32_t telemetry_drain(telemetry_sink_t sink) {
+    uint32_t total = 0;
+    while (1) {
+        uint32_t tail = ring_tail;
+        uint32_t pending = ring_head - tail;
+        if (!pending)
+            break;
+        __mem_fence_acquire();
+        uint32_t pos = tail & TELEMETRY_RING_MASK;
+        uint32_t chunk = TELEMETRY_RING_SIZE - pos;
+        if (chunk > pending)
+            chunk = pending;
+        uint32_t n = sink(ring + pos, chunk);
+        if (!n)
+            break;
+        __mem_fence_release(); // Leitura concluída antes de liberar os bytes
+        ring_tail = tail + n;
+        total += n;
+    }
+    return total;
+}
+
+uint32_t telemetry_dropped() {
+    return frames_dropped;
+}
@@ -0,0 +1,54 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sample_ring.h"
+
+// Telemetria binária em quadros COBS terminados em 0x00, no lugar do printf
+// por amostra. Quem produz só codifica o quadro numa fila de bytes em RAM;
+// telemetry_drain() entrega o que couber ao destino (CDC USB) sem esperar.
+// Com a fila cheia o quadro inteiro é descartado e contado, nunca cortado.
+//
+// Quadro antes do COBS (little-endian):
+//   type     u8   TELEMETRY_TYPE_*
+//   seq      u32  Contador de quadros (inclui os descartados: lacuna = perda)
+//   time_us  u32  Instante do dado (time_us_32)
+//   payload  ...  Conforme o tipo
+//   crc      u8   CRC-8 (polinômio 0x07) de type..payload
+//
+// Decodificador no host: tools/telemetry_decode.py
+//
+// É a única saída do CDC USB: o texto do printf também vem por aqui, em
+// quadros TELEMETRY_TYPE_TEXT, para não se misturar aos bytes dos quadros.
+// Produtores em qualquer núcleo (telemetry_send serializa por uma trava de
+// spin) e um consumidor só.
+
+#define TELEMETRY_RING_SIZE 1024 // Potência de 2
+#define TELEMETRY_MAX_PAYLOAD 40
+#define TELEMETRY_HEADER_SIZE 9
+#define TELEMETRY_MAX_FRAME (TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + 1)
+#define TELEMETRY_MAX_ENCODED (TELEMETRY_MAX_FRAME + TELEMETRY_MAX_FRAME / 254 + 2) // COBS + delimitador
+
+#define TELEMETRY_TYPE_SAMPLE 0x01    // Payload: seq u32, r g b c u32, lux u16
+#define TELEMETRY_TYPE_TEXT 0x02      // Payload: trecho da saída do console (UTF-8, em qualquer ponto)
+#define TELEMETRY_TYPE_LOG_CHUNK 0x03 // Payload: bloco u16, trecho u8, 32 bytes do bloco (lib/flash_log.h)
+#define TELEMETRY_TYPE_LOG_END 0x04   // Payload: blocos enviados u16
+
+#define TELEMETRY_LOG_CHUNK_SIZE 32
+
+// Aceita até len bytes e retorna quantos aceitou (0 se o destino está cheio)
+typedef uint32_t (*telemetry_sink_t)(const uint8_t *data, uint32_t len);
+
+void telemetry_init();
+bool telemetry_send(uint8_t type, uint32_t time_us, const uint8_t *payload, uint8_t len);
+bool telemetry_send_sample(const sensor_sample_t *sample);
+bool telemetry_send_log_chunk(uint32_t time_us, uint16_t block, uint8_t chunk, const uint8_t *data);
+uint32_t telemetry_free();
+uint32_t telemetry_drain(telemetry_sink_t sink);
+uint32_t telemetry_dropped();
+
+uint8_t telemetry_crc8(const uint8_t *data, uint32_t len);
+uint32_t telemetry_cobs_encode(const uint8_t *src, uint32_t len, uint8_t *dst);
+
+#endif // TELEMETRY_H
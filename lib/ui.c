@@ -0,0 +1,121 @@
+#include "ui.h"
+#include <string.h>
+
+#define UI_CHAR_WIDTH 8
+
+static const uint32_t ui_limits[UI_MAX_DIGITS] = {
+    9, 99, 999, 9999, 99999, 999999, 9999999, 99999999, 999999999, UINT32_MAX,
+};
+
+void ui_init(ui_t *ui, ssd1306_t *ssd) {
+    ui->ssd = ssd;
+    ui->count = 0;
+    ui->drawn = false;
+}
+
+static int ui_add(ui_t *ui, const char *text, uint8_t digits, uint8_t x, uint8_t y) {
+    if (ui->count == UI_MAX_WIDGETS)
+        return -1;
+    ui_widget_t *w = &ui->widgets[ui->count];
+    w->text = text;
+    w->x = x;
+    w->y = y;
+    w->digits = digits;
+    w->scale = 1;
+    w->has_value = false;
+    w->dirty = false;
+    w->value = 0;
+    ui->drawn = false; // O novo conteúdo fixo entra no próximo render
+    return ui->count++;
+}
+
+int ui_add_label(ui_t *ui, const char *text, uint8_t x, uint8_t y) {
+    return ui_add(ui, text, 0, x, y);
+}
+
+int ui_add_number(ui_t *ui, const char *prefix, uint8_t digits, uint8_t x, uint8_t y) {
+    if (digits == 0 || digits > UI_MAX_DIGITS)
+        return -1;
+    return ui_add(ui, prefix ? prefix : "", digits, x, y);
+}
+
+// Campo sem prefixo com dígitos ampliados; ocupa digits * 8 * scale colunas
+int ui_add_big_number(ui_t *ui, uint8_t digits, uint8_t scale, uint8_t x, uint8_t y) {
+    if (scale < 1 || scale > 3)
+        return -1;
+    int id = ui_add_number(ui, NULL, digits, x, y);
+    if (id >= 0)
+        ui->widgets[id].scale = scale;
+    return id;
+}
+
+// Só marca o campo quando o valor exibido muda
+void ui_set_number(ui_t *ui, int id, uint32_t value) {
+    if (id < 0 || id >= ui->count || !ui->widgets[id].digits)
+        return;
+    ui_widget_t *w = &ui->widgets[id];
+    if (value > ui_limits[w->digits - 1])
+        value = ui_limits[w->digits - 1];
+    if (w->has_value && w->value == value)
+        return;
+    w->value = value;
+    w->has_value = true;
+    w->dirty = true;
+}
+
+// Decimal sem printf: escreve os dígitos de trás para frente num buffer
+// local e copia. buf precisa de UI_MAX_DIGITS + 1 bytes. Retorna o tamanho.
+uint8_t ui_format_u32(uint32_t value, char *buf) {
+    char tmp[UI_MAX_DIGITS];
+    uint8_t n = 0;
+    do {
+        uint32_t q = value / 10; // Divisor do SIO no RP2040
+        tmp[n++] = (char)('0' + (value - q * 10));
+        value = q;
+    } while (value);
+    for (uint8_t i = 0; i < n; i++)
+        buf[i] = tmp[n - 1 - i];
+    buf[n] = '\0';
+    return n;
+}
+
+// Desenha os dígitos alinhados à esquerda e completa a largura com espaços,
+// apagando o que sobrou de um valor mais longo
+static void ui_draw_value(ui_t *ui, ui_widget_t *w) {
+    char buf[UI_MAX_DIGITS + 1];
+    uint8_t len = w->has_value ? ui_format_u32(w->value, buf) : 0;
+    while (len < w->digits)
+        buf[len++] = ' ';
+    buf[len] = '\0';
+    uint8_t x = w->x + (uint8_t)(strlen(w->text) * UI_CHAR_WIDTH);
+    ssd1306_draw_string_scaled(ui->ssd, buf, x, w->y, w->scale);
+    w->dirty = false;
+}
+
+// Retorna true se algo foi desenhado (há o que enviar no flush)
+bool ui_render(ui_t *ui) {
+    bool full = !ui->drawn;
+    bool changed = full;
+
+    if (full) {
+        ssd1306_fill(ui->ssd, false);
+        for (uint8_t i = 0; i < ui->count; i++)
+            ssd1306_draw_string(ui->ssd, ui->widgets[i].text, ui->widgets[i].x, ui->widgets[i].y);
+        ui->drawn = true;
+    }
+
+    for (uint8_t i = 0; i < ui->count; i++) {
+        ui_widget_t *w = &ui->widgets[i];
+        if (w->digits && (full || w->dirty)) {
+            ui_draw_value(ui, w);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// Força o redesenho completo no próximo render (ex.: após outro código
+// desenhar no framebuffer)
+void ui_invalidate(ui_t *ui) {
+    ui->drawn = false;
+}
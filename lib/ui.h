@@ -0,0 +1,47 @@
+#ifndef UI_H
+#define UI_H
+
+#include "ssd1306.h"
+
+// Interface retida sobre o ssd1306_t: rótulos fixos e campos numéricos
+// registrados uma vez. O conteúdo fixo é rasterizado só no primeiro
+// ui_render() (ou após ui_invalidate()); depois disso cada campo numérico
+// só é redesenhado quando o seu valor muda, e apenas na área dos dígitos,
+// o que também mantém pequena a janela enviada no flush parcial.
+//
+// Os números são formatados sem printf nem alocação; um valor que não cabe
+// nos dígitos reservados satura em 9...9 em vez de invadir o vizinho.
+// Campos grandes (ui_add_big_number) usam os dígitos 2x/3x gerados em
+// tempo de compilação pelo ssd1306.
+
+#define UI_MAX_WIDGETS 8
+#define UI_MAX_DIGITS 10 // Suficiente para qualquer uint32_t
+
+typedef struct {
+    const char *text; // Rótulo, ou prefixo fixo do campo numérico
+    uint8_t x, y;
+    uint8_t digits;   // 0 = rótulo; >0 = largura do campo em caracteres
+    uint8_t scale;    // Fator de escala dos dígitos (1, 2 ou 3)
+    bool has_value;
+    bool dirty;
+    uint32_t value;
+} ui_widget_t;
+
+typedef struct {
+    ssd1306_t *ssd;
+    ui_widget_t widgets[UI_MAX_WIDGETS];
+    uint8_t count;
+    bool drawn; // Conteúdo fixo já está no framebuffer
+} ui_t;
+
+void ui_init(ui_t *ui, ssd1306_t *ssd);
+int ui_add_label(ui_t *ui, const char *text, uint8_t x, uint8_t y);
+int ui_add_number(ui_t *ui, const char *prefix, uint8_t digits, uint8_t x, uint8_t y);
+int ui_add_big_number(ui_t *ui, uint8_t digits, uint8_t scale, uint8_t x, uint8_t y);
+void ui_set_number(ui_t *ui, int id, uint32_t value);
+bool ui_render(ui_t *ui);
+void ui_invalidate(ui_t *ui);
+
+uint8_t ui_format_u32(uint32_t value, char *buf);
+
+#endif // UI_H
@@ -1,38 +1,35 @@
 #include "ws2812b.h"
 #include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
 #include <stdlib.h>
+#include <string.h>
 #include "../generated/ws2812b.pio.h"
 
-/**
- * @brief Inverte horizontalmente a matriz 5x5 de LEDs.
- * * @param matrix Ponteiro para a matriz de LEDs representada como um array de 25 elementos.
- * * @note Esta operação é necessária para ajustar a orientação do padrão de LEDs
- * quando exibido na matriz. A inversão ocorre em pares de elementos em posições
- * simétricas em relação ao eixo central vertical.
- */
-static void fliplr(uint8_t *matrix) {
-    uint8_t temp;
-
-    // Troca os elementos da primeira linha
-    temp = matrix[5];
-    matrix[5] = matrix[9]; 
-    matrix[9] = temp;
+#define WS2812B_WORD_US     30  /**< Tempo para deslocar 24 bits a 800 kHz */
+#define WS2812B_FIFO_DEPTH  8   /**< Profundidade da FIFO TX com join */
 
-    temp = matrix[6];
-    matrix[6] = matrix[8]; 
-    matrix[8] = temp;
+static ws2812b_t *ws2812b_instances[WS2812B_MAX_INSTANCES]; /**< Matrizes atendidas pelo handler de DMA */
 
-    // Troca os elementos da terceira linha
-    temp = matrix[15];
-    matrix[15] = matrix[19]; 
-    matrix[19] = temp;
+/**
+ * @brief Posição na cadeia do pixel lógico (x, y): espelhamentos, transposição e serpentina.
+ */
+uint16_t ws2812b_layout_index(ws2812b_layout_t layout, uint16_t width, uint16_t height, uint16_t x, uint16_t y)
+{
+    uint row_len = width;
 
-    temp = matrix[16];
-    matrix[16] = matrix[18]; 
-    matrix[18] = temp;
+    if (layout & WS2812B_LAYOUT_FLIP_X) x = width - 1 - x;
+    if (layout & WS2812B_LAYOUT_FLIP_Y) y = height - 1 - y;
+    if (layout & WS2812B_LAYOUT_TRANSPOSE) {
+        uint16_t t = x;
+        x = y;
+        y = t;
+        row_len = height; // Cada linha física é uma coluna lógica
+    }
+    if ((layout & WS2812B_LAYOUT_SERPENTINE) && (y & 1)) x = row_len - 1 - x;
+    return (uint16_t)(y * row_len + x);
 }
 
-
 /**
  * @brief Compoe o valor do LED com base na cor e intensidade fornecida.
  * * Esta função calcula o valor do LED para ser enviado ao controlador WS2812B. A intensidade é convertida para um valor entre 0 e 255 com base na porcentagem fornecida.
@@ -81,35 +78,46 @@ static uint32_t ws2812b_compose_led_value(uint8_t color, uint8_t intensity)
     return composite_value; // Retorna o valor composto do LED
 }
 
+/**
+ * @brief Escreve o bitmap no buffer de composição: value nos pixels ligados, 0 nos demais.
+ * * Uma passada linear pelos pixels lógicos; o bit vira máscara (0 ou ~0) em vez de desvio,
+ * e a posição na cadeia vem do mapa de índices.
+ */
+static void ws2812b_fill_bitmap(ws2812b_t *ws, const uint32_t *glyph, uint32_t value)
+{
+    uint32_t *frame = ws->frames[ws->back];
+    const uint16_t *map = ws->map;
+    uint i = 0;
+
+    for (uint w = 0; i < ws->num_leds; w++) {
+        uint32_t bits = glyph[w];
+        uint end = i + 32 < ws->num_leds ? i + 32 : ws->num_leds;
+        for (; i < end; i++, bits >>= 1)
+            frame[map[i]] = value & (0u - (bits & 1u));
+    }
+}
+
 /**
  * @brief Desenha a matriz de LEDs (glyph) com base nas cores e intensidade fornecidas.
- * * Esta função percorre a matriz de LEDs (glyph) e envia os dados para o controlador WS2812B. 
- * O valor de cada LED é calculado usando a cor e intensidade fornecidas. A matriz é percorrida de trás para frente.
+ * * Esta função monta o quadro no buffer de composição e o envia por DMA. O valor de cada LED
+ * é calculado usando a cor e intensidade fornecidas; a posição na cadeia vem do mapa de índices.
  * * @param ws Ponteiro para o controlador WS2812B.
- * @param glyph Matriz de 25 elementos (5x5) que representa o padrão de LEDs a ser exibido.
+ * @param glyph Bitmap compactado (bit i = pixel lógico i) que representa o padrão de LEDs a ser exibido.
  * @param color Cor do LED (vermelho, verde, azul, etc.).
  * @param intensity Intensidade do LED (0-100%).
+ * @return ws2812b_present_result_t Resultado de ws2812b_present().
  */
-void ws2812b_draw(const ws2812b_t *ws, const uint8_t *glyph, const uint8_t color, const uint8_t intensity)
+ws2812b_present_result_t ws2812b_draw(ws2812b_t *ws, const uint32_t *glyph, const uint8_t color, const uint8_t intensity)
 {
-    uint8_t i;
-    uint32_t composite_value;
-    
-    // Percorre cada posição do "glyph" (matriz 5x5) e acende o LED correspondente
-    for(i = 0; i < 25; i++) {
-        // Se o valor da posição for 1, acende o LED com o valor calculado
-        if(glyph[24-i] == 1) {
-            composite_value = ws2812b_compose_led_value(color, intensity); // Calcula o valor para a cor e intensidade
-            send_ws2812b_data(ws->pio, ws->state_machine_id, composite_value); // Envia o valor do LED via PIO
-        }
-        else send_ws2812b_data(ws->pio, ws->state_machine_id, 0); // Se o LED estiver apagado, envia 0
-    }
+    uint32_t composite_value = ws2812b_compose_led_value(color, intensity); // Calcula o valor para a cor e intensidade
+    ws2812b_fill_bitmap(ws, glyph, composite_value);
+    return ws2812b_present(ws);
 }
 
 /**
  * @brief Desenha a matriz de LEDs com base em valores RGB diretos, convertendo para o formato GRB.
  */
-void ws2812b_draw_rgb(const ws2812b_t *ws, const uint8_t *glyph, uint8_t r, uint8_t g, uint8_t b)
+ws2812b_present_result_t ws2812b_draw_rgb(ws2812b_t *ws, const uint32_t *glyph, uint8_t r, uint8_t g, uint8_t b)
 {
     // IMPORTANTE: O controlador WS2812B espera os dados de cor na ordem GRB (Green, Red, Blue).
     // Esta linha de código monta o valor de 24 bits na ordem correta:
@@ -119,26 +127,95 @@ void ws2812b_draw_rgb(const ws2812b_t *ws, const uint8_t *glyph, uint8_t r, uint
     uint32_t composite_value = ((uint32_t)(g) << 24) |
                                ((uint32_t)(r) << 16) |
                                ((uint32_t)(b) << 8);
-
-    for(int i = 0; i < 25; i++) {
-        if(glyph[24-i] == 1) {
-            send_ws2812b_data(ws->pio, ws->state_machine_id, composite_value);
-        } else {
-            send_ws2812b_data(ws->pio, ws->state_machine_id, 0);
-        }
-    }
+    ws2812b_fill_bitmap(ws, glyph, composite_value);
+    return ws2812b_present(ws);
 }
 
 /**
  * @brief Apaga todos os LEDs da matriz (configura todos os LEDs como 0).
- * * Esta função desliga todos os LEDs da matriz WS2812B enviando o valor 0 para cada um.
+ * * Esta função limpa o buffer de composição e aguarda o envio do quadro apagado.
  * * @param ws Ponteiro para o controlador WS2812B.
  */
-void ws2812b_turn_off_all(const ws2812b_t *ws)
+void ws2812b_turn_off_all(ws2812b_t *ws)
+{
+    ws2812b_clear(ws);
+    ws2812b_wait(ws);
+    ws2812b_present(ws);
+}
+
+void ws2812b_set_pixel(ws2812b_t *ws, uint index, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (index >= ws->num_leds) return;
+    ws->frames[ws->back][index] = ((uint32_t)(g) << 24) |
+                                  ((uint32_t)(r) << 16) |
+                                  ((uint32_t)(b) << 8);
+}
+
+void ws2812b_set_pixel_xy(ws2812b_t *ws, uint x, uint y, uint8_t r, uint8_t g, uint8_t b)
 {
-    uint8_t i;
-    // Envia o valor 0 para todos os LEDs, apagando-os
-    for(i = 0; i < 25; i++) send_ws2812b_data(ws->pio, ws->state_machine_id, 0);
+    if (x >= ws->width || y >= ws->height) return;
+    ws2812b_set_pixel(ws, ws->map[y * ws->width + x], r, g, b);
+}
+
+void ws2812b_clear(ws2812b_t *ws)
+{
+    memset(ws->frames[ws->back], 0, ws->num_leds * sizeof(uint32_t));
+}
+
+/**
+ * @brief Handler compartilhado do DMA_IRQ_0: encerra as transferências concluídas.
+ * * O DMA termina quando a última palavra entra na FIFO; o próximo quadro só pode começar
+ * depois que a FIFO esvaziar e os LEDs travarem (reset), por isso o instante é registrado em ready_at.
+ */
+static void ws2812b_dma_irq_handler(void)
+{
+    for (uint i = 0; i < WS2812B_MAX_INSTANCES; i++) {
+        ws2812b_t *ws = ws2812b_instances[i];
+        if (!ws || !dma_channel_get_irq0_status(ws->dma_channel)) continue;
+
+        dma_channel_acknowledge_irq0(ws->dma_channel);
+        ws->ready_at = make_timeout_time_us(WS2812B_FIFO_DEPTH * WS2812B_WORD_US + WS2812B_LATCH_US);
+        ws->busy = false;
+        if (ws->on_done) ws->on_done(ws, ws->user_data);
+    }
+}
+
+ws2812b_present_result_t ws2812b_present(ws2812b_t *ws)
+{
+    if (ws2812b_is_busy(ws)) return WS2812B_PRESENT_BUSY;
+
+    uint8_t front = ws->back ^ 1;
+    if (ws->has_sent && memcmp(ws->frames[ws->back], ws->frames[front], ws->num_leds * sizeof(uint32_t)) == 0) {
+        ws->frames_skipped++;
+        return WS2812B_PRESENT_SKIPPED;
+    }
+
+    // Troca os buffers: o quadro composto passa a ser transmitido e o outro recebe uma cópia
+    // dele, para que alterações parciais (ws2812b_set_pixel) partam do último quadro.
+    ws->back = front;
+    front ^= 1;
+    memcpy(ws->frames[ws->back], ws->frames[front], ws->num_leds * sizeof(uint32_t));
+    ws->has_sent = true;
+    ws->busy = true;
+    ws->frames_sent++;
+    dma_channel_transfer_from_buffer_now(ws->dma_channel, ws->frames[front], ws->num_leds);
+    return WS2812B_PRESENT_STARTED;
+}
+
+bool ws2812b_is_busy(const ws2812b_t *ws)
+{
+    return ws->busy || !time_reached(ws->ready_at);
+}
+
+void ws2812b_wait(const ws2812b_t *ws)
+{
+    while (ws2812b_is_busy(ws)) tight_loop_contents();
+}
+
+void ws2812b_set_done_callback(ws2812b_t *ws, ws2812b_done_callback_t callback, void *user_data)
+{
+    ws->user_data = user_data;
+    ws->on_done = callback;
 }
 
 /**
@@ -156,13 +233,42 @@ void send_ws2812b_data(PIO pio, uint sm, uint32_t data)
 /**
  * @brief Inicializa o controlador WS2812B e configura o PIO (Programmable Input/Output).
  * * Esta função inicializa a configuração do PIO para controlar o WS2812B, incluindo a definição de pinos, configuração de clock e a máquina de estado do PIO.
+ * A geometria define o tamanho dos buffers e o mapa de índices lógico -> físico, montado aqui
+ * uma única vez.
  * * @param pio Ponteiro para o PIO a ser utilizado.
  * @param pin Pino GPIO conectado ao LED WS2812B.
- * @return Ponteiro para o controlador WS2812B inicializado.
+ * @param width Colunas da matriz.
+ * @param height Linhas da matriz.
+ * @param layout Ligação física da matriz.
+ * @return Ponteiro para o controlador WS2812B inicializado (NULL sem memória).
  */
-ws2812b_t *init_ws2812b(PIO pio, uint8_t pin)
+ws2812b_t *init_ws2812b_matrix(PIO pio, uint8_t pin, uint16_t width, uint16_t height, ws2812b_layout_t layout)
 {
-    ws2812b_t *ws = malloc(sizeof(ws2812b_t)); // Aloca memória para a estrutura que representará o controlador WS2812B
+    uint32_t num_leds = (uint32_t)width * height;
+    if (!num_leds || num_leds > UINT16_MAX) return NULL;
+
+    ws2812b_t *ws = calloc(1, sizeof(ws2812b_t)); // Aloca memória (zerada) para a estrutura que representará o controlador WS2812B
+    uint32_t *frames = calloc(2 * num_leds, sizeof(uint32_t));
+    uint16_t *map = malloc(num_leds * sizeof(uint16_t));
+    if (!ws || !frames || !map) {
+        free(ws);
+        free(frames);
+        free(map);
+        return NULL;
+    }
+    ws->width = width;
+    ws->height = height;
+    ws->num_leds = (uint16_t)num_leds;
+    ws->layout = layout;
+    ws->frames[0] = frames;
+    ws->frames[1] = frames + num_leds;
+    ws->map = map;
+
+    // Mapa de índices: o único lugar em que a ligação física é considerada
+    for (uint16_t y = 0; y < height; y++)
+        for (uint16_t x = 0; x < width; x++)
+            map[y * width + x] = ws2812b_layout_index(layout, width, height, x, y);
+
     uint offset = pio_add_program(pio, &ws2812_program); // Adiciona o programa WS2812 ao PIO
     uint sm = pio_claim_unused_sm(pio, true); // Requisita uma máquina de estado livre no PIO
 
@@ -195,36 +301,56 @@ ws2812b_t *init_ws2812b(PIO pio, uint8_t pin)
     ws->state_machine_id = sm;
     ws->pio = pio;
 
+    // Canal de DMA: palavras de 32 bits do framebuffer para a FIFO TX, no ritmo do DREQ da máquina de estado
+    ws->dma_channel = dma_claim_unused_channel(true);
+    dma_channel_config dc = dma_channel_get_default_config(ws->dma_channel);
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+    channel_config_set_read_increment(&dc, true);
+    channel_config_set_write_increment(&dc, false);
+    channel_config_set_dreq(&dc, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(ws->dma_channel, &dc, &pio->txf[sm], NULL, ws->num_leds, false);
+
+    // Notificação de fim de quadro pelo DMA_IRQ_0 (handler compartilhado entre as matrizes)
+    if (!ws2812b_instances[0]) {
+        irq_add_shared_handler(DMA_IRQ_0, ws2812b_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+    }
+    for (uint i = 0; i < WS2812B_MAX_INSTANCES; i++) {
+        if (!ws2812b_instances[i]) {
+            ws2812b_instances[i] = ws;
+            break;
+        }
+    }
+    dma_channel_set_irq0_enabled(ws->dma_channel, true);
+
     return ws; // Retorna o controlador WS2812B configurado
 }
 
-/**
- * @brief Prepara o "glyph" (matriz de LEDs) invertendo horizontalmente.
- * * Esta função chama a função `fliplr` para inverter a matriz de LEDs horizontalmente.
- * * @param glyph Matriz de LEDs a ser invertida.
- */
-void prepare_glyph(uint8_t *glyph)
+ws2812b_t *init_ws2812b(PIO pio, uint8_t pin)
 {
-    fliplr(glyph); // Inverte a matriz horizontalmente
+    return init_ws2812b_matrix(pio, pin, WS2812B_WIDTH, WS2812B_HEIGHT, WS2812B_LAYOUT_BITDOGLAB);
 }
 
 /**
  * @brief Desenha a matriz de LEDs no pino 0 do PIO0 com a cor e intensidade fornecidas.
  * * Esta função percorre a matriz de LEDs (glyph) e envia os dados para o controlador WS2812B.
- * * @param glyph Matriz de 25 elementos (5x5) que representa o padrão de LEDs a ser exibido.
+ * Sem ws2812b_t, assume a matriz 5x5 da placa com o mapa de índices WS2812B_LAYOUT_BITDOGLAB.
+ * * @param glyph Bitmap compactado 5x5 (ver ws2812b_definitions.h).
  * @param color Cor do LED (vermelho, verde, azul, etc.).
  * @param intensity Intensidade do LED (0-100%).
  */
-void ws2812b_draw_b(const uint8_t *glyph, const uint8_t color, const uint8_t intensity)
+void ws2812b_draw_b(const uint32_t *glyph, const uint8_t color, const uint8_t intensity)
 {
-    uint8_t i;
-    uint32_t composite_value;
-    // Percorre a matriz de LEDs e envia os dados para acender os LEDs
-    for(i = 0; i < 25; i++) {
-        if(glyph[24-i] == 1) {
-            composite_value = ws2812b_compose_led_value(color, intensity); // Calcula o valor do LED
-            send_ws2812b_data(pio0, 0, composite_value); // Envia o dado para o pino 0 do PIO0
-        }
-        else send_ws2812b_data(pio0, 0, 0); // Envia 0 para apagar o LED
+    uint32_t composite_value = ws2812b_compose_led_value(color, intensity); // Calcula o valor do LED
+    uint32_t frame[WS2812B_NUM_LEDS];
+
+    // Leva cada pixel lógico para a sua posição na cadeia
+    for (uint16_t i = 0; i < WS2812B_NUM_LEDS; i++) {
+        uint16_t led = ws2812b_layout_index(WS2812B_LAYOUT_BITDOGLAB, WS2812B_WIDTH, WS2812B_HEIGHT,
+                                            i % WS2812B_WIDTH, i / WS2812B_WIDTH);
+        frame[led] = composite_value & (0u - ((glyph[0] >> i) & 1u));
     }
+    // Percorre a matriz de LEDs e envia os dados para acender os LEDs
+    for (uint i = 0; i < WS2812B_NUM_LEDS; i++)
+        send_ws2812b_data(pio0, 0, frame[i]); // Envia o dado para o pino 0 do PIO0
 }
\ No newline at end of file
@@ -2,10 +2,16 @@
 #define WS2812B_H
 
 #include <stdint.h>
+#include "pico/stdlib.h"
 #include "hardware/pio.h"
 #include "ws2812b_definitions.h"
 
 #define WS2812B_PIN 7             /**< Pino GPIO utilizado para controlar o WS2812B */
+#define WS2812B_WIDTH 5           /**< Colunas da matriz da placa */
+#define WS2812B_HEIGHT 5          /**< Linhas da matriz da placa */
+#define WS2812B_NUM_LEDS (WS2812B_WIDTH * WS2812B_HEIGHT) /**< Número de LEDs da matriz 5x5 */
+#define WS2812B_LATCH_US 300      /**< Tempo em nível baixo para os LEDs travarem o quadro (reset) */
+#define WS2812B_MAX_INSTANCES 4   /**< Máximo de matrizes atendidas pela interrupção de DMA */
 #define RED         0             /**< Define a cor vermelha para os LEDs */
 #define GREEN       1             /**< Define a cor verde para os LEDs */
 #define BLUE        2             /**< Define a cor azul para os LEDs */
@@ -16,13 +22,42 @@
 
 #define init_ws2812b_default(pio) init_ws2812b(pio, WS2812B_PIN)
 
+/**
+ * @brief Palavras de 32 bits de um bitmap compactado com n pixels (bit i = pixel lógico i).
+ */
+#define WS2812B_BITMAP_WORDS(n) (((n) + 31) / 32)
+
+/**
+ * @brief Ligação física da matriz, combinação de flags.
+ * * O pixel lógico (x, y), com (0, 0) no canto superior esquerdo e o índice lógico
+ * y * largura + x, é levado à posição na cadeia nesta ordem: espelhamentos, transposição
+ * (as linhas físicas passam a ser as colunas lógicas) e, nas linhas físicas ímpares da
+ * ligação em serpentina, a inversão do sentido. Rotações no sentido horário são
+ * combinações de espelhamento e transposição.
+ */
+typedef enum {
+    WS2812B_LAYOUT_ROW_MAJOR  = 0,       /**< Todas as linhas no mesmo sentido, a partir do canto superior esquerdo */
+    WS2812B_LAYOUT_SERPENTINE = 1 << 0,  /**< Linhas ímpares no sentido contrário (zigue-zague) */
+    WS2812B_LAYOUT_FLIP_X     = 1 << 1,  /**< Espelha as colunas */
+    WS2812B_LAYOUT_FLIP_Y     = 1 << 2,  /**< Espelha as linhas */
+    WS2812B_LAYOUT_TRANSPOSE  = 1 << 3,  /**< Cadeia percorre colunas em vez de linhas */
+    WS2812B_LAYOUT_ROTATE_90  = WS2812B_LAYOUT_FLIP_Y | WS2812B_LAYOUT_TRANSPOSE,
+    WS2812B_LAYOUT_ROTATE_180 = WS2812B_LAYOUT_FLIP_X | WS2812B_LAYOUT_FLIP_Y,
+    WS2812B_LAYOUT_ROTATE_270 = WS2812B_LAYOUT_FLIP_X | WS2812B_LAYOUT_TRANSPOSE,
+    /** Matriz 5x5 da BitDogLab: serpentina começando no canto inferior direito */
+    WS2812B_LAYOUT_BITDOGLAB  = WS2812B_LAYOUT_SERPENTINE | WS2812B_LAYOUT_ROTATE_180,
+} ws2812b_layout_t;
+
 /** * @file ws2812b.h
  * @brief Este arquivo contém declarações de funções e definições relacionadas
  * ao dispositivo WS2812B conectado ao pino GPIO do Raspberry Pi Pico W,
- * controlando uma matriz de LEDs 5x5 (25 LEDs).
+ * controlando uma matriz de LEDs (por padrão a 5x5 da placa, 25 LEDs).
  * * ***************
  * *** ATENÇÃO ***
  * ***************
+ * A geometria (largura, altura e ligação) é dada em init_ws2812b_matrix(); os desenhos
+ * usam coordenadas lógicas e o mapa de índices montado na inicialização.
+ *
  * Todos os plots nesta matriz são feitos em um quadrado 3x3 de LEDs
  * dispostos onde se encontra o #
  * * . . . . .
@@ -35,46 +70,97 @@
  * @date 23/01/2025
  */
 
-typedef struct {
+typedef struct ws2812b ws2812b_t;
+
+/**
+ * @brief Callback chamado (em contexto de interrupção) quando o DMA termina de enviar um quadro.
+ */
+typedef void (*ws2812b_done_callback_t)(ws2812b_t *ws, void *user_data);
+
+/**
+ * @brief Resultado de ws2812b_present().
+ */
+typedef enum {
+    WS2812B_PRESENT_STARTED,  /**< Quadro entregue ao DMA */
+    WS2812B_PRESENT_SKIPPED,  /**< Quadro idêntico ao último enviado, nada a fazer */
+    WS2812B_PRESENT_BUSY      /**< Transferência anterior (ou reset) em andamento; o quadro continua no buffer de composição */
+} ws2812b_present_result_t;
+
+struct ws2812b {
     PIO pio;                 /**< Ponteiro para o controlador PIO utilizado para comunicação com os LEDs */
     uint state_machine_id;   /**< ID da máquina de estado (state machine) que controla o envio dos dados para os LEDs */
     uint8_t out_pin;         /**< Pino GPIO ao qual o WS2812B está conectado */
-} ws2812b_t;
+
+    uint16_t width;                       /**< Colunas lógicas */
+    uint16_t height;                      /**< Linhas lógicas */
+    uint16_t num_leds;                    /**< width * height */
+    ws2812b_layout_t layout;              /**< Ligação física */
+    uint16_t *map;                        /**< Índice lógico -> posição na cadeia, montado na inicialização */
+    uint32_t *frames[2];                  /**< Buffers duplos, em ordem de envio, valores GRB já deslocados para o PIO */
+    uint8_t back;                         /**< Índice do buffer de composição (o outro é o último enviado) */
+    bool has_sent;                        /**< Indica se algum quadro já foi enviado (habilita a comparação) */
+    int dma_channel;                      /**< Canal de DMA que alimenta a FIFO TX da máquina de estado */
+    volatile bool busy;                   /**< Transferência de DMA em andamento */
+    volatile absolute_time_t ready_at;    /**< Instante a partir do qual um novo quadro pode ser enviado */
+    ws2812b_done_callback_t on_done;      /**< Notificação de fim de transferência (opcional) */
+    void *user_data;                      /**< Argumento repassado a on_done */
+    uint32_t frames_sent;                 /**< Quadros enviados */
+    uint32_t frames_skipped;              /**< Quadros descartados por serem idênticos ao anterior */
+};
 
 /**
- * @brief Inicializa o WS2812B configurando o PIO e a máquina de estado.
+ * @brief Inicializa a matriz 5x5 da placa (WS2812B_LAYOUT_BITDOGLAB).
+ * * @param pio O controlador PIO que será utilizado para enviar os dados aos LEDs WS2812B.
+ * @param pin O pino GPIO utilizado para comunicação com o WS2812B.
+ * * @return ws2812b_t* Retorna um ponteiro para a estrutura `ws2812b_t` (NULL sem memória).
+ */
+ws2812b_t *init_ws2812b(PIO pio, uint8_t pin);
+
+/**
+ * @brief Inicializa uma matriz WS2812B configurando o PIO e a máquina de estado.
  * * Esta função configura o controlador PIO e a máquina de estado (state machine) 
  * para controlar a comunicação com a matriz de LEDs WS2812B. O pino de controle é configurado 
  * para enviar os sinais aos LEDs, e a máquina de estado é configurada para esse propósito.
  * * @param pio O controlador PIO que será utilizado para enviar os dados aos LEDs WS2812B.
  * @param pin O pino GPIO utilizado para comunicação com o WS2812B.
- * * @return ws2812b_t* Retorna um ponteiro para a estrutura `ws2812b_t` contendo as configurações do WS2812B.
+ * @param width Colunas da matriz.
+ * @param height Linhas da matriz.
+ * @param layout Ligação física (ver ws2812b_layout_t).
+ * * @return ws2812b_t* Retorna um ponteiro para a estrutura `ws2812b_t` contendo as configurações do WS2812B
+ * (NULL sem memória ou com mais de 65535 LEDs).
  */
-ws2812b_t *init_ws2812b(PIO pio, uint8_t pin);
+ws2812b_t *init_ws2812b_matrix(PIO pio, uint8_t pin, uint16_t width, uint16_t height, ws2812b_layout_t layout);
+
+/**
+ * @brief Posição na cadeia do pixel lógico (x, y) numa matriz width x height com a ligação dada.
+ * * Usada uma vez por LED para montar o mapa de índices; os desenhos só consultam o mapa.
+ */
+uint16_t ws2812b_layout_index(ws2812b_layout_t layout, uint16_t width, uint16_t height, uint16_t x, uint16_t y);
 
 /**
  * @brief Desenha uma imagem (glyph) na matriz de LEDs WS2812B.
- * * Esta função envia os dados da imagem (glyph) para o WS2812B e exibe a imagem na matriz de LEDs 5x5,
- * considerando a cor e a intensidade fornecidas. A imagem é uma matriz de 25 elementos (5x5),
- * onde cada elemento representa um LED individual na matriz.
+ * * Esta função envia os dados da imagem (glyph) para o WS2812B e exibe a imagem na matriz de LEDs,
+ * considerando a cor e a intensidade fornecidas. A imagem é um bitmap compactado com um bit por
+ * LED (bit i = pixel lógico i, WS2812B_BITMAP_WORDS(num_leds) palavras), percorrido numa só
+ * passada pelo mapa de índices, sem desvio por pixel.
  * * @param ws Ponteiro para a estrutura `ws2812b_t` contendo as configurações do WS2812B.
- * @param glyph A matriz de 25 elementos representando a imagem a ser desenhada nos LEDs.
+ * @param glyph Bitmap compactado da imagem a ser desenhada nos LEDs.
  * @param color A cor dos LEDs, definida pelas constantes `RED`, `GREEN`, `BLUE`, etc.
  * @param intensity A intensidade dos LEDs, em valor de 0 a 100.
  */
-void ws2812b_draw(const ws2812b_t *ws, const uint8_t *glyph, const uint8_t color, const uint8_t intensity);
+ws2812b_present_result_t ws2812b_draw(ws2812b_t *ws, const uint32_t *glyph, const uint8_t color, const uint8_t intensity);
 
 /**
  * @brief Desenha uma imagem (glyph) na matriz de LEDs com base nos valores RGB.
  * * @param ws Ponteiro para a estrutura `ws2812b_t`.
- * @param glyph A matriz de 25 elementos representando a imagem.
+ * @param glyph Bitmap compactado da imagem (ver ws2812b_draw()).
  * @param r Componente Vermelho da cor (0-255).
  * @param g Componente Verde da cor (0-255).
  * @param b Componente Azul da cor (0-255).
  */
-void ws2812b_draw_rgb(const ws2812b_t *ws, const uint8_t *glyph, uint8_t r, uint8_t g, uint8_t b);
+ws2812b_present_result_t ws2812b_draw_rgb(ws2812b_t *ws, const uint32_t *glyph, uint8_t r, uint8_t g, uint8_t b);
 
-void ws2812b_draw_b(const uint8_t *glyph, const uint8_t color, const uint8_t intensity);
+void ws2812b_draw_b(const uint32_t *glyph, const uint8_t color, const uint8_t intensity);
 
 /**
  * @brief Desliga todos os LEDs da matriz WS2812B.
@@ -82,7 +168,64 @@ void ws2812b_draw_b(const uint8_t *glyph, const uint8_t color, const uint8_t int
  * apagando todos os LEDs conectados ao controlador.
  * * @param ws Ponteiro para a estrutura `ws2812b_t` contendo as configurações do WS2812B.
  */
-void ws2812b_turn_off_all(const ws2812b_t *ws);
+void ws2812b_turn_off_all(ws2812b_t *ws);
+
+/**
+ * @brief Define a cor de um LED no buffer de composição.
+ * * Nada é enviado aos LEDs até a chamada de ws2812b_present().
+ * * @param ws Ponteiro para a estrutura `ws2812b_t`.
+ * @param index Posição do LED na cadeia (ordem de envio, 0 a num_leds - 1).
+ * @param r Componente Vermelho da cor (0-255).
+ * @param g Componente Verde da cor (0-255).
+ * @param b Componente Azul da cor (0-255).
+ */
+void ws2812b_set_pixel(ws2812b_t *ws, uint index, uint8_t r, uint8_t g, uint8_t b);
+
+/**
+ * @brief Define a cor do pixel lógico (x, y) no buffer de composição, pelo mapa de índices.
+ * * @param ws Ponteiro para a estrutura `ws2812b_t`.
+ * @param x Coluna (0 a width - 1).
+ * @param y Linha (0 a height - 1), a partir do topo.
+ */
+void ws2812b_set_pixel_xy(ws2812b_t *ws, uint x, uint y, uint8_t r, uint8_t g, uint8_t b);
+
+/**
+ * @brief Apaga todos os LEDs do buffer de composição.
+ * * @param ws Ponteiro para a estrutura `ws2812b_t`.
+ */
+void ws2812b_clear(ws2812b_t *ws);
+
+/**
+ * @brief Envia o buffer de composição aos LEDs de forma assíncrona.
+ * * O quadro é transferido por DMA para a FIFO do PIO, com o ritmo dado pelo DREQ TX da
+ * máquina de estado, e a função retorna imediatamente. Os buffers são trocados, de modo que
+ * o próximo quadro pode ser composto enquanto o atual é transmitido. Quadros idênticos ao
+ * último enviado não são retransmitidos.
+ * * @param ws Ponteiro para a estrutura `ws2812b_t`.
+ * @return ws2812b_present_result_t Resultado da operação.
+ */
+ws2812b_present_result_t ws2812b_present(ws2812b_t *ws);
+
+/**
+ * @brief Indica se há uma transferência (ou o tempo de reset dos LEDs) em andamento.
+ * * @param ws Ponteiro para a estrutura `ws2812b_t`.
+ * @return true enquanto um novo quadro não puder ser enviado.
+ */
+bool ws2812b_is_busy(const ws2812b_t *ws);
+
+/**
+ * @brief Bloqueia até que um novo quadro possa ser enviado.
+ * * @param ws Ponteiro para a estrutura `ws2812b_t`.
+ */
+void ws2812b_wait(const ws2812b_t *ws);
+
+/**
+ * @brief Registra a função chamada ao fim de cada transferência.
+ * * @param ws Ponteiro para a estrutura `ws2812b_t`.
+ * @param callback Função chamada em contexto de interrupção (ou NULL).
+ * @param user_data Argumento repassado ao callback.
+ */
+void ws2812b_set_done_callback(ws2812b_t *ws, ws2812b_done_callback_t callback, void *user_data);
 
 /**
  * @brief Envia dados para o WS2812B via PIO.
@@ -94,12 +237,4 @@ void ws2812b_turn_off_all(const ws2812b_t *ws);
  */
 void send_ws2812b_data(PIO pio, uint sm, uint32_t data);
 
-/**
- * @brief Prepara a imagem (glyph) para exibição.
- * * Esta função prepara a imagem a ser exibida nos LEDs, realizando operações de transformação, como
- * a inversão ou qualquer outro ajuste necessário para a correta exibição no WS2812B.
- * * @param glyph A matriz de 25 elementos representando a imagem a ser exibida nos LEDs.
- */
-void prepare_glyph(uint8_t *glyph);
-
 #endif // WS2812B_H
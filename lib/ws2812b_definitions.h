@@ -6,8 +6,12 @@
  * @file ws2812b_definitions.h
  * @brief Definições de padrões para números de 0 a 9 em uma matriz 5x5 de LEDs WS2812B.
  * 
- * Cada número é representado por um array unidimensional de 25 posições (5x5),
- * onde 0 significa LED apagado e 1 significa LED aceso.
+ * Cada número é representado por um bitmap compactado de 25 bits (5x5), montado em tempo
+ * de compilação por WS2812B_PACK_5X5 a partir do desenho linha a linha, onde 0 significa
+ * LED apagado e 1 significa LED aceso. O bit i é o pixel lógico i (linha y * 5 + coluna x);
+ * a posição física na cadeia vem do mapa de índices de ws2812b_t. Os desenhos estão como
+ * aparecem na placa, todas as linhas da esquerda para a direita: o espelhamento das linhas
+ * ímpares da serpentina fica no mapa.
  * 
  * A representação de cada número utiliza apenas uma **submatriz de 5x3** dentro da matriz 5x5.
  * Ou seja, a largura dos números é de 3 colunas, e a altura é de 5 linhas. As outras colunas 
@@ -16,87 +20,100 @@
  * é usada para maior flexibilidade na representação.
  */
 
-static const uint8_t ZERO_GLYPH[] = { 
+/**
+ * @brief Compacta um desenho 5x5 (25 valores 0/1, linha a linha) em uma palavra, bit i = pixel i.
+ */
+#define WS2812B_PACK_5X5(p0, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15, \
+                         p16, p17, p18, p19, p20, p21, p22, p23, p24)                         \
+    ((uint32_t)(p0) << 0 | (uint32_t)(p1) << 1 | (uint32_t)(p2) << 2 | (uint32_t)(p3) << 3 |    \
+     (uint32_t)(p4) << 4 | (uint32_t)(p5) << 5 | (uint32_t)(p6) << 6 | (uint32_t)(p7) << 7 |    \
+     (uint32_t)(p8) << 8 | (uint32_t)(p9) << 9 | (uint32_t)(p10) << 10 | (uint32_t)(p11) << 11 | \
+     (uint32_t)(p12) << 12 | (uint32_t)(p13) << 13 | (uint32_t)(p14) << 14 | (uint32_t)(p15) << 15 | \
+     (uint32_t)(p16) << 16 | (uint32_t)(p17) << 17 | (uint32_t)(p18) << 18 | (uint32_t)(p19) << 19 | \
+     (uint32_t)(p20) << 20 | (uint32_t)(p21) << 21 | (uint32_t)(p22) << 22 | (uint32_t)(p23) << 23 | \
+     (uint32_t)(p24) << 24)
+
+static const uint32_t ZERO_GLYPH[] = { WS2812B_PACK_5X5(
         1, 1, 1, 1, 1,
         1, 1, 1, 1, 1,
         1, 1, 1, 1, 1,
         1, 1, 1, 1, 1,
         1, 1, 1, 1, 1
-    };
+    ) };
 
-static const uint8_t ONE_GLYPH[] =  { 
+static const uint32_t ONE_GLYPH[] = { WS2812B_PACK_5X5(
         0, 0, 1, 0, 0,
-        0, 0, 1, 1, 0,
+        0, 1, 1, 0, 0,
         0, 0, 1, 0, 0,
         0, 0, 1, 0, 0,
         0, 1, 1, 1, 0
-    };
+    ) };
 
-static const uint8_t TWO_GLYPH[] =  { 
-        0, 1, 1, 1, 0,
-        0, 1, 0, 0, 0,
+static const uint32_t TWO_GLYPH[] = { WS2812B_PACK_5X5(
         0, 1, 1, 1, 0,
         0, 0, 0, 1, 0,
+        0, 1, 1, 1, 0,
+        0, 1, 0, 0, 0,
         0, 1, 1, 1, 0
-    };
+    ) };
 
-static const uint8_t THREE_GLYPH[] =  { 
+static const uint32_t THREE_GLYPH[] = { WS2812B_PACK_5X5(
         0, 1, 1, 1, 0,
-        0, 1, 0, 0, 0,
+        0, 0, 0, 1, 0,
         0, 1, 1, 1, 0,
-        0, 1, 0, 0, 0,
+        0, 0, 0, 1, 0,
         0, 1, 1, 1, 0
-    };
+    ) };
 
-static const uint8_t FOUR_GLYPH[] =  { 
+static const uint32_t FOUR_GLYPH[] = { WS2812B_PACK_5X5(
         0, 1, 0, 1, 0,
         0, 1, 0, 1, 0,
         0, 1, 1, 1, 0,
-        0, 1, 0, 0, 0,
+        0, 0, 0, 1, 0,
         0, 0, 0, 1, 0
-    };
+    ) };
 
-static const uint8_t FIVE_GLYPH[] =  { 
-        0, 1, 1, 1, 0,
-        0, 0, 0, 1, 0,
+static const uint32_t FIVE_GLYPH[] = { WS2812B_PACK_5X5(
         0, 1, 1, 1, 0,
         0, 1, 0, 0, 0,
+        0, 1, 1, 1, 0,
+        0, 0, 0, 1, 0,
         0, 1, 1, 1, 0
-    };
+    ) };
 
-static const uint8_t SIX_GLYPH[] =   { 
+static const uint32_t SIX_GLYPH[] = { WS2812B_PACK_5X5(
         0, 1, 1, 1, 0,
-        0, 0, 0, 1, 0,
+        0, 1, 0, 0, 0,
         0, 1, 1, 1, 0,
         0, 1, 0, 1, 0,
         0, 1, 1, 1, 0
-    };
+    ) };
 
-static const uint8_t SEVEN_GLYPH[] =   { 
+static const uint32_t SEVEN_GLYPH[] = { WS2812B_PACK_5X5(
         0, 1, 1, 1, 0,
-        0, 1, 0, 0, 0,
-        0, 0, 1, 0, 0, 
         0, 0, 0, 1, 0,
+        0, 0, 1, 0, 0, 
+        0, 1, 0, 0, 0,
         0, 1, 0, 0, 0
-    };
+    ) };
 
-static const uint8_t EIGHT_GLYPH[] =   { 
+static const uint32_t EIGHT_GLYPH[] = { WS2812B_PACK_5X5(
         0, 1, 1, 1, 0,
         0, 1, 0, 1, 0,
         0, 1, 1, 1, 0,
         0, 1, 0, 1, 0,
         0, 1, 1, 1, 0
-    };
+    ) };
 
-static const uint8_t NINE_GLYPH[] =   { 
+static const uint32_t NINE_GLYPH[] = { WS2812B_PACK_5X5(
         0, 1, 1, 1, 0,
         0, 1, 0, 1, 0, 
         0, 1, 1, 1, 0,
-        0, 1, 0, 0, 0,
+        0, 0, 0, 1, 0,
         0, 1, 1, 1, 0
-    };
+    ) };
 
-static const uint8_t *NUMERIC_GLYPHS[] = {
+static const uint32_t *NUMERIC_GLYPHS[] = {
     ZERO_GLYPH,
     ONE_GLYPH,
     TWO_GLYPH,
@@ -0,0 +1,187 @@
+#include "ws2812b_par.h"
+#include "ws2812b.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../generated/ws2812b_parallel.pio.h"
+
+#define WS2812B_PAR_FIFO_DEPTH 8 // FIFO TX com join
+
+static ws2812b_par_t *ws2812b_par_instances[WS2812B_PAR_MAX_INSTANCES];
+static bool ws2812b_par_irq_added;
+
+// Transposição de uma matriz de 8x8 bits (Hacker's Delight, transpose8rS32)
+// em dois registradores. Entrada: x com as pistas 7..4 e y com as 3..0, um
+// byte de cor por pista, a pista mais alta no byte mais significativo.
+// Saída: os 8 bytes do fluxo, do bit 7 ao bit 0, com o bit k para a pista k,
+// já na ordem de memória de duas palavras (o REV do Cortex-M0+).
+static inline void ws2812b_par_transpose8(uint32_t x, uint32_t y, uint32_t *out) {
+    uint32_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    out[0] = __builtin_bswap32(t);
+    out[1] = __builtin_bswap32(y);
+}
+
+// Byte de cor (deslocamento shift no formato GRB << 8) das pistas a..a-3
+#define LANE_BYTES(w, a, shift) \
+    ((((w)[a] >> (shift)) & 0xFF) << 24 | (((w)[(a) - 1] >> (shift)) & 0xFF) << 16 | \
+     (((w)[(a) - 2] >> (shift)) & 0xFF) << 8 | (((w)[(a) - 3] >> (shift)) & 0xFF))
+
+void __not_in_flash_func(ws2812b_par_transpose)(const uint32_t *pixels, uint lanes, uint leds, uint32_t *planes)
+{
+    uint32_t w[WS2812B_PAR_MAX_LANES] = {0}; // Pistas ausentes ficam em 0
+
+    for (uint i = 0; i < leds; i++) {
+        for (uint k = 0; k < lanes; k++)
+            w[k] = pixels[k * leds + i];
+        // G, R e B: 8 tempos de bit cada
+        ws2812b_par_transpose8(LANE_BYTES(w, 7, 24), LANE_BYTES(w, 3, 24), planes);
+        ws2812b_par_transpose8(LANE_BYTES(w, 7, 16), LANE_BYTES(w, 3, 16), planes + 2);
+        ws2812b_par_transpose8(LANE_BYTES(w, 7, 8), LANE_BYTES(w, 3, 8), planes + 4);
+        planes += WS2812B_PAR_WORDS_PER_LED;
+    }
+}
+
+uint32_t ws2812b_par_refresh_us(uint leds)
+{
+    return (uint32_t)(((uint64_t)leds * 24 * WS2812B_PAR_BIT_NS + 999) / 1000) + WS2812B_LATCH_US;
+}
+
+// Handler compartilhado do DMA_IRQ_0, como em ws2812b.c: o próximo quadro só
+// depois da FIFO esvaziar e do reset dos LEDs
+static void ws2812b_par_dma_irq_handler(void)
+{
+    for (uint i = 0; i < WS2812B_PAR_MAX_INSTANCES; i++) {
+        ws2812b_par_t *p = ws2812b_par_instances[i];
+        if (!p || !dma_channel_get_irq0_status(p->dma_channel)) continue;
+
+        dma_channel_acknowledge_irq0(p->dma_channel);
+        p->ready_at = make_timeout_time_us(WS2812B_PAR_FIFO_DEPTH * WS2812B_PAR_WORD_US + WS2812B_LATCH_US);
+        p->refresh_us = (uint32_t)(to_us_since_boot(p->ready_at) - p->started_us);
+        p->busy = false;
+    }
+}
+
+ws2812b_par_t *ws2812b_par_init(PIO pio, uint base_pin, uint lanes, uint leds)
+{
+    if (!lanes || lanes > WS2812B_PAR_MAX_LANES || !leds)
+        return NULL;
+
+    uint slot = 0;
+    while (slot < WS2812B_PAR_MAX_INSTANCES && ws2812b_par_instances[slot]) slot++;
+    if (slot == WS2812B_PAR_MAX_INSTANCES)
+        return NULL;
+
+    ws2812b_par_t *p = calloc(1, sizeof(ws2812b_par_t));
+    uint32_t *pixels = calloc((size_t)lanes * leds, sizeof(uint32_t));
+    uint32_t *planes = calloc((size_t)leds * WS2812B_PAR_WORDS_PER_LED, sizeof(uint32_t));
+    if (!p || !pixels || !planes) {
+        free(p);
+        free(pixels);
+        free(planes);
+        return NULL;
+    }
+    p->pixels = pixels;
+    p->planes = planes;
+    p->pio = pio;
+    p->base_pin = base_pin;
+    p->lanes = lanes;
+    p->leds = leds;
+
+    p->program_offset = pio_add_program(pio, &ws2812_parallel_program);
+    p->sm = (uint)pio_claim_unused_sm(pio, true);
+    pio_sm_config c = ws2812_parallel_program_get_default_config(p->program_offset);
+
+    // Pinos de OUT (MOV PINS): um por pista, consecutivos
+    sm_config_set_out_pins(&c, base_pin, lanes);
+    for (uint k = 0; k < lanes; k++)
+        pio_gpio_init(pio, base_pin + k);
+    pio_sm_set_consecutive_pindirs(pio, p->sm, base_pin, lanes, true);
+
+    // 10 ciclos por bit a 8 MHz, como ws2812b.pio; 4 tempos de bit por palavra
+    float div = clock_get_hz(clk_sys) / 8000000.0;
+    sm_config_set_clkdiv(&c, div);
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+    sm_config_set_out_shift(&c, true, true, 32);
+
+    pio_sm_init(pio, p->sm, p->program_offset, &c);
+    pio_sm_set_enabled(pio, p->sm, true);
+
+    // Canal de DMA: fluxo transposto para a FIFO TX no ritmo do DREQ
+    p->dma_channel = dma_claim_unused_channel(true);
+    dma_channel_config dc = dma_channel_get_default_config(p->dma_channel);
+    channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+    channel_config_set_read_increment(&dc, true);
+    channel_config_set_write_increment(&dc, false);
+    channel_config_set_dreq(&dc, pio_get_dreq(pio, p->sm, true));
+    dma_channel_configure(p->dma_channel, &dc, &pio->txf[p->sm], NULL, 0, false);
+
+    if (!ws2812b_par_irq_added) {
+        ws2812b_par_irq_added = true;
+        irq_add_shared_handler(DMA_IRQ_0, ws2812b_par_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+    }
+    ws2812b_par_instances[slot] = p;
+    dma_channel_set_irq0_enabled(p->dma_channel, true);
+    return p;
+}
+
+// Libera a máquina de estado, o programa e o canal (o handler fica
+// registrado e só ignora instâncias vazias)
+void ws2812b_par_free(ws2812b_par_t *p)
+{
+    if (!p) return;
+    ws2812b_par_wait(p);
+    dma_channel_set_irq0_enabled(p->dma_channel, false);
+    dma_channel_unclaim(p->dma_channel);
+    pio_sm_set_enabled(p->pio, p->sm, false);
+    pio_sm_unclaim(p->pio, p->sm);
+    pio_remove_program(p->pio, &ws2812_parallel_program, p->program_offset);
+    for (uint i = 0; i < WS2812B_PAR_MAX_INSTANCES; i++)
+        if (ws2812b_par_instances[i] == p) ws2812b_par_instances[i] = NULL;
+    free(p->pixels);
+    free(p->planes);
+    free(p);
+}
+
+void ws2812b_par_set_pixel(ws2812b_par_t *p, uint lane, uint index, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (lane >= p->lanes || index >= p->leds) return;
+    p->pixels[lane * p->leds + index] = ((uint32_t)(g) << 24) |
+                                        ((uint32_t)(r) << 16) |
+                                        ((uint32_t)(b) << 8);
+}
+
+void ws2812b_par_clear(ws2812b_par_t *p)
+{
+    memset(p->pixels, 0, (size_t)p->lanes * p->leds * sizeof(uint32_t));
+}
+
+bool ws2812b_par_present(ws2812b_par_t *p)
+{
+    if (ws2812b_par_is_busy(p)) return false;
+
+    ws2812b_par_transpose(p->pixels, p->lanes, p->leds, p->planes);
+    p->busy = true;
+    p->started_us = time_us_64();
+    p->frames_sent++;
+    dma_channel_transfer_from_buffer_now(p->dma_channel, p->planes, p->leds * WS2812B_PAR_WORDS_PER_LED);
+    return true;
+}
+
+bool ws2812b_par_is_busy(const ws2812b_par_t *p)
+{
+    return p->busy || !time_reached(p->ready_at);
+}
+
+void ws2812b_par_wait(const ws2812b_par_t *p)
+{
+    while (ws2812b_par_is_busy(p)) tight_loop_contents();
+}
@@ -0,0 +1,66 @@
+#ifndef WS2812B_PAR_H
+#define WS2812B_PAR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+// Várias cadeias WS2812B (painéis) em pinos consecutivos, atualizadas ao
+// mesmo tempo por uma só máquina de estado (ws2812b_parallel.pio) e um só
+// canal de DMA. Um quadro leva o tempo de uma cadeia, com 1 ou 8 pistas.
+//
+// Cada pista tem seu framebuffer no mesmo formato de ws2812b.h (GRB já
+// deslocado, um uint32_t por LED). ws2812b_par_present() transpõe os bits
+// das pistas para o fluxo do PIO, em que cada byte é um tempo de bit com o
+// bit k para a pista k, e o entrega ao DMA sem esperar.
+//
+// Fluxo: para cada LED, 24 bytes (G7..G0, R7..R0, B7..B0), 4 por palavra,
+// o primeiro no byte menos significativo (o OSR desloca para a direita).
+
+#define WS2812B_PAR_MAX_LANES 8
+#define WS2812B_PAR_MAX_INSTANCES 2
+#define WS2812B_PAR_WORDS_PER_LED 6  // 24 tempos de bit de 1 byte
+#define WS2812B_PAR_BIT_NS 1250      // 800 kHz
+#define WS2812B_PAR_WORD_US 5        // 4 tempos de bit por palavra
+
+typedef struct ws2812b_par ws2812b_par_t;
+
+struct ws2812b_par {
+    PIO pio;
+    uint sm;
+    uint program_offset;
+    uint base_pin;                  // Pista k no pino base_pin + k
+    uint lanes;
+    uint leds;                      // LEDs por pista (o mesmo em todas)
+    uint32_t *pixels;               // lanes * leds, pista k a partir de pixels[k * leds]
+    uint32_t *planes;               // leds * WS2812B_PAR_WORDS_PER_LED, lido pelo DMA
+    int dma_channel;
+    volatile bool busy;             // DMA em andamento
+    volatile absolute_time_t ready_at;
+    uint64_t started_us;            // Início do quadro em andamento
+    volatile uint32_t refresh_us;   // Medido no último quadro: DMA, FIFO e reset
+    uint32_t frames_sent;
+};
+
+ws2812b_par_t *ws2812b_par_init(PIO pio, uint base_pin, uint lanes, uint leds);
+void ws2812b_par_free(ws2812b_par_t *p);
+
+void ws2812b_par_set_pixel(ws2812b_par_t *p, uint lane, uint index, uint8_t r, uint8_t g, uint8_t b);
+void ws2812b_par_clear(ws2812b_par_t *p);
+
+// Transpõe e inicia o DMA; false (nada enviado) se o quadro anterior ainda
+// não terminou, com o framebuffer intacto para a próxima tentativa
+bool ws2812b_par_present(ws2812b_par_t *p);
+bool ws2812b_par_is_busy(const ws2812b_par_t *p);
+void ws2812b_par_wait(const ws2812b_par_t *p);
+
+// Tempo de um quadro com leds por pista, independente do número de pistas
+// (o mesmo número de LEDs numa cadeia só levaria lanes vezes o tempo de dados)
+uint32_t ws2812b_par_refresh_us(uint leds);
+
+// Núcleo da transposição: pixels de lanes pistas (<= 8, as ausentes valem
+// 0) para leds * WS2812B_PAR_WORDS_PER_LED palavras do fluxo
+void ws2812b_par_transpose(const uint32_t *pixels, uint lanes, uint leds, uint32_t *planes);
+
+#endif // WS2812B_PAR_H
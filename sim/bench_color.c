@@ -0,0 +1,157 @@
+// Benchmark e verificação no host do classificador de cor (lib/color_class.h).
+//
+// 1. Compara a matiz em ponto fixo com uma referência em float (só no host)
+//    sobre entradas sorteadas: falha se o erro sobre os canais já reduzidos
+//    a 8 bits passa de MAX_HUE_ERR8 ou se mais de MAX_CLASS_DIFF das classes
+//    diverge da referência em precisão total.
+// 2. Confere o conjunto rotulado (sim/data/color_labels.csv), sem erros.
+// 3. Mede classificações por segundo no host, ao lado do teste de canal
+//    dominante que o firmware usava (r > g && r > b).
+//
+// Uso: colorlux_bench_color [conjunto.csv]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "color_class.h"
+#include "check.h"
+
+#define RANDOM_SAMPLES 1000000
+#define BENCH_SAMPLES 4096
+#define BENCH_ROUNDS 2000
+
+// Limites da comparação com a referência: erro dos recíprocos sobre os
+// canais em 8 bits e classes que mudam com a redução a 8 bits (junto às
+// fronteiras das faixas)
+#define MAX_HUE_ERR8 1.0
+#define MAX_CLASS_DIFF 0.005
+
+static const color_class_config_t cfg = {
+    .gain_r = 256, .gain_g = 256, .gain_b = 256,
+    .min_saturation = 48,
+    .min_value = 8,
+};
+
+static uint32_t seed = 12345;
+
+static uint16_t rand16(void) {
+    seed = seed * 1103515245u + 12345u;
+    return (uint16_t)(seed >> 16);
+}
+
+// Hexágono de matiz em double, sem a redução a 8 bits
+static double reference_hue(uint16_t r, uint16_t g, uint16_t b) {
+    double max = r > g ? r : g, min = r < g ? r : g;
+    max = max > b ? max : b;
+    min = min < b ? min : b;
+    double c = max - min, h;
+    if (max == r) h = (g - b) / c;
+    else if (max == g) h = 2 + (b - r) / c;
+    else h = 4 + (r - g) / c;
+    h *= COLOR_HUE_SECTOR;
+    return h < 0 ? h + COLOR_HUE_TURN : h;
+}
+
+// Distância em unidades de matiz, dando a volta no 0
+static double hue_distance(double a, double b) {
+    double err = a - b;
+    if (err > COLOR_HUE_TURN / 2) err -= COLOR_HUE_TURN;
+    if (err < -COLOR_HUE_TURN / 2) err += COLOR_HUE_TURN;
+    return err < 0 ? -err : err;
+}
+
+static void check_reference(void) {
+    uint32_t chromatic = 0, class_diff = 0;
+    double err_sum = 0, err_max = 0, err8_max = 0;
+    for (int i = 0; i < RANDOM_SAMPLES; i++) {
+        // Metade com brilho baixo (sem redução) e metade em toda a escala
+        uint16_t mask = (i & 1) ? 0xFFFF : 0xFF;
+        uint16_t r = rand16() & mask, g = rand16() & mask, b = rand16() & mask;
+        color_class_result_t res = color_classify(&cfg, r, g, b);
+        if (res.cls == COLOR_CLASS_DARK || res.cls == COLOR_CLASS_NEUTRAL)
+            continue;
+        chromatic++;
+        double ref = reference_hue(r, g, b);
+        double err = hue_distance(res.hue, ref);
+        err_sum += err;
+        if (err > err_max) err_max = err;
+
+        // Os mesmos canais reduzidos a 8 bits que o classificador usa: o que
+        // sobra é o erro dos recíprocos
+        uint16_t max = r > g ? r : g;
+        max = max > b ? max : b;
+        uint8_t shift = 0;
+        while ((max >> shift) > 0xFF)
+            shift++;
+        double err8 = hue_distance(res.hue, reference_hue(r >> shift, g >> shift, b >> shift));
+        if (err8 > err8_max) err8_max = err8;
+        int ref_h = (int)ref % COLOR_HUE_TURN;
+        if (color_hue_class[ref_h >> COLOR_HUE_LUT_SHIFT] != res.cls)
+            class_diff++;
+    }
+    printf("referência float: %u cromáticas, erro de matiz médio %.2f, máx %.1f unidades (de %d)\n",
+           chromatic, err_sum / chromatic, err_max, COLOR_HUE_TURN);
+    printf("                  máx %.2f unidades sobre os canais em 8 bits\n", err8_max);
+    printf("                  %u classes diferentes (%.3f%%, só junto às fronteiras)\n",
+           class_diff, 100.0 * class_diff / chromatic);
+    CHECK(err8_max <= MAX_HUE_ERR8, "erro de matiz %.2f sobre os canais em 8 bits (limite %.1f)",
+          err8_max, MAX_HUE_ERR8);
+    CHECK(class_diff <= MAX_CLASS_DIFF * chromatic, "%.3f%% das classes diferem da referência (limite %.1f%%)",
+          100.0 * class_diff / chromatic, 100.0 * MAX_CLASS_DIFF);
+}
+
+static void check_labeled(const char *path) {
+    FILE *f = fopen(path, "r");
+    CHECK(f, "%s não abre", path);
+    if (!f)
+        return;
+    char line[128], label[32];
+    unsigned r, g, b;
+    int total = 0, ok = 0;
+    while (fgets(line, sizeof line, f)) {
+        if (sscanf(line, "%u,%u,%u,%31s", &r, &g, &b, label) != 4)
+            continue; // Comentário ou cabeçalho
+        color_class_result_t res = color_classify(&cfg, (uint16_t)r, (uint16_t)g, (uint16_t)b);
+        const char *got = color_class_name(res.cls);
+        total++;
+        if (!strcmp(got, label))
+            ok++;
+        else
+            printf("  erro: %5u %5u %5u esperado %-9s obtido %-9s (matiz %u, sat %u)\n",
+                   r, g, b, label, got, res.hue, res.saturation);
+    }
+    fclose(f);
+    printf("conjunto rotulado: %d/%d corretas (%.1f%%)\n", ok, total, total ? 100.0 * ok / total : 0);
+    CHECK(total > 0 && ok == total, "conjunto rotulado: %d de %d erradas", total - ok, total);
+}
+
+static void bench(void) {
+    static uint16_t in[BENCH_SAMPLES][3];
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+        for (int k = 0; k < 3; k++)
+            in[i][k] = rand16();
+
+    volatile uint32_t sink = 0;
+    uint64_t t0 = host_ns();
+    for (int n = 0; n < BENCH_ROUNDS; n++)
+        for (int i = 0; i < BENCH_SAMPLES; i++)
+            sink += color_classify(&cfg, in[i][0], in[i][1], in[i][2]).cls;
+    uint64_t t1 = host_ns();
+    for (int n = 0; n < BENCH_ROUNDS; n++)
+        for (int i = 0; i < BENCH_SAMPLES; i++)
+            sink += in[i][0] > in[i][1] && in[i][0] > in[i][2];
+    uint64_t t2 = host_ns();
+
+    double count = (double)BENCH_ROUNDS * BENCH_SAMPLES;
+    printf("classificador:    %6.1f M/s (%.1f ns cada)\n", count / (t1 - t0) * 1e3, (t1 - t0) / count);
+    printf("canal dominante:  %6.1f M/s (%.1f ns cada)\n", count / (t2 - t1) * 1e3, (t2 - t1) / count);
+    (void)sink;
+}
+
+int main(int argc, char **argv) {
+    const char *labels = argc > 1 ? argv[1] : COLORLUX_DATA_DIR "/color_labels.csv";
+    check_reference();
+    check_labeled(labels);
+    bench();
+    return check_exit("bench_color");
+}
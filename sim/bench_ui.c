@@ -0,0 +1,146 @@
+// Benchmark no host do desenho do display: redesenho completo a cada quadro
+// (fill + sprintf + draw_string, como o firmware fazia) contra a interface
+// retida de lib/ui.h, com a mesma sequência de amostras e a mesma tela (a do
+// firmware atual, com o lux em dígitos 2x). Cada quadro dos dois caminhos tem
+// que deixar o framebuffer igual; só muda a forma de chegar nele.
+//
+// Mede o tempo de CPU do host por quadro (só para comparação relativa; o
+// M0+ é ordens de grandeza mais lento) e os bytes enviados ao SSD1306 pelo
+// flush parcial, que não dependem do host.
+//
+// Uso: colorlux_bench_ui [quadros]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "ssd1306.h"
+#include "ui.h"
+#include "check.h"
+
+typedef struct {
+    uint16_t r, g, b, lux;
+} bench_sample_t;
+
+// Passeio aleatório com trechos parados, parecido com leituras reais
+static void make_samples(bench_sample_t *s, int n) {
+    uint32_t seed = 12345;
+    bench_sample_t cur = {300, 400, 250, 200};
+    for (int i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        if ((seed >> 16) % 4) {
+            cur.r += (int16_t)((seed >> 8) % 21) - 10;
+            cur.g += (int16_t)((seed >> 12) % 21) - 10;
+            cur.b += (int16_t)((seed >> 4) % 21) - 10;
+            if ((seed >> 20) % 8 == 0) cur.lux = (uint16_t)((seed >> 3) % 5000);
+        }
+        s[i] = cur;
+    }
+}
+
+// Tela do firmware (display_layout em Luminosidade-Cores.c)
+static void legacy_draw(ssd1306_t *ssd, const bench_sample_t *s) {
+    char str_lux[12], str_red[12], str_green[12], str_blue[12];
+    sprintf(str_red, "R:%-5u", s->r);
+    sprintf(str_green, "G:%-5u", s->g);
+    sprintf(str_blue, "B:%-5u", s->b);
+    sprintf(str_lux, "%-5u", s->lux);
+
+    ssd1306_fill(ssd, false);
+    ssd1306_draw_string(ssd, "CEPEDI TIC37", 8, 6);
+    ssd1306_draw_string(ssd, "EMBARCATECH", 20, 16);
+    ssd1306_draw_string(ssd, "Lux", 4, 30);
+    ssd1306_draw_string_scaled(ssd, str_lux, 40, 26, 2);
+    ssd1306_draw_string(ssd, str_red, 4, 46);
+    ssd1306_draw_string(ssd, str_green, 64, 46);
+    ssd1306_draw_string(ssd, str_blue, 4, 56);
+}
+
+// FNV-1a do framebuffer, para comparar as telas dos dois caminhos
+static uint32_t frame_hash(const ssd1306_t *ssd) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 1; i < ssd->bufsize; i++)
+        h = (h ^ ssd->ram_buffer[i]) * 16777619u;
+    return h;
+}
+
+typedef struct {
+    uint64_t draw_ns;
+    uint64_t flush_ns;
+    uint32_t bytes;
+    uint32_t transactions;
+} bench_result_t;
+
+static void report(const char *name, const bench_result_t *r, int frames) {
+    printf("%-8s draw %7.0f ns/quadro  flush %7.0f ns/quadro  i2c %6.1f bytes/quadro  %4.2f transações/quadro\n",
+           name, (double)r->draw_ns / frames, (double)r->flush_ns / frames,
+           (double)r->bytes / frames, (double)r->transactions / frames);
+}
+
+int main(int argc, char **argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 20000;
+    if (frames <= 0) frames = 20000;
+    bench_sample_t *samples = malloc(sizeof(*samples) * frames);
+    uint32_t *hashes = malloc(sizeof(*hashes) * frames);
+    make_samples(samples, frames);
+
+    sim_devices_init();
+    i2c_init(i2c1, 400 * 1000);
+    ssd1306_t ssd;
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c1);
+    ssd1306_config(&ssd);
+
+    // Redesenho completo
+    bench_result_t legacy = {0};
+    ssd1306_invalidate(&ssd);
+    sim_bus_stats_t before = sim_i2c_stats[1];
+    for (int i = 0; i < frames; i++) {
+        uint64_t t0 = host_ns();
+        legacy_draw(&ssd, &samples[i]);
+        uint64_t t1 = host_ns();
+        ssd1306_send_data(&ssd);
+        hashes[i] = frame_hash(&ssd);
+        legacy.draw_ns += t1 - t0;
+        legacy.flush_ns += host_ns() - t1;
+    }
+    legacy.bytes = sim_i2c_stats[1].bytes - before.bytes;
+    legacy.transactions = sim_i2c_stats[1].transactions - before.transactions;
+
+    // Interface retida
+    bench_result_t retained = {0};
+    ui_t ui;
+    ui_init(&ui, &ssd);
+    ui_add_label(&ui, "CEPEDI TIC37", 8, 6);
+    ui_add_label(&ui, "EMBARCATECH", 20, 16);
+    ui_add_label(&ui, "Lux", 4, 30);
+    int lux = ui_add_big_number(&ui, 5, 2, 40, 26);
+    int red = ui_add_number(&ui, "R:", 5, 4, 46);
+    int green = ui_add_number(&ui, "G:", 5, 64, 46);
+    int blue = ui_add_number(&ui, "B:", 5, 4, 56);
+    ssd1306_invalidate(&ssd);
+    before = sim_i2c_stats[1];
+    int differing = 0;
+    for (int i = 0; i < frames; i++) {
+        uint64_t t0 = host_ns();
+        ui_set_number(&ui, red, samples[i].r);
+        ui_set_number(&ui, green, samples[i].g);
+        ui_set_number(&ui, blue, samples[i].b);
+        ui_set_number(&ui, lux, samples[i].lux);
+        bool changed = ui_render(&ui);
+        uint64_t t1 = host_ns();
+        if (changed) ssd1306_send_data(&ssd);
+        retained.draw_ns += t1 - t0;
+        retained.flush_ns += host_ns() - t1;
+        if (frame_hash(&ssd) != hashes[i] && !differing++)
+            printf("  quadro %d difere entre o redesenho completo e a interface retida\n", i);
+    }
+    retained.bytes = sim_i2c_stats[1].bytes - before.bytes;
+    retained.transactions = sim_i2c_stats[1].transactions - before.transactions;
+
+    printf("%d quadros\n", frames);
+    report("completo", &legacy, frames);
+    report("retido", &retained, frames);
+    CHECK(differing == 0, "%d de %d quadros com telas diferentes", differing, frames);
+    free(samples);
+    free(hashes);
+    return check_exit("bench_ui");
+}
@@ -0,0 +1,154 @@
+// Verificação e benchmark no host da saída paralela de WS2812B
+// (lib/ws2812b_par.h).
+//
+// 1. Confere a transposição contra uma referência bit a bit (o que o
+//    ws2812b_parallel.pio faz com cada byte do fluxo) para 1 a 8 pistas e
+//    tamanhos variados, e a volta: cada pista decodificada do fluxo é igual
+//    ao seu framebuffer.
+// 2. Mede a transposição no host contra a referência.
+// 3. Tempo de quadro por número de pistas: o medido pelo driver sobre o
+//    DMA/PIO simulados, o calculado e o de uma cadeia única com os mesmos LEDs.
+// 4. Ciclos por bit do programa PIO (sim/generated/ws2812b_parallel.pio.h,
+//    espelho do ws2812b_parallel.pio): 10, como o ws2812b.pio, que é o que o
+//    divisor de 8 MHz e WS2812B_PAR_WORD_US supõem.
+//
+// Uso: colorlux_bench_ws2812b_par [leds por pista]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "ws2812b_par.h"
+#include "generated/ws2812b_parallel.pio.h"
+#include "check.h"
+
+#define BENCH_LEDS 256
+#define BENCH_ROUNDS 2000
+#define PIO_CYCLES_PER_BIT 10
+
+static uint32_t seed = 12345;
+
+static uint32_t rand32(void) {
+    seed = seed * 1103515245u + 12345u;
+    uint32_t hi = seed >> 16;
+    seed = seed * 1103515245u + 12345u;
+    return hi << 16 | seed >> 16;
+}
+
+// Referência: byte j do LED i tem o bit k igual ao bit (31 - j) da pista k
+static void reference_transpose(const uint32_t *pixels, uint lanes, uint leds, uint32_t *planes) {
+    uint8_t *out = (uint8_t *)planes;
+    for (uint i = 0; i < leds; i++) {
+        for (uint j = 0; j < 24; j++) {
+            uint8_t v = 0;
+            for (uint k = 0; k < lanes; k++)
+                v |= ((pixels[k * leds + i] >> (31 - j)) & 1u) << k;
+            out[i * 24 + j] = v;
+        }
+    }
+}
+
+// O que cada pino recebe: as palavras saem do OSR pelo byte menos significativo
+static uint32_t decode_lane(const uint32_t *planes, uint led, uint lane) {
+    uint32_t grb = 0;
+    for (uint j = 0; j < 24; j++) {
+        uint32_t word = planes[(led * 24 + j) / 4];
+        uint8_t byte = (uint8_t)(word >> (8 * ((led * 24 + j) % 4)));
+        grb |= (uint32_t)((byte >> lane) & 1u) << (31 - j);
+    }
+    return grb;
+}
+
+static void check_transpose(uint lanes, uint leds) {
+    uint32_t *pixels = malloc(sizeof(uint32_t) * lanes * leds);
+    uint32_t *got = malloc(sizeof(uint32_t) * leds * WS2812B_PAR_WORDS_PER_LED);
+    uint32_t *want = malloc(sizeof(uint32_t) * leds * WS2812B_PAR_WORDS_PER_LED);
+    for (uint i = 0; i < lanes * leds; i++)
+        pixels[i] = rand32() & 0xFFFFFF00u; // GRB << 8, como ws2812b_par_set_pixel
+    ws2812b_par_transpose(pixels, lanes, leds, got);
+    reference_transpose(pixels, lanes, leds, want);
+    CHECK(!memcmp(got, want, sizeof(uint32_t) * leds * WS2812B_PAR_WORDS_PER_LED),
+          "%u pistas, %u LEDs: fluxo diferente da referência", lanes, leds);
+    uint bad = 0;
+    for (uint k = 0; k < lanes; k++)
+        for (uint i = 0; i < leds; i++)
+            if (decode_lane(got, i, k) != pixels[k * leds + i])
+                bad++;
+    CHECK(bad == 0, "%u pistas, %u LEDs: %u LEDs decodificados errados", lanes, leds, bad);
+    for (uint k = lanes; k < WS2812B_PAR_MAX_LANES; k++)
+        for (uint i = 0; i < leds; i++)
+            if (decode_lane(got, i, k))
+                bad++;
+    CHECK(bad == 0, "%u pistas: pista ausente com bits ligados", lanes);
+    free(pixels);
+    free(got);
+    free(want);
+}
+
+// O programa não tem desvios: cada instrução leva 1 ciclo mais o atraso
+// (bits 12:8, sem side-set)
+static uint program_cycles(const pio_program_t *prog) {
+    uint cycles = 0;
+    for (uint i = 0; i < prog->length; i++)
+        cycles += 1 + ((prog->instructions[i] >> 8) & 0x1F);
+    return cycles;
+}
+
+int main(int argc, char **argv) {
+    uint leds = argc > 1 ? (uint)atoi(argv[1]) : BENCH_LEDS;
+    if (!leds) {
+        fprintf(stderr, "uso: %s [leds por pista]\n", argv[0]);
+        return 2;
+    }
+
+    // 1. Correção
+    static const uint sizes[] = {1, 2, 3, 25, 64, 257};
+    for (uint lanes = 1; lanes <= WS2812B_PAR_MAX_LANES; lanes++)
+        for (uint s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+            check_transpose(lanes, sizes[s]);
+
+    // 2. Vazão da transposição (8 pistas)
+    uint32_t *pixels = malloc(sizeof(uint32_t) * WS2812B_PAR_MAX_LANES * leds);
+    uint32_t *planes = malloc(sizeof(uint32_t) * leds * WS2812B_PAR_WORDS_PER_LED);
+    for (uint i = 0; i < WS2812B_PAR_MAX_LANES * leds; i++)
+        pixels[i] = rand32() & 0xFFFFFF00u;
+    uint64_t t0 = host_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        ws2812b_par_transpose(pixels, WS2812B_PAR_MAX_LANES, leds, planes);
+    uint64_t t1 = host_ns();
+    for (int r = 0; r < BENCH_ROUNDS / 10; r++)
+        reference_transpose(pixels, WS2812B_PAR_MAX_LANES, leds, planes);
+    uint64_t t2 = host_ns();
+    double fast_ns = (double)(t1 - t0) / BENCH_ROUNDS;
+    double ref_ns = (double)(t2 - t1) / (BENCH_ROUNDS / 10);
+    printf("transposição de 8x%u LEDs no host: %.1f us por quadro (%.2f ns/LED), referência bit a bit %.1f us (%.1fx)\n",
+           leds, fast_ns / 1000, fast_ns / (WS2812B_PAR_MAX_LANES * leds), ref_ns / 1000, ref_ns / fast_ns);
+
+    // 3. Tempo de quadro por número de pistas, sobre o DMA/PIO simulados
+    printf("\n%6s %6s %12s %12s %14s\n", "pistas", "LEDs", "medido_us", "calculado_us", "cadeia_unica_us");
+    for (uint lanes = 1; lanes <= WS2812B_PAR_MAX_LANES; lanes++) {
+        ws2812b_par_t *p = ws2812b_par_init(pio0, 0, lanes, leds);
+        CHECK(p != NULL, "%u pistas: init", lanes);
+        if (!p) break;
+        for (uint k = 0; k < lanes; k++)
+            for (uint i = 0; i < leds; i++)
+                ws2812b_par_set_pixel(p, k, i, (uint8_t)i, (uint8_t)k, 0x55);
+        CHECK(ws2812b_par_present(p), "%u pistas: quadro recusado", lanes);
+        CHECK(!ws2812b_par_present(p), "%u pistas: segundo quadro aceito durante o primeiro", lanes);
+        ws2812b_par_wait(p);
+        uint32_t serial = ws2812b_par_refresh_us(lanes * leds); // Mesmos LEDs numa cadeia
+        printf("%6u %6u %12u %12u %14u\n", lanes, lanes * leds, p->refresh_us, ws2812b_par_refresh_us(leds), serial);
+        CHECK(p->refresh_us <= ws2812b_par_refresh_us(leds) + 2 * WS2812B_PAR_WORD_US,
+              "%u pistas: quadro de %u us", lanes, p->refresh_us);
+        ws2812b_par_free(p);
+    }
+
+    // 4. Ritmo do programa
+    uint cycles = program_cycles(&ws2812_parallel_program);
+    printf("\nprograma PIO: %u ciclos por bit\n", cycles);
+    CHECK(cycles == PIO_CYCLES_PER_BIT, "programa PIO com %u ciclos por bit (esperado %u)", cycles, PIO_CYCLES_PER_BIT);
+
+    free(pixels);
+    free(planes);
+    return check_exit("ws2812b_par");
+}
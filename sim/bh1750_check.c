@@ -0,0 +1,131 @@
+// Verificação no host do BH1750 em modo contínuo (lib/sensores.c) sobre o
+// I2C assíncrono e o modelo do sensor de sim_devices.c.
+//
+// Confere que:
+//   - bh1750_poll() nunca bloqueia: o relógio virtual não anda dentro dela,
+//     nem quando enfileira uma leitura;
+//   - depois da leitura rápida em baixa resolução há uma leitura por período
+//     de conversão (BH1750_CONV_TIME_MS), nem mais nem menos, com o laço
+//     chamando bh1750_poll() a cada POLL_US;
+//   - uma mudança de luz aparece no máximo dois períodos depois.
+// Depois mede o período de um laço com LOOP_WORK_US de outras tarefas lendo
+// o lux como o firmware antigo (CONT_HRES de novo e 200 ms de espera a cada
+// leitura) e com bh1750_poll(): o novo tem que ser ~200 ms mais curto.
+//
+// Uso: colorlux_bh1750_check
+
+#include <stdio.h>
+#include "sim.h"
+#include "sensores.h"
+#include "check.h"
+
+#define POLL_US 1000
+#define RUN_US 3000000
+#define I2C_BAUD 400000
+#define LOOP_WORK_US 20000     // Resto do laço (cor, LEDs, display)
+#define LOOP_ITERATIONS 20
+#define LEGACY_WAIT_MS 200
+#define PERIOD_TOLERANCE_US 5000
+
+// A leitura antiga: reinicia a conversão, espera e lê, tudo bloqueando
+static uint16_t legacy_read(void) {
+    uint8_t cmd = _CONT_HRES_C, rx[2] = {0, 0};
+    i2c_async_txn_t write = {.addr = BH1750_I2C_ADDR, .tx = &cmd, .tx_len = 1};
+    i2c_async_transfer_blocking(&write);
+    sleep_ms(LEGACY_WAIT_MS);
+    i2c_async_txn_t read = {.addr = BH1750_I2C_ADDR, .rx = rx, .rx_len = 2};
+    i2c_async_transfer_blocking(&read);
+    return (uint16_t)((((uint16_t)rx[0] << 8) | rx[1]) * 5 / 6);
+}
+
+// Período médio do laço, em us
+static double loop_period_us(bool legacy) {
+    uint64_t start = sim_now_us();
+    for (int i = 0; i < LOOP_ITERATIONS; i++) {
+        uint16_t lux;
+        if (legacy)
+            lux = legacy_read();
+        else
+            bh1750_poll(&lux);
+        (void)lux;
+        sim_advance_to(sim_now_us() + LOOP_WORK_US);
+    }
+    return (double)(sim_now_us() - start) / LOOP_ITERATIONS;
+}
+
+int main(void) {
+    static const sim_scene_t dim = {100, 0, 0, 0, 0};
+    static const sim_scene_t bright = {2000, 0, 0, 0, 0};
+    sim_devices_init();
+    sim_set_scene(&dim);
+    i2c_init(i2c0, I2C_BAUD);
+    i2c_async_init(i2c0);
+
+    bh1750_power_on();
+    bh1750_start();
+
+    uint32_t blocked = 0, polls = 0, fresh = 0;
+    uint32_t reads = 0, min_gap_us = UINT32_MAX, max_gap_us = 0;
+    uint64_t last_read_us = 0, change_at = 0, seen_at = 0;
+    uint32_t txns = sim_i2c_stats[0].transactions;
+    while (sim_now_us() < RUN_US) {
+        uint64_t before = sim_now_us();
+        uint16_t lux;
+        bool got = bh1750_poll(&lux);
+        polls++;
+        if (sim_now_us() != before)
+            blocked++;
+
+        // Cada transação nova no barramento depois do modo contínuo é uma leitura
+        if (sim_i2c_stats[0].transactions != txns && bh1750_get_state() == BH1750_STATE_RUNNING) {
+            uint64_t now = sim_now_us();
+            if (last_read_us && fresh > 1) {
+                uint32_t gap = (uint32_t)(now - last_read_us);
+                if (gap < min_gap_us) min_gap_us = gap;
+                if (gap > max_gap_us) max_gap_us = gap;
+                reads++;
+            }
+            last_read_us = now;
+        }
+        txns = sim_i2c_stats[0].transactions;
+
+        if (got) {
+            fresh++;
+            if (change_at && !seen_at && lux > 1000)
+                seen_at = sim_now_us();
+        }
+        if (!change_at && sim_now_us() >= RUN_US / 2) {
+            sim_set_scene(&bright);
+            change_at = sim_now_us();
+        }
+        sim_advance_to(before + POLL_US);
+    }
+
+    uint32_t expected = (RUN_US - BH1750_CONV_TIME_MS * 1000) / (BH1750_CONV_TIME_MS * 1000);
+    printf("%u chamadas, %u leituras novas, %u leituras contínuas (esperado ~%u), intervalo %u..%u us\n",
+           polls, fresh, reads, expected, min_gap_us, max_gap_us);
+    printf("mudança de luz vista %llu ms depois\n", (unsigned long long)(seen_at - change_at) / 1000);
+
+    CHECK(blocked == 0, "bh1750_poll bloqueou em %u de %u chamadas", blocked, polls);
+    CHECK(min_gap_us >= BH1750_CONV_TIME_MS * 1000,
+          "leitura %u us depois da anterior (antes do fim da conversão)", min_gap_us);
+    CHECK(max_gap_us <= BH1750_CONV_TIME_MS * 1000 + 2 * POLL_US,
+          "leitura %u us depois da anterior (mais de um período)", max_gap_us);
+    CHECK(reads + 1 >= expected && reads <= expected + 1, "%u leituras, esperado ~%u", reads, expected);
+    CHECK(bh1750_get_state() == BH1750_STATE_RUNNING, "BH1750 não está em modo contínuo");
+    CHECK(seen_at && seen_at - change_at <= 2 * BH1750_CONV_TIME_MS * 1000,
+          "mudança de luz vista %llu us depois", (unsigned long long)(seen_at - change_at));
+
+    double legacy_us = loop_period_us(true);
+    double poll_us = loop_period_us(false);
+    double saved_us = legacy_us - poll_us;
+    printf("período do laço: %.1f ms com a leitura antiga, %.1f ms com bh1750_poll (%.1f ms a menos)\n",
+           legacy_us / 1000, poll_us / 1000, saved_us / 1000);
+    CHECK(saved_us >= LEGACY_WAIT_MS * 1000 - PERIOD_TOLERANCE_US &&
+              saved_us <= LEGACY_WAIT_MS * 1000 + PERIOD_TOLERANCE_US,
+          "laço %.0f us mais curto, esperado ~%u us", saved_us, LEGACY_WAIT_MS * 1000);
+    CHECK(poll_us <= LOOP_WORK_US + PERIOD_TOLERANCE_US, "laço novo de %.0f us com %u us de trabalho", poll_us,
+          LOOP_WORK_US);
+
+    return check_exit("bh1750");
+}
@@ -0,0 +1,88 @@
+// Verificação no host do boot do firmware (boot_core0() e outputs_init(),
+// os mesmos do main e do núcleo 1) sobre o relógio virtual.
+//
+// Confere que:
+//   - os sensores ligam antes do núcleo 1 iniciar as saídas e todos os
+//     marcos de lib/boot.h acontecem na ordem exigida;
+//   - a primeira amostra válida sai em até BOOT_FIRST_SAMPLE_MAX_US, já com
+//     o lux medido (nada de lux 0 antes da primeira leitura do BH1750);
+//   - o primeiro quadro com dados sai até um período do display depois dela;
+//   - numa cena iluminada o buzzer não alerta durante o boot;
+//   - depois da leitura rápida o BH1750 segue em modo contínuo.
+//
+// Uso: colorlux_boot_check
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "check.h"
+
+static int sim_printf(const char *fmt, ...) {
+    (void)fmt;
+    return 0;
+}
+
+#define printf sim_printf
+#define main firmware_main
+#include "../Luminosidade-Cores.c"
+#undef main
+#undef printf
+
+#define BOOT_FIRST_SAMPLE_MAX_US 60000  // Leitura rápida do BH1750 e uma integração do GY-33
+#define BOOT_RUN_US 600000              // Três conversões do BH1750 em alta resolução
+
+int main(void) {
+    static const sim_scene_t lit = {200, 300, 400, 250, 1000}; // Interior
+    sim_devices_init();
+    sim_flash_reset();
+    sim_set_scene(&lit);
+
+    boot_core0();
+    sim_core_num = 1;
+    outputs_init();
+    sim_core_num = 0;
+
+    uint32_t first_seq_lux = 0;
+    bool first_seen = false, buzzer_quiet = true;
+    uint32_t lux_reads = 0;
+    absolute_time_t last_lux_at = bh1750_sample_time();
+    while (sim_now_us() < BOOT_RUN_US) {
+        uint64_t next0 = sched_run_pending(&sensors_sched);
+        sim_core_num = 1;
+        uint64_t next1 = sched_run_pending(&outputs_sched);
+        sim_core_num = 0;
+
+        if (!first_seen && sample_ring.head) {
+            first_seen = true;
+            first_seq_lux = sample_ring.items[0].lux;
+        }
+        if (sim_pwm_level[BUZZER_PIN]) buzzer_quiet = false;
+        if (to_us_since_boot(bh1750_sample_time()) != to_us_since_boot(last_lux_at)) {
+            last_lux_at = bh1750_sample_time();
+            lux_reads++;
+        }
+
+        if (sched_has_pending(&sensors_sched) || sched_has_pending(&outputs_sched))
+            continue;
+        best_effort_wfe_or_timeout(next0 < next1 ? next0 : next1);
+    }
+
+    for (int m = 0; m < BOOT_MARK_COUNT; m++)
+        printf("%-17s %8.1f ms\n", boot_mark_name(m), boot_mark_us(m) / 1000.0);
+
+    CHECK(boot_in_order(), "marcos fora de ordem ou ausentes");
+    CHECK(boot_mark_us(BOOT_SENSORS_STARTED) <= boot_mark_us(BOOT_OUTPUTS_STARTED),
+          "sensores ligados depois das saídas");
+    CHECK(boot_mark_us(BOOT_FIRST_SAMPLE) && boot_mark_us(BOOT_FIRST_SAMPLE) <= BOOT_FIRST_SAMPLE_MAX_US,
+          "primeira amostra em %u us (limite %u)", boot_mark_us(BOOT_FIRST_SAMPLE), BOOT_FIRST_SAMPLE_MAX_US);
+    CHECK(first_seen && first_seq_lux > 0, "primeira amostra sem lux (%u)", first_seq_lux);
+    CHECK(boot_mark_us(BOOT_FIRST_FRAME) &&
+          boot_mark_us(BOOT_FIRST_FRAME) - boot_mark_us(BOOT_FIRST_SAMPLE) <= DISPLAY_TASK_PERIOD_US + DISPLAY_TASK_DEADLINE_US,
+          "primeiro quadro %u us depois da primeira amostra",
+          boot_mark_us(BOOT_FIRST_FRAME) - boot_mark_us(BOOT_FIRST_SAMPLE));
+    CHECK(buzzer_quiet, "buzzer alertou no boot com a cena iluminada");
+    CHECK(bh1750_get_state() == BH1750_STATE_RUNNING && lux_reads >= 3,
+          "BH1750: %u leituras em %u ms", lux_reads, BOOT_RUN_US / 1000);
+
+    return check_exit("boot");
+}
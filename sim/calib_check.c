@@ -0,0 +1,97 @@
+// Verificação no host do registro de calibração (lib/calib.h) sobre a flash
+// simulada de sim_hw.c: formato, escolha do registro mais novo, rotação das
+// páginas, corte de energia no meio de uma gravação e registros corrompidos.
+// Um "boot" é só uma nova chamada de calib_load(), que relê o setor.
+//
+// Uso: colorlux_calib_check
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "calib.h"
+#include "check.h"
+
+static calib_data_t make_data(uint16_t n) {
+    calib_data_t d;
+    calib_defaults(&d);
+    d.gain_r = 256 + n;
+    d.max_lux = 1000 + n;
+    d.gy33_step = (uint8_t)(n % 7);
+    return d;
+}
+
+static uint8_t *slot_ptr(int slot) {
+    return sim_flash + CALIB_FLASH_OFFSET + slot * CALIB_SLOT_SIZE;
+}
+
+int main(void) {
+    calib_data_t d, expect;
+
+    // Setor apagado: valores padrão
+    sim_flash_reset();
+    calib_defaults(&expect);
+    CHECK(!calib_load(&d), "setor vazio deveria dar valores padrão");
+    CHECK(!memcmp(&d, &expect, sizeof(d)), "padrões diferentes de calib_defaults");
+
+    // Grava e relê
+    expect = make_data(1);
+    CHECK(calib_save(&expect), "primeira gravação");
+    CHECK(calib_load(&d) && !memcmp(&d, &expect, sizeof(d)), "releitura da primeira gravação");
+    CHECK(calib_status()->slot == 0 && calib_status()->seq == 1, "primeiro registro na página 0, seq 1");
+
+    // Conteúdo igual não programa
+    uint32_t programs = sim_flash_stats.programs;
+    CHECK(calib_save(&expect), "gravação repetida");
+    CHECK(sim_flash_stats.programs == programs, "conteúdo igual não deveria tocar na flash");
+
+    // Rotação: uma página por gravação, um apagamento a cada CALIB_SLOTS
+    sim_flash_reset();
+    sim_flash_stats.erases = sim_flash_stats.programs = 0;
+    calib_load(&d);
+    const int saves = 1000;
+    for (int i = 1; i <= saves; i++) {
+        expect = make_data((uint16_t)i);
+        CHECK(calib_save(&expect), "gravação %d", i);
+    }
+    CHECK(calib_load(&d) && !memcmp(&d, &expect, sizeof(d)), "releitura após %d gravações", saves);
+    CHECK(sim_flash_stats.programs == (uint32_t)saves, "%u páginas programadas", sim_flash_stats.programs);
+    CHECK(sim_flash_stats.erases == (uint32_t)((saves - 1) / CALIB_SLOTS),
+          "%u apagamentos para %d gravações", sim_flash_stats.erases, saves);
+    printf("%d gravações: %u apagamentos do setor (1 a cada %d)\n",
+           saves, sim_flash_stats.erases, CALIB_SLOTS);
+
+    // Corte de energia no meio da programação: vale o registro anterior e a
+    // página estragada é pulada na gravação seguinte
+    calib_data_t before = expect;
+    int slot_before = calib_status()->slot;
+    sim_flash_program_limit = 10;
+    expect = make_data(5000);
+    CHECK(!calib_save(&expect), "gravação interrompida deveria falhar");
+    CHECK(calib_load(&d) && !memcmp(&d, &before, sizeof(d)), "após corte vale o registro anterior");
+    CHECK(calib_save(&expect), "gravação após o corte");
+    CHECK(calib_load(&d) && !memcmp(&d, &expect, sizeof(d)), "releitura após o corte");
+    CHECK(calib_status()->slot != slot_before + 1 || slot_before + 1 >= CALIB_SLOTS,
+          "a página interrompida deveria ter sido pulada");
+
+    // Bit trocado no registro mais novo: cai para o anterior
+    before = expect;
+    expect = make_data(6000);
+    CHECK(calib_save(&expect), "gravação antes da corrupção");
+    int slot = calib_status()->slot;
+    slot_ptr(slot)[offsetof(calib_record_t, data)] ^= 0x01;
+    CHECK(calib_load(&d) && !memcmp(&d, &before, sizeof(d)), "CRC deveria descartar o registro corrompido");
+
+    // Versão desconhecida (firmware mais novo) é ignorada
+    sim_flash_reset();
+    calib_load(&d);
+    expect = make_data(7);
+    CHECK(calib_save(&expect), "gravação antes da troca de versão");
+    calib_record_t rec;
+    memcpy(&rec, slot_ptr(calib_status()->slot), sizeof(rec));
+    rec.version = CALIB_VERSION + 1;
+    rec.crc = calib_crc32(&rec, offsetof(calib_record_t, crc));
+    memcpy(slot_ptr(calib_status()->slot), &rec, sizeof(rec));
+    CHECK(!calib_load(&d), "versão desconhecida deveria dar valores padrão");
+
+    return check_exit("calib");
+}
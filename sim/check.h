@@ -0,0 +1,49 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+// Verificações dos testes no host (registrados no ctest). Cada CHECK que não
+// passa imprime "FALHOU: ..." e é contado; no fim, check_exit() imprime
+// "<nome>: ok" ou "<nome>: FALHAS" e dá o código de saída do teste.
+//
+//   CHECK(n == 3, "%u amostras, esperado 3", n);
+//   ...
+//   return check_exit("exemplo");
+
+static int failures;
+
+#define CHECK(cond, ...) do {                  \
+        if (!(cond)) {                         \
+            printf("FALHOU: " __VA_ARGS__);    \
+            printf("\n");                      \
+            failures++;                        \
+        }                                      \
+    } while (0)
+
+static inline int check_exit(const char *name) {
+    printf("%s: %s\n", name, failures ? "FALHAS" : "ok");
+    return failures ? 1 : 0;
+}
+
+// Relógio do host para as medições de vazão dos testes. host_cycles() conta
+// ciclos pelo TSC onde existe e cai para host_ns() nas outras arquiteturas;
+// HOST_CYCLES_UNIT diz qual das duas unidades saiu.
+static inline uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t host_cycles(void) { return __rdtsc(); }
+#define HOST_CYCLES_UNIT "ciclos"
+#else
+static inline uint64_t host_cycles(void) { return host_ns(); }
+#define HOST_CYCLES_UNIT "ns"
+#endif
+
+#endif // CHECK_H
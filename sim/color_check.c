@@ -0,0 +1,131 @@
+// Verificação e benchmark no host do pipeline de cor em inteiros
+// (lib/color.h) contra o pipeline em float que o laço principal usava.
+//
+// 1. Sobre entradas sorteadas e casos de borda (canais zerados, saturados,
+//    lux 0 e acima do máximo), color_process() tem que ficar a no máximo
+//    1 LSB da referência em float, e as tabelas de gamma iguais às fórmulas
+//    (v^2 para o PWM, v^2 / 256 arredondado para cima para o WS2812B).
+// 2. Mede ciclos do host por amostra dos dois pipelines (só para comparação
+//    relativa: o host tem FPU, e no M0+ o float é emulado em software).
+//
+// Uso: colorlux_color_check [rodadas do benchmark]
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "color.h"
+#include "check.h"
+
+#define RANDOM_SAMPLES 2000000
+#define BENCH_SAMPLES 4096
+
+// O pipeline antigo do laço principal, em float
+static color_rgb8_t reference_process(uint16_t r, uint16_t g, uint16_t b, uint16_t lux, uint16_t max_lux) {
+    uint16_t max_color = (r > g) ? r : g;
+    max_color = (max_color > b) ? max_color : b;
+
+    uint8_t r_norm = 0, g_norm = 0, b_norm = 0;
+    if (max_color > 0) {
+        r_norm = (uint8_t)((r * 255.0f) / max_color);
+        g_norm = (uint8_t)((g * 255.0f) / max_color);
+        b_norm = (uint8_t)((b * 255.0f) / max_color);
+    }
+
+    float intensity = (lux >= max_lux) ? 1.0f : (float)lux / max_lux;
+    color_rgb8_t out = {(uint8_t)(r_norm * intensity), (uint8_t)(g_norm * intensity), (uint8_t)(b_norm * intensity)};
+    return out;
+}
+
+static uint32_t seed = 2024;
+
+static uint16_t rand16(void) {
+    seed = seed * 1103515245u + 12345u;
+    return (uint16_t)(seed >> 16);
+}
+
+static uint32_t samples, differing, over_one;
+
+static void compare(uint16_t r, uint16_t g, uint16_t b, uint16_t lux, uint16_t max_lux) {
+    color_rgb8_t got = color_process(r, g, b, lux, max_lux);
+    color_rgb8_t ref = reference_process(r, g, b, lux, max_lux);
+    int d[3] = {got.r - ref.r, got.g - ref.g, got.b - ref.b};
+    bool diff = false;
+    for (int i = 0; i < 3; i++) {
+        if (d[i])
+            diff = true;
+        if (d[i] > 1 || d[i] < -1) {
+            if (!over_one++)
+                printf("  (%u, %u, %u) lux %u/%u: %u,%u,%u contra %u,%u,%u\n", r, g, b, lux, max_lux,
+                       got.r, got.g, got.b, ref.r, ref.g, ref.b);
+        }
+    }
+    samples++;
+    differing += diff;
+}
+
+static void check_reference(void) {
+    static const uint16_t edges[] = {0, 1, 2, 254, 255, 256, 1000, 32767, 65534, 65535};
+    const int n = sizeof(edges) / sizeof(edges[0]);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            for (int k = 0; k < n; k++)
+                for (int l = 0; l < n; l++)
+                    compare(edges[i], edges[j], edges[k], edges[l], edges[l] ? 1000 : 1);
+
+    for (int i = 0; i < RANDOM_SAMPLES; i++) {
+        // Metade em leituras baixas, como em pouca luz, e metade em toda a escala
+        uint16_t mask = (i & 1) ? 0xFFFF : 0x3FF;
+        uint16_t max_lux = rand16() % 4000 + 1;
+        compare(rand16() & mask, rand16() & mask, rand16() & mask, rand16() % (max_lux + max_lux / 4 + 1), max_lux);
+    }
+    printf("referência float: %u amostras, %u com algum canal diferente (%.2f%%), %u além de 1 LSB\n",
+           samples, differing, 100.0 * differing / samples, over_one);
+    CHECK(over_one == 0, "%u amostras a mais de 1 LSB da referência", over_one);
+}
+
+static void check_tables(void) {
+    uint32_t bad_pwm = 0, bad_ws = 0;
+    for (uint32_t v = 0; v < 256; v++) {
+        if (color_pwm_level((uint8_t)v) != v * v)
+            bad_pwm++;
+        if (color_ws2812b_level((uint8_t)v) != (v * v + 255) / 256)
+            bad_ws++;
+    }
+    CHECK(!bad_pwm && !bad_ws, "tabelas de gamma: %u entradas do PWM e %u do WS2812B erradas", bad_pwm, bad_ws);
+    CHECK(color_ws2812b_level(1) == 1 && color_ws2812b_level(255) == 255,
+          "WS2812B: 1 -> %u, 255 -> %u", color_ws2812b_level(1), color_ws2812b_level(255));
+}
+
+static void bench(int rounds) {
+    static uint16_t in[BENCH_SAMPLES][4];
+    for (int i = 0; i < BENCH_SAMPLES; i++)
+        for (int j = 0; j < 4; j++)
+            in[i][j] = rand16() & 0x3FFF;
+
+    volatile uint8_t sink = 0;
+    double per_sample[2];
+    for (int reference = 0; reference < 2; reference++) {
+        uint64_t t0 = host_cycles();
+        for (int k = 0; k < rounds; k++)
+            for (int i = 0; i < BENCH_SAMPLES; i++) {
+                color_rgb8_t c = reference ? reference_process(in[i][0], in[i][1], in[i][2], in[i][3], 1000)
+                                           : color_process(in[i][0], in[i][1], in[i][2], in[i][3], 1000);
+                sink ^= c.r ^ c.g ^ c.b;
+            }
+        per_sample[reference] = (double)(host_cycles() - t0) / ((double)rounds * BENCH_SAMPLES);
+    }
+    (void)sink;
+    printf("\ncolor_process %6.1f %s/amostra, float %6.1f %s/amostra (%.1fx)\n", per_sample[0],
+           HOST_CYCLES_UNIT, per_sample[1], HOST_CYCLES_UNIT, per_sample[1] / (per_sample[0] > 0 ? per_sample[0] : 1));
+}
+
+int main(int argc, char **argv) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 200;
+    if (rounds <= 0) rounds = 200;
+
+    check_reference();
+    check_tables();
+    bench(rounds);
+
+    return check_exit("color");
+}
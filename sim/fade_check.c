@@ -0,0 +1,174 @@
+// Verificação no host das transições dos LEDs (lib/fade.h) com um relógio
+// virtual: o timer de FADE_TICK_US e a tarefa dos LEDs publicando alvos na
+// taxa das amostras, intercalados em ordem de tempo como no núcleo 1.
+//
+// Confere que:
+//   - uma transição chega exatamente ao alvo em FADE_STEPS passos, sem
+//     passar dele e sem voltar;
+//   - um alvo novo no meio parte do valor atual (sem salto na saída);
+//   - republicar o mesmo alvo não recomeça a transição;
+//   - fade_pwm_level() coincide com color_pwm_level() nos valores inteiros;
+//   - com alvos a cada amostra a saída segue a cor com no máximo uma
+//     transição de atraso e para no último alvo.
+// E mede o maior degrau de PWM por passo contra o salto direto.
+//
+// Uso: colorlux_fade_check
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "fade.h"
+#include "check.h"
+
+#define FADE_TICK_US 10000
+#define SAMPLE_US 2500
+
+static color_rgb8_t rgb(uint8_t r, uint8_t g, uint8_t b) {
+    color_rgb8_t c = {r, g, b};
+    return c;
+}
+
+static bool same(color_rgb8_t a, color_rgb8_t b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+static int max_pwm_jump(const fade_t *f, const uint16_t prev[FADE_CHANNELS]) {
+    int jump = 0;
+    for (int ch = 0; ch < FADE_CHANNELS; ch++) {
+        int d = abs((int)fade_pwm_level(f, ch) - prev[ch]);
+        if (d > jump) jump = d;
+    }
+    return jump;
+}
+
+// Uma transição isolada: passos, monotonia, ponto final e o maior degrau
+static void check_transition(color_rgb8_t from, color_rgb8_t to) {
+    fade_t f;
+    fade_init(&f);
+    fade_set_target(&f, from);
+    while (fade_step(&f)) {}
+
+    fade_set_target(&f, to);
+    uint16_t prev[FADE_CHANNELS];
+    int32_t start[FADE_CHANNELS];
+    for (int ch = 0; ch < FADE_CHANNELS; ch++) {
+        prev[ch] = fade_pwm_level(&f, ch);
+        start[ch] = f.value_q16[ch];
+    }
+    const uint8_t end[FADE_CHANNELS] = {to.r, to.g, to.b};
+    uint32_t steps = 0;
+    int jump = 0;
+    bool monotonic = true;
+    while (fade_step(&f)) {
+        steps++;
+        for (int ch = 0; ch < FADE_CHANNELS; ch++) {
+            int32_t e = (int32_t)end[ch] << 16;
+            int32_t v = f.value_q16[ch];
+            if ((e >= start[ch] && (v < start[ch] || v > e)) || (e < start[ch] && (v > start[ch] || v < e)))
+                monotonic = false;
+            start[ch] = v;
+        }
+        int j = max_pwm_jump(&f, prev);
+        if (j > jump) jump = j;
+        for (int ch = 0; ch < FADE_CHANNELS; ch++)
+            prev[ch] = fade_pwm_level(&f, ch);
+    }
+    CHECK(steps == FADE_STEPS, "%u passos em vez de %u", steps, FADE_STEPS);
+    CHECK(same(fade_value(&f), to), "transição não terminou no alvo");
+    CHECK(monotonic, "transição passou do alvo ou voltou");
+
+    int direct = 0;
+    const uint8_t a[3] = {from.r, from.g, from.b};
+    for (int ch = 0; ch < FADE_CHANNELS; ch++) {
+        int d = abs((int)color_pwm_level(end[ch]) - color_pwm_level(a[ch]));
+        if (d > direct) direct = d;
+    }
+    printf("(%3u,%3u,%3u) -> (%3u,%3u,%3u): %u passos, maior degrau de PWM %5d (salto direto %5d)\n",
+           from.r, from.g, from.b, to.r, to.g, to.b, steps, jump, direct);
+}
+
+int main(void) {
+    fade_t f;
+
+    // Gamma com fração igual à tabela nos inteiros
+    fade_init(&f);
+    int mismatches = 0;
+    for (int v = 0; v < 256; v++) {
+        f.value_q16[0] = v << 16;
+        if (fade_pwm_level(&f, 0) != color_pwm_level((uint8_t)v))
+            mismatches++;
+    }
+    CHECK(mismatches == 0, "%d níveis de PWM diferentes de color_pwm_level", mismatches);
+
+    // Sem alvo publicado não há passo
+    fade_init(&f);
+    CHECK(!fade_step(&f), "passo sem alvo");
+
+    check_transition(rgb(0, 0, 0), rgb(255, 128, 7));
+    check_transition(rgb(255, 255, 255), rgb(0, 1, 254));
+    check_transition(rgb(10, 200, 30), rgb(11, 199, 30));
+
+    // Alvo novo no meio: continua do valor atual, sem salto
+    fade_init(&f);
+    fade_set_target(&f, rgb(200, 0, 0));
+    for (int i = 0; i < FADE_STEPS / 2; i++)
+        fade_step(&f);
+    int32_t mid = f.value_q16[0];
+    fade_set_target(&f, rgb(0, 0, 200));
+    fade_step(&f);
+    CHECK(f.value_q16[0] < mid && mid - f.value_q16[0] <= mid / (int32_t)FADE_STEPS + 1,
+          "troca de alvo saltou de %d para %d", mid >> 16, f.value_q16[0] >> 16);
+    uint32_t steps = 1;
+    while (fade_step(&f)) steps++;
+    CHECK(steps == FADE_STEPS && same(fade_value(&f), rgb(0, 0, 200)), "troca de alvo: %u passos", steps);
+
+    // Mesmo alvo de novo: nada a fazer
+    fade_set_target(&f, rgb(0, 0, 200));
+    CHECK(!fade_step(&f), "alvo repetido recomeçou a transição");
+
+    // Relógio virtual: amostras a cada SAMPLE_US com a cor subindo em rampa
+    // e o timer a cada FADE_TICK_US; depois as amostras param
+    fade_init(&f);
+    uint64_t next_sample = 0, next_tick = FADE_TICK_US;
+    uint32_t published = 0, ticks = 0, lag_max = 0;
+    color_rgb8_t last = rgb(0, 0, 0);
+    for (uint64_t now = 0; now < 2000000; ) {
+        if (next_sample <= next_tick) {
+            now = next_sample;
+            if (now < 1000000) {
+                last = rgb((uint8_t)(now / 4000), (uint8_t)(255 - now / 4000), 128);
+                fade_set_target(&f, last);
+                published++;
+            }
+            next_sample += SAMPLE_US;
+        } else {
+            now = next_tick;
+            fade_step(&f);
+            ticks++;
+            uint32_t lag = (uint32_t)abs((int)fade_value(&f).r - last.r);
+            if (now < 1000000 && lag > lag_max) lag_max = lag;
+            next_tick += FADE_TICK_US;
+        }
+    }
+    CHECK(same(fade_value(&f), last), "relógio virtual: não parou no último alvo");
+    // Cada alvo novo recomeça uma transição a partir do valor atual, então a
+    // saída fica no máximo uma transição atrás da rampa (1 nível a cada 4 ms)
+    uint32_t lag_limit = FADE_STEPS * FADE_TICK_US / 4000;
+    CHECK(lag_max <= lag_limit, "relógio virtual: atraso de %u níveis atrás da rampa (limite %u)", lag_max, lag_limit);
+    printf("relógio virtual: %u alvos, %u passos do timer, atraso máximo %u níveis na rampa\n",
+           published, ticks, lag_max);
+
+    // Custo do passo no host (no RP2040: somas e um deslocamento por canal)
+    fade_init(&f);
+    clock_t t0 = clock();
+    const uint32_t n = 20000000;
+    for (uint32_t i = 0; i < n; i++) {
+        if (!(i & 3))
+            fade_set_target(&f, rgb((uint8_t)i, (uint8_t)(i >> 3), (uint8_t)(i >> 5)));
+        fade_step(&f);
+    }
+    double s = (double)(clock() - t0) / CLOCKS_PER_SEC;
+    printf("passo: %.1f ns no host (alvo novo a cada 4 passos)\n", s * 1e9 / n);
+
+    return check_exit("fade");
+}
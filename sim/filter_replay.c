@@ -0,0 +1,144 @@
+// Reaplica lib/filter.h no host sobre um traço gravado, para escolher os
+// parâmetros dos filtros sem a placa.
+//
+// O traço é o CSV de tools/telemetry_decode.py, gravado com o filtro do
+// firmware desligado ('f' no monitor serial, ou -F no colorlux_sim):
+//
+//   colorlux_sim -q -n 5 -F -T cap.bin -t 5000
+//   tools/telemetry_decode.py cap.bin > cap.csv
+//   colorlux_filter_replay [-e shift] [-b faixa] [-B shift] [-M] [-o saida.csv] cap.csv
+//
+// sim/data/filter_trace.csv foi gravado assim e é o traço do teste do ctest.
+//
+// Para cada canal compara o traço bruto com o filtrado: variação média entre
+// amostras consecutivas (tremor), maior salto e quantas vezes a saída mudou.
+// Falha se em algum canal o filtrado tremer mais que o bruto, ou se uma
+// leitura zero de lux não sair zero na mesma amostra (o alerta de escuro não
+// pode atrasar).
+// O lux vem repetido em todas as amostras de cor, então só as mudanças de
+// valor entram no filtro de lux. Como no firmware (lux_task_run), um zero
+// passa direto e reinicia o filtro.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "filter.h"
+#include "check.h"
+
+#define CHANNELS 5
+
+static const char *const channel_names[CHANNELS] = {"r", "g", "b", "c", "lux"};
+
+typedef struct {
+    uint32_t last;
+    uint64_t delta_sum;
+    uint32_t delta_max;
+    uint32_t changes;
+} channel_stats_t;
+
+static void stats_add(channel_stats_t *s, uint32_t v, bool first) {
+    if (!first) {
+        uint32_t d = v > s->last ? v - s->last : s->last - v;
+        s->delta_sum += d;
+        if (d > s->delta_max) s->delta_max = d;
+        if (d) s->changes++;
+    }
+    s->last = v;
+}
+
+int main(int argc, char **argv) {
+    filter_config_t color_cfg = {.median = true, .ema_shift = 3, .band = 2, .band_shift = 7};
+    filter_config_t lux_cfg = {.median = false, .ema_shift = 1, .band = 0};
+    const char *in_path = NULL, *out_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-e") && i + 1 < argc) color_cfg.ema_shift = (uint8_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-b") && i + 1 < argc) color_cfg.band = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-B") && i + 1 < argc) color_cfg.band_shift = (uint8_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-M")) color_cfg.median = lux_cfg.median = false;
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc) out_path = argv[++i];
+        else if (argv[i][0] != '-' && !in_path) in_path = argv[i];
+        else {
+            fprintf(stderr, "uso: %s [-e shift] [-b faixa] [-B shift] [-M] [-o saida.csv] traço.csv\n", argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *in = in_path ? fopen(in_path, "r") : stdin;
+    if (!in) {
+        perror(in_path);
+        return 1;
+    }
+    FILE *out = NULL;
+    if (out_path && !(out = fopen(out_path, "w"))) {
+        perror(out_path);
+        return 1;
+    }
+    if (out) fprintf(out, "time_us,r,g,b,c,lux\n");
+
+    filter_bank_t bank;
+    filter_bank_init(&bank, &color_cfg, &lux_cfg);
+    filter_t *filters[CHANNELS] = {&bank.r, &bank.g, &bank.b, &bank.c, &bank.lux};
+    channel_stats_t raw_stats[CHANNELS] = {0}, filt_stats[CHANNELS] = {0};
+
+    char line[256];
+    uint32_t samples = 0;
+    uint32_t lux_in = 0, lux_out = 0, dark_late = 0;
+    uint64_t filter_ns = 0;
+    while (fgets(line, sizeof line, in)) {
+        unsigned long frame_seq, time_us, seq, v[CHANNELS];
+        if (sscanf(line, "%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu", &frame_seq, &time_us, &seq,
+                   &v[0], &v[1], &v[2], &v[3], &v[4]) != 8)
+            continue; // Cabeçalho ou linha incompleta
+
+        uint32_t raw[CHANNELS], filt[CHANNELS];
+        for (int ch = 0; ch < CHANNELS; ch++)
+            raw[ch] = (uint32_t)v[ch];
+
+        uint64_t t0 = host_ns();
+        for (int ch = 0; ch < CHANNELS - 1; ch++)
+            filt[ch] = filter_update(filters[ch], raw[ch]);
+        if (!samples || raw[4] != lux_in) {
+            lux_in = raw[4];
+            if (lux_in == 0)
+                filter_reset(&bank.lux);
+            lux_out = lux_in ? filter_update(&bank.lux, lux_in) : 0;
+        }
+        filt[4] = lux_out;
+        if (raw[4] == 0 && filt[4] != 0)
+            dark_late++;
+        filter_ns += host_ns() - t0;
+
+        for (int ch = 0; ch < CHANNELS; ch++) {
+            stats_add(&raw_stats[ch], raw[ch], samples == 0);
+            stats_add(&filt_stats[ch], filt[ch], samples == 0);
+        }
+        if (out)
+            fprintf(out, "%lu,%u,%u,%u,%u,%u\n", time_us, filt[0], filt[1], filt[2], filt[3], filt[4]);
+        samples++;
+    }
+    if (in != stdin) fclose(in);
+    if (out) fclose(out);
+
+    if (samples < 2) {
+        fprintf(stderr, "traço vazio\n");
+        return 1;
+    }
+
+    printf("%u amostras; cor: mediana %s, EMA 1/%u, faixa %u ou 1/%u do valor; %.0f ns/amostra no host\n",
+           samples, color_cfg.median ? "sim" : "não",
+           color_cfg.ema_shift ? 1u << color_cfg.ema_shift : 1u, color_cfg.band,
+           color_cfg.band_shift ? 1u << color_cfg.band_shift : 0u,
+           (double)filter_ns / samples);
+    printf("%-4s | %10s %10s | %9s %9s | %9s %9s\n",
+           "", "Δ médio", "filtrado", "Δ máx", "filtrado", "mudanças", "filtrado");
+    for (int ch = 0; ch < CHANNELS; ch++) {
+        const channel_stats_t *r = &raw_stats[ch], *f = &filt_stats[ch];
+        printf("%-4s | %10.2f %10.2f | %9u %9u | %9u %9u\n", channel_names[ch],
+               (double)r->delta_sum / (samples - 1), (double)f->delta_sum / (samples - 1),
+               r->delta_max, f->delta_max, r->changes, f->changes);
+        CHECK(f->delta_sum <= r->delta_sum, "%s filtrado treme mais que o bruto", channel_names[ch]);
+    }
+    CHECK(dark_late == 0, "%u amostras com lux zero e filtrado diferente de zero", dark_late);
+    return check_exit("filter_replay");
+}
@@ -0,0 +1,308 @@
+// Verificação no host do histórico na flash (lib/flash_log.h) sobre a flash
+// simulada de sim_hw.c, com os números de compressão e de amplificação de
+// escrita.
+//
+// Gera um dia de amostras a 1 Hz (luz que sobe e desce devagar, ruído de
+// poucas contagens e trocas bruscas de cena), mais que a capacidade do log,
+// e confere que:
+//   - tudo que ainda está no log volta idêntico, em ordem e sem lacunas;
+//   - as amostras mais antigas são as que se perdem na volta do círculo;
+//   - um "reboot" (flash_log_init) continua depois do último bloco;
+//   - um bloco programado pela metade é ignorado e a escrita segue adiante;
+//   - com a imagem do firmware chegando à área do log, flash_log_init() o
+//     desliga e nada é gravado nem lido lá.
+//
+// Depois repete a volta completa com canais acima de 16 bits (saltos de fundo
+// a fundo da escala do GY-33 nos dois sentidos). Com dois arquivos, grava
+// esse log como o despejo do comando 'd' (quadros de telemetria) e o CSV que
+// tools/telemetry_decode.py --log tem que produzir a partir dele.
+//
+// Uso: colorlux_flash_log_check [despejo.bin esperado.csv]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sim.h"
+#include "flash_log.h"
+#include "sensores.h"
+#include "telemetry.h"
+#include "check.h"
+
+#define DAY_SAMPLES (24 * 3600)
+
+static flash_log_sample_t *input;
+static uint32_t input_count;
+
+static uint32_t seed = 1;
+
+static int noise(int amplitude) {
+    seed = seed * 1103515245u + 12345u;
+    return (int)((seed >> 16) % (2 * amplitude + 1)) - amplitude;
+}
+
+static uint16_t clamp16(double v) {
+    return v < 0 ? 0 : v > 65535 ? 65535 : (uint16_t)v;
+}
+
+// Canais na escala publicada pelo GY-33, a partir de contagens da exposição
+// antiga (1x, 11 ciclos)
+static uint32_t color_counts(double v) {
+    v *= (double)GY33_REF_SENSITIVITY / 11;
+    return v < 0 ? 0 : v > GY33_COUNTS_MAX ? GY33_COUNTS_MAX : (uint32_t)v;
+}
+
+static flash_log_sample_t make_sample(uint32_t i) {
+    // Dia: seno de 24 h; a cada ~20 min uma cena diferente na frente do sensor
+    double daylight = 0.5 - 0.5 * cos(2 * M_PI * i / DAY_SAMPLES);
+    uint32_t scene = (i / 1200) % 5;
+    static const double tint[5][3] = {
+        {1.0, 1.2, 1.1}, {2.0, 0.6, 0.5}, {0.7, 1.5, 0.8}, {0.6, 0.9, 1.8}, {1.0, 1.0, 1.0},
+    };
+    double base = 50 + 3000 * daylight;
+    flash_log_sample_t s;
+    s.time_ms = i * 1000 + (uint32_t)(noise(20) + 20); // Período da tarefa + jitter
+    s.r = color_counts(base * tint[scene][0] + noise(3));
+    s.g = color_counts(base * tint[scene][1] + noise(3));
+    s.b = color_counts(base * tint[scene][2] + noise(3));
+    s.c = color_counts(base * 3.2 + noise(6));
+    s.lux = clamp16(20 + 900 * daylight + noise(2));
+    return s;
+}
+
+// --- Leitura completa, como o host faz com o despejo ---
+
+typedef struct {
+    uint32_t seq;
+    uint16_t count;
+    uint8_t block[FLASH_PAGE_SIZE];
+} read_block_t;
+
+static read_block_t *blocks;
+static int block_count;
+
+static int cmp_seq(const void *a, const void *b) {
+    uint32_t x = ((const read_block_t *)a)->seq, y = ((const read_block_t *)b)->seq;
+    return x < y ? -1 : x > y;
+}
+
+static void read_all(void) {
+    flash_log_cursor_t cur;
+    uint8_t block[FLASH_PAGE_SIZE];
+    block_count = 0;
+    flash_log_cursor_init(&cur);
+    while (flash_log_cursor_next(&cur, block)) {
+        uint32_t seq = block[4] | block[5] << 8 | block[6] << 16 | (uint32_t)block[7] << 24;
+        uint16_t count = block[10] | block[11] << 8;
+        int k;
+        for (k = 0; k < block_count && blocks[k].seq != seq; k++) {}
+        if (k == block_count)
+            block_count++;
+        else if (blocks[k].count >= count)
+            continue; // Repetição com menos amostras
+        blocks[k].seq = seq;
+        blocks[k].count = count;
+        memcpy(blocks[k].block, block, FLASH_PAGE_SIZE);
+    }
+    qsort(blocks, block_count, sizeof(blocks[0]), cmp_seq);
+}
+
+typedef struct {
+    flash_log_sample_t *out;
+    uint32_t n;
+} collect_t;
+
+static void collect(void *ctx, uint16_t boot, const flash_log_sample_t *s) {
+    collect_t *c = ctx;
+    (void)boot;
+    c->out[c->n++] = *s;
+}
+
+static uint32_t decode_all(flash_log_sample_t *out) {
+    collect_t c = {out, 0};
+    read_all();
+    for (int i = 0; i < block_count; i++)
+        flash_log_decode_block(blocks[i].block, collect, &c);
+    return c.n;
+}
+
+// As n amostras lidas precisam ser exatamente as últimas n geradas
+static void check_tail(const flash_log_sample_t *out, uint32_t n, const char *what) {
+    CHECK(n > 0 && n <= input_count, "%s: %u amostras lidas", what, n);
+    if (n == 0 || n > input_count)
+        return;
+    const flash_log_sample_t *expect = input + (input_count - n);
+    uint32_t bad = 0;
+    for (uint32_t i = 0; i < n; i++)
+        if (memcmp(&out[i], &expect[i], sizeof(out[i])))
+            bad++;
+    CHECK(bad == 0, "%s: %u de %u amostras diferentes", what, bad, n);
+}
+
+static void append_and_service(uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        input[input_count] = make_sample(input_count);
+        flash_log_append(&input[input_count++]);
+        while (flash_log_service()) {}
+    }
+}
+
+// --- Canais acima de 16 bits ---
+
+#define WIDE_SAMPLES 200
+
+static const uint32_t wide_values[] = {
+    0, GY33_COUNTS_MAX, 65535, 65536, 1, 70000, 1u << 20, GY33_COUNTS_MAX - 1, 123456, 0xFFFF0,
+};
+#define WIDE_VALUES (sizeof(wide_values) / sizeof(wide_values[0]))
+
+static FILE *dump_file;
+
+static uint32_t file_sink(const uint8_t *data, uint32_t len) {
+    return (uint32_t)fwrite(data, 1, len, dump_file);
+}
+
+// Os blocos lidos, como o firmware os envia pelo comando 'd'
+static bool write_dump(const char *path) {
+    dump_file = fopen(path, "wb");
+    if (!dump_file)
+        return false;
+    telemetry_init();
+    for (int i = 0; i < block_count; i++) {
+        const uint8_t *block = blocks[i].block;
+        uint32_t used = FLASH_LOG_HEADER_SIZE + (block[2] | block[3] << 8) + FLASH_LOG_CRC_SIZE;
+        for (uint32_t chunk = 0; chunk * TELEMETRY_LOG_CHUNK_SIZE < used; chunk++) {
+            telemetry_send_log_chunk(0, (uint16_t)i, (uint8_t)chunk, block + chunk * TELEMETRY_LOG_CHUNK_SIZE);
+            telemetry_drain(file_sink);
+        }
+    }
+    uint8_t end[2] = {(uint8_t)block_count, (uint8_t)(block_count >> 8)};
+    telemetry_send(TELEMETRY_TYPE_LOG_END, 0, end, sizeof(end));
+    telemetry_drain(file_sink);
+    return fclose(dump_file) == 0;
+}
+
+static bool write_expected(const char *path, uint16_t boot, const flash_log_sample_t *s, uint32_t n) {
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return false;
+    fprintf(f, "boot,time_ms,r,g,b,c,lux\n");
+    for (uint32_t i = 0; i < n; i++)
+        fprintf(f, "%u,%u,%u,%u,%u,%u,%u\n", boot, s[i].time_ms, s[i].r, s[i].g, s[i].b, s[i].c, s[i].lux);
+    return fclose(f) == 0;
+}
+
+static void check_wide(flash_log_sample_t *out, const char *dump_path, const char *expected_path) {
+    sim_flash_reset();
+    flash_log_init();
+    input_count = 0;
+    for (uint32_t i = 0; i < WIDE_SAMPLES; i++) {
+        flash_log_sample_t s = {
+            .time_ms = i * 1000,
+            .r = wide_values[i % WIDE_VALUES],
+            .g = wide_values[(i * 3 + 1) % WIDE_VALUES],
+            .b = wide_values[(i * 7 + 2) % WIDE_VALUES],
+            .c = wide_values[(WIDE_VALUES - 1 - i % WIDE_VALUES)],
+            .lux = (uint16_t)(i & 1 ? 65535 : i),
+        };
+        input[input_count++] = s;
+        flash_log_append(&s);
+        while (flash_log_service()) {}
+    }
+    uint32_t n = decode_all(out);
+    CHECK(n == WIDE_SAMPLES, "acima de 16 bits: %u de %u amostras lidas", n, WIDE_SAMPLES);
+    check_tail(out, n, "acima de 16 bits");
+    printf("acima de 16 bits: %u amostras em %d blocos\n", n, block_count);
+
+    if (dump_path) {
+        CHECK(write_dump(dump_path), "não gravou %s", dump_path);
+        CHECK(write_expected(expected_path, flash_log_stats()->boot, out, n), "não gravou %s", expected_path);
+    }
+}
+
+int main(int argc, char **argv) {
+    input = malloc(sizeof(*input) * 2 * DAY_SAMPLES);
+    flash_log_sample_t *out = malloc(sizeof(*out) * 2 * DAY_SAMPLES);
+    blocks = malloc(sizeof(*blocks) * (FLASH_LOG_PAGES + FLASH_LOG_QUEUE + 1));
+
+    sim_flash_reset();
+    flash_log_init();
+
+    // Um dia inteiro a 1 Hz: mais do que cabe, então o círculo dá a volta
+    append_and_service(DAY_SAMPLES);
+    const flash_log_stats_t *st = flash_log_stats();
+    uint32_t n = decode_all(out);
+    check_tail(out, n, "após um dia");
+    CHECK(st->pages_dropped == 0, "%u blocos perdidos", st->pages_dropped);
+
+    double raw = (double)st->samples * FLASH_LOG_RAW_SAMPLE_SIZE;
+    double programmed = (double)st->pages_written * FLASH_PAGE_SIZE;
+    printf("%u amostras de %d bytes, %u blocos programados, %u setores apagados\n",
+           st->samples, FLASH_LOG_RAW_SAMPLE_SIZE, st->pages_written, st->sectors_erased);
+    printf("compressão: %.2f bytes/amostra codificada, razão %.2f:1 (%.2f:1 contando cabeçalho, CRC e sobra do bloco)\n",
+           (double)st->payload_bytes / st->samples, raw / st->payload_bytes, raw / programmed);
+    printf("amplificação de escrita: %.3f (bytes programados / bytes codificados), %.4f apagamentos por bloco\n",
+           programmed / st->payload_bytes, (double)st->sectors_erased / st->pages_written);
+    printf("capacidade: %u amostras no log (%.1f h a 1 Hz), desgaste de %.1f apagamentos/setor/dia\n",
+           n, n / 3600.0, (double)st->sectors_erased / (FLASH_LOG_SIZE / FLASH_SECTOR_SIZE));
+
+    // Reboot: o bloco aberto se perde com a RAM; o resto continua na flash e
+    // a escrita segue depois do último bloco, com o contador de boots novo
+    uint16_t boot = st->boot;
+    flash_log_init();
+    CHECK(flash_log_stats()->boot == boot + 1, "boot %u depois de %u", flash_log_stats()->boot, boot);
+    uint32_t in_flash = decode_all(out);
+    CHECK(in_flash > 0 && in_flash <= n, "%u amostras na flash após o reboot", in_flash);
+
+    // O boot novo recomeça o relógio; só as amostras dele são conferidas
+    input_count = 0;
+    append_and_service(3000);
+    read_all();
+    uint32_t last_boot_samples = 0;
+    for (int i = 0; i < block_count; i++)
+        if ((blocks[i].block[8] | blocks[i].block[9] << 8) == boot + 1)
+            last_boot_samples += flash_log_decode_block(blocks[i].block, NULL, NULL);
+    CHECK(last_boot_samples == 3000, "%u amostras do boot novo", last_boot_samples);
+
+    // Corte de energia no meio de uma programação: o bloco fica com CRC
+    // errado, é ignorado no próximo boot e a escrita continua adiante
+    uint32_t written = flash_log_stats()->pages_written;
+    sim_flash_program_limit = 40;
+    append_and_service(200);
+    CHECK(flash_log_stats()->pages_written > written, "nenhum bloco programado antes do corte");
+    flash_log_init();
+    read_all();
+    int torn = 0;
+    for (int page = 0; page < FLASH_LOG_PAGES; page++) {
+        const uint8_t *p = sim_flash + FLASH_LOG_OFFSET + page * FLASH_PAGE_SIZE;
+        if (p[0] == (FLASH_LOG_MAGIC & 0xFF) && p[1] == (FLASH_LOG_MAGIC >> 8) && !flash_log_block_valid(p))
+            torn++;
+    }
+    CHECK(torn == 1, "%d blocos cortados na flash", torn);
+    append_and_service(500);
+    read_all();
+    CHECK(flash_log_decode_block(blocks[block_count - 1].block, NULL, NULL) > 0, "escrita após o corte");
+    for (int i = 1; i < block_count; i++)
+        CHECK(blocks[i].seq > blocks[i - 1].seq, "seq fora de ordem após o corte");
+
+    // Imagem do firmware que passa do início do log
+    uint32_t binary_size = sim_flash_binary_size;
+    sim_flash_binary_size = FLASH_LOG_OFFSET + 1;
+    uint32_t programs = sim_flash_stats.programs, erases = sim_flash_stats.erases;
+    CHECK(!flash_log_init(), "log ligado com a imagem do firmware sobre ele");
+    append_and_service(2000);
+    flash_log_cursor_t cur;
+    uint8_t block[FLASH_PAGE_SIZE];
+    flash_log_cursor_init(&cur);
+    CHECK(sim_flash_stats.programs == programs && sim_flash_stats.erases == erases && flash_log_stats()->samples == 0,
+          "log desligado: %u programações, %u apagamentos, %u amostras aceitas",
+          sim_flash_stats.programs - programs, sim_flash_stats.erases - erases, flash_log_stats()->samples);
+    CHECK(!flash_log_cursor_next(&cur, block), "log desligado: o cursor leu um bloco");
+    sim_flash_binary_size = FLASH_LOG_OFFSET;
+    CHECK(flash_log_init(), "log desligado com a imagem do firmware logo abaixo dele");
+    sim_flash_binary_size = binary_size;
+
+    check_wide(out, argc > 2 ? argv[1] : NULL, argc > 2 ? argv[2] : NULL);
+
+    return check_exit("flash_log");
+}
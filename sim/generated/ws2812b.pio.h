@@ -0,0 +1,24 @@
+// Substitui o cabeçalho gerado pelo pioasm na simulação (lib/ws2812b.c o
+// inclui como "../generated/ws2812b.pio.h", resolvido a partir de sim/include).
+#ifndef SIM_WS2812B_PIO_H
+#define SIM_WS2812B_PIO_H
+
+#include "hardware/pio.h"
+
+static const uint16_t ws2812_program_instructions[] = {
+    0x6021, 0x0024, 0xe401, 0x0005, 0xe201, 0xe200
+};
+
+static const pio_program_t ws2812_program = {
+    .instructions = ws2812_program_instructions,
+    .length = 6,
+    .origin = -1,
+};
+
+static inline pio_sm_config ws2812_program_get_default_config(uint offset) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset, offset + 5);
+    return c;
+}
+
+#endif // SIM_WS2812B_PIO_H
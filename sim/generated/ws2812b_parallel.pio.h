@@ -0,0 +1,24 @@
+// Substitui o cabeçalho gerado pelo pioasm na simulação (lib/ws2812b_par.c o
+// inclui como "../generated/ws2812b_parallel.pio.h", resolvido a partir de sim/include).
+#ifndef SIM_WS2812B_PARALLEL_PIO_H
+#define SIM_WS2812B_PARALLEL_PIO_H
+
+#include "hardware/pio.h"
+
+static const uint16_t ws2812_parallel_program_instructions[] = {
+    0x6028, 0xa20b, 0xa201, 0xa203
+};
+
+static const pio_program_t ws2812_parallel_program = {
+    .instructions = ws2812_parallel_program_instructions,
+    .length = 4,
+    .origin = -1,
+};
+
+static inline pio_sm_config ws2812_parallel_program_get_default_config(uint offset) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset, offset + 3);
+    return c;
+}
+
+#endif // SIM_WS2812B_PARALLEL_PIO_H
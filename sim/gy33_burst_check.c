@@ -0,0 +1,151 @@
+// Verificação no host da leitura de cor do GY-33 em rajada (lib/sensores.c)
+// sobre o I2C assíncrono e o modelo do TCS34725 de sim_devices.c.
+//
+// Com o laço chamando gy33_request_color()/gy33_poll_color() a cada POLL_US
+// (o período da tarefa de cor do firmware) e a cena trocando entre duas cores
+// no meio das integrações, confere que:
+//   - cada amostra nova custa uma rajada STATUS..BDATAH (1 + 9 bytes) e o
+//     comando de limpar o AINT (1 byte), nada mais: o barramento fica livre
+//     enquanto o sensor integra;
+//   - nenhuma integração é entregue duas vezes (amostras novas a pelo menos
+//     um tempo de integração uma da outra) e quase nenhuma é perdida;
+//   - os quatro canais de cada amostra vêm da mesma integração (nunca metade
+//     de uma cor e metade da outra).
+// Depois repete o laço com a leitura antiga (quatro transações de 2 bytes por
+// chamada, sem olhar o STATUS) e compara o tempo de barramento por
+// integração.
+//
+// Uso: colorlux_gy33_burst_check
+
+#include <stdio.h>
+#include "sim.h"
+#include "sensores.h"
+#include "check.h"
+
+#define POLL_US 2500           // COLOR_TASK_PERIOD_US do firmware
+#define RUN_US 2000000
+#define SWITCH_US 7300         // Troca de cena fora do passo das integrações
+#define I2C_BAUD 400000
+#define STEP GY33_AE_DEFAULT_STEP
+#define STEP_CYCLES 4          // Ciclos do passo padrão (16x, 9,6 ms)
+#define INTEGRATION_US (STEP_CYCLES * GY33_CYCLE_US)
+
+// Duas cores com a ordem dos canais invertida: canais de integrações
+// diferentes na mesma amostra quebram a ordem
+static const sim_scene_t scenes[2] = {
+    {0, 100, 200, 400, 700},
+    {0, 400, 200, 100, 700},
+};
+
+static bool consistent(uint32_t r, uint32_t g, uint32_t b) {
+    return (r < g && g < b) || (r > g && g > b);
+}
+
+// Um canal como a leitura antiga fazia: uma transação de escrita + leitura de
+// 2 bytes (com auto-incremento, para os dois bytes serem do mesmo canal)
+static uint16_t read_channel(uint8_t reg) {
+    uint8_t cmd = reg | GY33_CMD_AUTO_INC, rx[2] = {0, 0};
+    i2c_async_txn_t txn = {
+        .addr = GY33_I2C_ADDR,
+        .tx = &cmd,
+        .tx_len = 1,
+        .rx = rx,
+        .rx_len = 2,
+    };
+    i2c_async_transfer_blocking(&txn);
+    return (rx[1] << 8) | rx[0];
+}
+
+static void switch_scene(uint64_t now, uint64_t *next_switch, int *scene) {
+    if (now >= *next_switch) {
+        *scene ^= 1;
+        sim_set_scene(&scenes[*scene]);
+        *next_switch += SWITCH_US;
+    }
+}
+
+int main(void) {
+    sim_devices_init();
+    int scene = 0;
+    sim_set_scene(&scenes[scene]);
+    i2c_init(i2c0, I2C_BAUD);
+    i2c_async_init(i2c0);
+
+    gy33_preset_exposure_step(STEP);
+    gy33_set_auto_exposure(false);
+    gy33_init();
+
+    // --- Rajada ---
+    sim_bus_stats_t mark = sim_i2c_stats[0];
+    uint64_t start = sim_now_us(), next_switch = start + SWITCH_US;
+    uint32_t fresh = 0, mixed = 0, min_gap_us = UINT32_MAX;
+    absolute_time_t last_sample = 0;
+    while (sim_now_us() - start < RUN_US) {
+        uint64_t before = sim_now_us();
+        switch_scene(before, &next_switch, &scene);
+        gy33_request_color();
+        uint32_t r, g, b, c;
+        if (gy33_poll_color(&r, &g, &b, &c)) {
+            absolute_time_t at = gy33_sample_time();
+            if (fresh++) {
+                uint32_t gap = (uint32_t)(at - last_sample);
+                if (gap < min_gap_us) min_gap_us = gap;
+            }
+            last_sample = at;
+            if (!consistent(r, g, b) && !mixed++)
+                printf("  amostra misturada: r %u g %u b %u c %u\n", r, g, b, c);
+        }
+        sim_advance_to(before + POLL_US);
+    }
+    while (gy33_color_pending() && sim_run_next_event())
+        ;
+
+    uint32_t txns = sim_i2c_stats[0].transactions - mark.transactions;
+    uint32_t bytes = sim_i2c_stats[0].bytes - mark.bytes;
+    uint64_t busy_us = sim_i2c_stats[0].busy_us - mark.busy_us;
+    uint32_t sample_us = sim_i2c_duration_us(0, 1, 9) + sim_i2c_duration_us(0, 1, 0);
+    uint32_t integrations = RUN_US / INTEGRATION_US;
+    double burst_per_sample = fresh ? (double)busy_us / fresh : 0;
+    printf("rajada: %u amostras novas de ~%u integrações, %u transações, %u bytes, %llu us de barramento "
+           "(%.0f us por amostra, esperado %u)\n",
+           fresh, integrations, txns, bytes, (unsigned long long)busy_us, burst_per_sample, sample_us);
+
+    CHECK(txns == 2 * fresh && bytes == 11 * fresh,
+          "%u transações e %u bytes para %u amostras (esperado 2 e 11 por amostra)", txns, bytes, fresh);
+    CHECK(busy_us == (uint64_t)sample_us * fresh, "%llu us de barramento, esperado %u por amostra",
+          (unsigned long long)busy_us, sample_us);
+    CHECK(min_gap_us >= INTEGRATION_US, "amostras novas a %u us uma da outra (integração de %u us)",
+          min_gap_us, INTEGRATION_US);
+    CHECK(fresh <= integrations && fresh * 10 >= integrations * 7, "%u amostras novas de ~%u integrações",
+          fresh, integrations);
+    CHECK(mixed == 0, "%u amostras com canais de integrações diferentes", mixed);
+
+    // --- Leitura antiga: quatro canais por chamada, sem olhar o STATUS ---
+    static const uint8_t channel_regs[4] = {CDATA_REG, RDATA_REG, GDATA_REG, BDATA_REG};
+    mark = sim_i2c_stats[0];
+    start = sim_now_us();
+    next_switch = start + SWITCH_US;
+    uint32_t calls = 0, legacy_mixed = 0;
+    while (sim_now_us() - start < RUN_US) {
+        uint64_t before = sim_now_us();
+        switch_scene(before, &next_switch, &scene);
+        uint32_t ch[4];
+        for (int i = 0; i < 4; i++)
+            ch[i] = read_channel(channel_regs[i]);
+        calls++;
+        legacy_mixed += !consistent(ch[1], ch[2], ch[3]);
+        sim_advance_to(before + POLL_US);
+    }
+    uint64_t legacy_us = sim_i2c_stats[0].busy_us - mark.busy_us;
+    double legacy_per_integration = (double)legacy_us / integrations;
+    printf("leitura antiga: %u chamadas, %u transações, %llu us de barramento (%.0f us por integração), "
+           "%u leituras misturadas\n",
+           calls, sim_i2c_stats[0].transactions - mark.transactions, (unsigned long long)legacy_us,
+           legacy_per_integration, legacy_mixed);
+    printf("barramento por integração: %.1fx menos com a rajada\n",
+           legacy_per_integration / (burst_per_sample > 0 ? burst_per_sample : 1));
+    CHECK(burst_per_sample * 4 <= legacy_per_integration, "rajada %.0f us por amostra, antiga %.0f us por integração",
+          burst_per_sample, legacy_per_integration);
+
+    return check_exit("gy33_burst");
+}
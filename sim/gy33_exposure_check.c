@@ -0,0 +1,131 @@
+// Verificação no host da exposição automática do GY-33 (lib/sensores.c) sob
+// luz roteirizada, sobre o modelo do TCS34725 de sim_devices.c (sem ruído).
+//
+// A cena passa por níveis de ~1 a ~1000 contagens da exposição antiga (1x,
+// 11 ciclos) e volta. Em cada nível, depois de assentar, confere que:
+//   - os canais publicados batem com a cena na escala de
+//     GY33_REF_SENSITIVITY, com erro de no máximo uma contagem bruta do passo
+//     em uso (nenhuma troca de passo muda a escala);
+//   - no nível mais fraco as proporções entre os canais se mantêm (na escala
+//     antiga seriam 1, 2 e 3 contagens) e no mais forte nada satura;
+//   - o passo escolhido dá contagens suficientes sem chegar perto do fundo de
+//     escala, e o mais curto possível: a taxa de amostras sobe com a luz;
+//   - cada troca de nível assenta em menos de SETTLE_MAX_US.
+//
+// Uso: colorlux_gy33_exposure_check
+
+#include <stdio.h>
+#include "sim.h"
+#include "sensores.h"
+#include "check.h"
+
+#define POLL_US 2500           // COLOR_TASK_PERIOD_US do firmware
+#define HOLD_US 2000000        // Tempo em cada nível
+#define SETTLE_MAX_US 1000000
+#define I2C_BAUD 400000
+#define SIM_REF_SENSITIVITY 11 // Cenas de sim_devices.c: contagens a 1x, 11 ciclos
+
+typedef struct {
+    const char *name;
+    sim_scene_t scene;
+} level_t;
+
+static const level_t levels[] = {
+    {"muito fraca", {1, 1, 2, 3, 6}},
+    {"fraca", {10, 10, 20, 30, 60}},
+    {"média", {100, 100, 200, 300, 600}},
+    {"forte", {1000, 1000, 2000, 3000, 6000}},
+    {"fraca de novo", {3, 3, 6, 9, 18}},
+};
+#define LEVELS (sizeof(levels) / sizeof(levels[0]))
+
+static const uint8_t gain_mult[4] = {1, 4, 16, 60};
+
+static uint32_t current_sensitivity(void) {
+    uint8_t gain, atime;
+    gy33_get_exposure(&gain, &atime);
+    return gain_mult[gain & 3] * (256u - atime);
+}
+
+static uint32_t expected_counts(uint16_t scene_counts) {
+    return (uint32_t)scene_counts * GY33_REF_SENSITIVITY / SIM_REF_SENSITIVITY;
+}
+
+// Erro de no máximo uma contagem bruta do passo (mais o arredondamento)
+static bool close_to(uint32_t got, uint16_t scene_counts, uint32_t sensitivity) {
+    uint32_t expected = expected_counts(scene_counts);
+    uint32_t tol = GY33_REF_SENSITIVITY / sensitivity + 1;
+    return got + tol >= expected && got <= expected + tol;
+}
+
+int main(void) {
+    sim_devices_init();
+    sim_set_noise(0);
+    sim_set_scene(&levels[0].scene);
+    i2c_init(i2c0, I2C_BAUD);
+    i2c_async_init(i2c0);
+    gy33_set_auto_exposure(true);
+    gy33_init();
+
+    double rate[LEVELS];
+    printf("%-14s %5s %9s %9s %9s %9s %7s %10s\n", "nível", "passo", "r", "g", "b", "c", "amost/s",
+           "assentou");
+    for (uint32_t l = 0; l < LEVELS; l++) {
+        const sim_scene_t *sc = &levels[l].scene;
+        sim_set_scene(sc);
+        uint64_t start = sim_now_us();
+        uint64_t settled_at = 0;
+        uint32_t late_fresh = 0, late_bad = 0, bad_step = 0;
+        uint32_t r = 0, g = 0, b = 0, c = 0, sens = 0;
+        while (sim_now_us() - start < HOLD_US) {
+            uint64_t before = sim_now_us();
+            gy33_request_color();
+            if (gy33_poll_color(&r, &g, &b, &c)) {
+                sens = current_sensitivity();
+                bool ok = close_to(r, sc->r, sens) && close_to(g, sc->g, sens) && close_to(b, sc->b, sens) &&
+                          close_to(c, sc->c, sens);
+                if (ok && !settled_at)
+                    settled_at = sim_now_us();
+                else if (!ok)
+                    settled_at = 0;
+
+                // Segunda metade do nível: assentado, conta a taxa e confere o passo
+                if (sim_now_us() - start >= HOLD_US / 2) {
+                    late_fresh++;
+                    late_bad += !ok;
+                    uint32_t raw_c = (uint32_t)((uint64_t)c * sens / GY33_REF_SENSITIVITY);
+                    uint8_t gain, atime;
+                    gy33_get_exposure(&gain, &atime);
+                    uint32_t full_scale = (256u - atime) * 1024;
+                    if (full_scale > 65535) full_scale = 65535;
+                    bool last = gy33_get_exposure_step() == gy33_exposure_step_count() - 1;
+                    if ((raw_c < GY33_AE_TARGET_COUNTS / 2 && !last) || raw_c >= full_scale * 9 / 10)
+                        bad_step++;
+                }
+            }
+            sim_advance_to(before + POLL_US);
+        }
+        rate[l] = late_fresh / (HOLD_US / 2 / 1e6);
+        uint64_t settle_us = settled_at ? settled_at - start : UINT64_MAX;
+        printf("%-14s %5u %9u %9u %9u %9u %7.1f %7llu ms\n", levels[l].name, gy33_get_exposure_step(), r, g, b,
+               c, rate[l], (unsigned long long)(settle_us / 1000));
+
+        CHECK(settled_at && settle_us <= SETTLE_MAX_US, "%s: assentou em %llu us", levels[l].name,
+              (unsigned long long)settle_us);
+        CHECK(late_fresh > 0 && late_bad == 0, "%s: %u de %u amostras fora da cena depois de assentar",
+              levels[l].name, late_bad, late_fresh);
+        CHECK(bad_step == 0, "%s: %u amostras com o passo fraco demais ou saturado", levels[l].name, bad_step);
+        CHECK(c < GY33_COUNTS_MAX, "%s: c = %u saturado", levels[l].name, c);
+        if (l == 0) {
+            printf("  na escala antiga: r %u g %u b %u c %u\n", GY33_TO_1X11(r), GY33_TO_1X11(g), GY33_TO_1X11(b),
+                   GY33_TO_1X11(c));
+            // 1:2:3 com menos de 1% de erro
+            CHECK(r > 100 && (uint64_t)g * 100 >= (uint64_t)r * 198 && (uint64_t)g * 100 <= (uint64_t)r * 202 &&
+                      (uint64_t)b * 100 >= (uint64_t)r * 297 && (uint64_t)b * 100 <= (uint64_t)r * 303,
+                  "proporções perdidas na luz fraca: r %u g %u b %u", r, g, b);
+        }
+    }
+    CHECK(rate[3] >= 4 * rate[0], "taxa na luz forte %.1f/s, na fraca %.1f/s", rate[3], rate[0]);
+
+    return check_exit("gy33_exposure");
+}
@@ -0,0 +1,224 @@
+// Verificação no host de lib/i2c_async.c sobre o controlador I2C simulado em
+// nível de registrador (hardware/structs/i2c.h, sim_hw.c).
+//
+// Confere que:
+//   - escritas maiores que a FIFO de transmissão chegam inteiras, sem
+//     RESTART e com um STOP por transação;
+//   - escrita seguida de leitura sai com um RESTART, e leituras maiores que
+//     a FIFO de recepção não a transbordam, nem com a interrupção atrasada
+//     (a FIFO enche, o barramento fica retido e nada se perde);
+//   - transações alternando dois endereços trocam IC_TAR só com o
+//     controlador desabilitado e terminam na ordem da fila;
+//   - NACK de endereço termina em erro com a origem do abort, o STOP_DET
+//     seguinte encerra a transação e a próxima da fila sai normalmente;
+//   - o tempo de barramento de cada transação é o de sim_i2c_duration_us;
+//   - o handler nunca volta sem tratar a causa da interrupção.
+//
+// Uso: colorlux_i2c_async_check
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "i2c_async.h"
+#include "hardware/irq.h"
+#include "check.h"
+
+#define MEM_ADDR 0x50   // Memória de teste (ponteiro + dados, como uma EEPROM)
+#define TCS_ADDR 0x29   // TCS34725 de sim_devices.c
+#define NACK_ADDR 0x42  // Nada no barramento
+#define MEM_SIZE 256
+#define I2C_BAUD 400000
+#define TXN_TIMEOUT_US 20000 // Bem mais que qualquer transação daqui a 400 kHz
+#define IRQ_LATENCY_US 2000  // Interrupção desligada: mais que 16 bytes no barramento
+
+typedef struct {
+    uint8_t data[MEM_SIZE];
+    uint8_t ptr;
+} test_mem_t;
+
+static test_mem_t mem;
+
+static void mem_write(void *dev, const uint8_t *data, size_t len) {
+    test_mem_t *m = dev;
+    if (!len) return;
+    m->ptr = data[0];
+    for (size_t i = 1; i < len; i++)
+        m->data[m->ptr++] = data[i];
+}
+
+static void mem_read(void *dev, uint8_t *data, size_t len) {
+    test_mem_t *m = dev;
+    for (size_t i = 0; i < len; i++)
+        data[i] = m->data[m->ptr++];
+}
+
+static uint32_t done_order[I2C_ASYNC_QUEUE_SIZE];
+static uint32_t done_count;
+
+static void record_done(i2c_async_txn_t *txn) {
+    done_order[done_count++] = (uint32_t)(uintptr_t)txn->user_data;
+}
+
+static uint32_t irq_storms;
+
+static void stats_reset(void) {
+    irq_storms += sim_i2c_hw_stats[0].irq_storms;
+    memset(&sim_i2c_stats[0], 0, sizeof(sim_i2c_stats[0]));
+    memset(&sim_i2c_hw_stats[0], 0, sizeof(sim_i2c_hw_stats[0]));
+}
+
+// Como i2c_async_wait(), mas desiste se a transação não terminar (sem STOP,
+// por exemplo, o barramento fica retido para sempre)
+static bool wait_done(const i2c_async_txn_t *txn) {
+    uint64_t deadline = sim_now_us() + TXN_TIMEOUT_US;
+    while (txn->status == I2C_ASYNC_PENDING && sim_now_us() < deadline)
+        tight_loop_contents();
+    return txn->status != I2C_ASYNC_PENDING;
+}
+
+// Tempo da transação sozinha no barramento, da submissão ao fim
+static uint64_t timed_transfer(i2c_async_txn_t *txn) {
+    uint64_t t0 = sim_now_us();
+    CHECK(i2c_async_submit(txn), "fila recusou a transação para 0x%02x", txn->addr);
+    CHECK(wait_done(txn) && txn->status == I2C_ASYNC_DONE, "transação para 0x%02x falhou", txn->addr);
+    return sim_now_us() - t0;
+}
+
+static void check_long_write(void) {
+    uint8_t tx[1 + 40];
+    tx[0] = 0x10;
+    for (int i = 1; i < (int)sizeof(tx); i++)
+        tx[i] = (uint8_t)(0xA0 + i);
+    stats_reset();
+    i2c_async_txn_t txn = {.addr = MEM_ADDR, .tx = tx, .tx_len = sizeof(tx)};
+    uint64_t us = timed_transfer(&txn);
+
+    CHECK(!memcmp(&mem.data[0x10], &tx[1], sizeof(tx) - 1), "escrita longa: dados diferentes na memória");
+    CHECK(sim_i2c_hw_stats[0].restarts == 0, "escrita longa: %u RESTART", sim_i2c_hw_stats[0].restarts);
+    CHECK(sim_i2c_hw_stats[0].stops == 1, "escrita longa: %u STOP", sim_i2c_hw_stats[0].stops);
+    CHECK(sim_i2c_stats[0].bytes == sizeof(tx), "escrita longa: %u bytes no barramento", sim_i2c_stats[0].bytes);
+    CHECK(us == sim_i2c_duration_us(0, sizeof(tx), 0), "escrita longa: %llu us (esperado %u)",
+          (unsigned long long)us, sim_i2c_duration_us(0, sizeof(tx), 0));
+    printf("escrita de %u bytes: %llu us, %u interrupções\n", (unsigned)sizeof(tx),
+           (unsigned long long)us, sim_i2c_hw_stats[0].irqs);
+}
+
+static void check_long_read(void) {
+    for (int i = 0; i < MEM_SIZE; i++)
+        mem.data[i] = (uint8_t)(i * 7 + 3);
+    uint8_t ptr = 0x20, rx[60];
+    memset(rx, 0, sizeof(rx));
+    stats_reset();
+    i2c_async_txn_t txn = {.addr = MEM_ADDR, .tx = &ptr, .tx_len = 1, .rx = rx, .rx_len = sizeof(rx)};
+    uint64_t us = timed_transfer(&txn);
+
+    CHECK(!memcmp(rx, &mem.data[0x20], sizeof(rx)), "leitura longa: dados diferentes da memória");
+    CHECK(sim_i2c_hw_stats[0].restarts == 1, "leitura longa: %u RESTART", sim_i2c_hw_stats[0].restarts);
+    CHECK(sim_i2c_hw_stats[0].stops == 1, "leitura longa: %u STOP", sim_i2c_hw_stats[0].stops);
+    CHECK(sim_i2c_hw_stats[0].rx_overflows == 0 && sim_i2c_hw_stats[0].rx_max <= 16,
+          "leitura longa: FIFO de recepção transbordou (%u perdidos, máximo %u)",
+          sim_i2c_hw_stats[0].rx_overflows, sim_i2c_hw_stats[0].rx_max);
+    CHECK(us == sim_i2c_duration_us(0, 1, sizeof(rx)), "leitura longa: %llu us (esperado %u)",
+          (unsigned long long)us, sim_i2c_duration_us(0, 1, sizeof(rx)));
+    printf("escrita de 1 + leitura de %u bytes: %llu us, %u interrupções, FIFO de recepção até %u\n",
+           (unsigned)sizeof(rx), (unsigned long long)us, sim_i2c_hw_stats[0].irqs, sim_i2c_hw_stats[0].rx_max);
+}
+
+static void check_irq_latency(void) {
+    uint8_t ptr = 0x40, rx[40];
+    memset(rx, 0, sizeof(rx));
+    stats_reset();
+    i2c_async_txn_t txn = {.addr = MEM_ADDR, .tx = &ptr, .tx_len = 1, .rx = rx, .rx_len = sizeof(rx)};
+    CHECK(i2c_async_submit(&txn), "latência: fila recusou a transação");
+    // No 8º byte a FIFO de transmissão cai ao nível de TX_EMPTY (tx_tl = 8) e
+    // o handler a completa com leituras, até o limite de 16 pendentes
+    while (sim_i2c_stats[0].bytes < 8 && sim_run_next_event())
+        ;
+    irq_set_enabled(I2C0_IRQ, false);
+    sim_advance_to(sim_now_us() + IRQ_LATENCY_US);
+    uint32_t held_rx_max = sim_i2c_hw_stats[0].rx_max;
+    irq_set_enabled(I2C0_IRQ, true);
+    CHECK(wait_done(&txn) && txn.status == I2C_ASYNC_DONE, "latência: transação com status %d", txn.status);
+
+    CHECK(!memcmp(rx, &mem.data[0x40], sizeof(rx)), "latência: dados diferentes da memória");
+    CHECK(held_rx_max == 16, "latência: FIFO de recepção chegou a %u com a interrupção desligada", held_rx_max);
+    CHECK(sim_i2c_hw_stats[0].rx_overflows == 0, "latência: %u bytes perdidos", sim_i2c_hw_stats[0].rx_overflows);
+    CHECK(sim_i2c_hw_stats[0].stops == 1, "latência: %u STOP", sim_i2c_hw_stats[0].stops);
+}
+
+static void check_tar_switching(void) {
+    static const uint8_t id_cmd = 0x80 | 0x12; // Registrador de ID do TCS34725
+    static uint8_t mem_ptr = 0x00;
+    uint8_t id[4], data[4][3];
+    i2c_async_txn_t txns[8];
+    stats_reset();
+    done_count = 0;
+    for (uint32_t i = 0; i < 8; i++) {
+        if (i & 1)
+            txns[i] = (i2c_async_txn_t){.addr = TCS_ADDR, .tx = &id_cmd, .tx_len = 1, .rx = &id[i / 2], .rx_len = 1};
+        else
+            txns[i] = (i2c_async_txn_t){.addr = MEM_ADDR, .tx = &mem_ptr, .tx_len = 1, .rx = data[i / 2], .rx_len = 3};
+        txns[i].callback = record_done;
+        txns[i].user_data = (void *)(uintptr_t)i;
+        CHECK(i2c_async_submit(&txns[i]), "fila recusou a transação %u", i);
+    }
+    CHECK(wait_done(&txns[7]), "alternando endereços: fila não terminou");
+
+    for (uint32_t i = 0; i < 8; i++)
+        CHECK(txns[i].status == I2C_ASYNC_DONE, "alternando endereços: transação %u com status %d", i, txns[i].status);
+    for (int k = 0; k < 4; k++) {
+        CHECK(id[k] == 0x44, "alternando endereços: ID do TCS34725 0x%02x", id[k]);
+        CHECK(!memcmp(data[k], mem.data, 3), "alternando endereços: leitura %d da memória diferente", k);
+    }
+    CHECK(done_count == 8, "alternando endereços: %u callbacks", done_count);
+    for (uint32_t i = 0; i < done_count; i++)
+        CHECK(done_order[i] == i, "alternando endereços: %u terminou na posição %u", done_order[i], i);
+    // A primeira vai para o mesmo endereço da leitura anterior
+    CHECK(sim_i2c_hw_stats[0].tar_writes == 7, "alternando endereços: IC_TAR trocado %u vezes",
+          sim_i2c_hw_stats[0].tar_writes);
+    CHECK(sim_i2c_hw_stats[0].tar_ignored == 0, "alternando endereços: %u escritas em IC_TAR com o controlador habilitado",
+          sim_i2c_hw_stats[0].tar_ignored);
+    CHECK(sim_i2c_hw_stats[0].restarts == 8 && sim_i2c_hw_stats[0].stops == 8,
+          "alternando endereços: %u RESTART e %u STOP em 8 transações",
+          sim_i2c_hw_stats[0].restarts, sim_i2c_hw_stats[0].stops);
+}
+
+static void check_nack(void) {
+    static const uint8_t cmd[3] = {1, 2, 3};
+    uint8_t ptr = 0x20, rx[2];
+    stats_reset();
+    i2c_async_txn_t bad = {.addr = NACK_ADDR, .tx = cmd, .tx_len = sizeof(cmd)};
+    i2c_async_txn_t next = {.addr = MEM_ADDR, .tx = &ptr, .tx_len = 1, .rx = rx, .rx_len = sizeof(rx)};
+    CHECK(i2c_async_submit(&bad) && i2c_async_submit(&next), "NACK: fila recusou as transações");
+    CHECK(wait_done(&next), "NACK: fila não terminou");
+
+    CHECK(bad.status == I2C_ASYNC_ERROR, "NACK: status %d", bad.status);
+    CHECK(bad.abort_source & I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS,
+          "NACK: origem do abort 0x%x", bad.abort_source);
+    CHECK(next.status == I2C_ASYNC_DONE && !memcmp(rx, &mem.data[0x20], sizeof(rx)),
+          "NACK: a transação seguinte não terminou (status %d)", next.status);
+    CHECK(sim_i2c_hw_stats[0].aborts == 1 && sim_i2c_stats[0].nacks == 1,
+          "NACK: %u aborts, %u NACK", sim_i2c_hw_stats[0].aborts, sim_i2c_stats[0].nacks);
+    CHECK(sim_i2c_hw_stats[0].tx_overflows == 0, "NACK: %u comandos com a FIFO cheia",
+          sim_i2c_hw_stats[0].tx_overflows);
+    CHECK(!i2c_async_busy(), "NACK: fila ainda ocupada");
+}
+
+int main(void) {
+    sim_devices_init();
+    sim_i2c_attach(&(sim_i2c_device_t){0, MEM_ADDR, mem_write, mem_read, &mem});
+    i2c_init(i2c0, I2C_BAUD);
+    i2c_async_init(i2c0);
+
+    check_long_write();
+    check_long_read();
+    check_irq_latency();
+    check_tar_switching();
+    check_nack();
+
+    stats_reset();
+    CHECK(irq_storms == 0, "%u entradas no handler sem tratar a interrupção", irq_storms);
+
+    return check_exit("i2c_async");
+}
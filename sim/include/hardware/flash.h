@@ -0,0 +1,22 @@
+#ifndef SIM_HARDWARE_FLASH_H
+#define SIM_HARDWARE_FLASH_H
+
+#include "pico/stdlib.h"
+
+// Flash NOR simulada (sim_hw.c): programar só zera bits, apagar volta o
+// setor para 0xFF. A leitura é pelo "XIP", um vetor do host.
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#define FLASH_PAGE_SIZE 256u
+#define FLASH_SECTOR_SIZE 4096u
+
+extern uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)sim_flash)
+
+// Tamanho da imagem do firmware no início da flash (__flash_binary_end)
+extern uint32_t sim_flash_binary_size;
+#define FLASH_BINARY_END (XIP_BASE + sim_flash_binary_size)
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#endif // SIM_HARDWARE_FLASH_H
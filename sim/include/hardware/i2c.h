@@ -0,0 +1,32 @@
+#ifndef SIM_HARDWARE_I2C_H
+#define SIM_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+#include "hardware/structs/i2c.h"
+
+// Controladores I2C simulados: as transferências são entregues aos modelos
+// de dispositivo (sim_devices.c) e contabilizadas em sim_i2c_stats. As
+// bloqueantes vão inteiras para o modelo; i2c_get_hw() dá acesso aos
+// registradores do controlador (hardware/structs/i2c.h).
+
+typedef struct i2c_inst {
+    uint index;
+    uint baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+static inline uint i2c_get_index(i2c_inst_t *i2c) { return i2c->index; }
+
+// Também escolhe o controlador dos acessos seguintes (sim_i2c_reg)
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c);
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+#endif // SIM_HARDWARE_I2C_H
@@ -0,0 +1,44 @@
+#ifndef SIM_HARDWARE_PWM_H
+#define SIM_HARDWARE_PWM_H
+
+#include "pico/stdlib.h"
+
+typedef struct {
+    uint32_t csr;
+    uint32_t div;
+    uint32_t top;
+} pwm_config;
+
+// Registradores das fatias: CC e TOP podem ser escritos pelo DMA simulado,
+// um valor por período (DREQ de wrap)
+#define NUM_PWM_SLICES 8
+#define DREQ_PWM_WRAP0 24
+
+typedef struct {
+    volatile uint32_t csr;
+    volatile uint32_t div;      // 8.4
+    volatile uint32_t ctr;
+    volatile uint32_t cc;       // A nos 16 bits baixos, B nos altos
+    volatile uint32_t top;
+} pwm_slice_hw_t;
+
+typedef struct {
+    pwm_slice_hw_t slice[NUM_PWM_SLICES];
+} pwm_hw_t;
+
+extern pwm_hw_t *const pwm_hw;
+
+static inline uint pwm_get_dreq(uint slice_num) {
+    return DREQ_PWM_WRAP0 + slice_num;
+}
+
+uint pwm_gpio_to_slice_num(uint gpio);
+uint pwm_gpio_to_channel(uint gpio);
+pwm_config pwm_get_default_config(void);
+void pwm_init(uint slice_num, pwm_config *c, bool start);
+void pwm_set_clkdiv(uint slice_num, float divider);
+void pwm_set_wrap(uint slice_num, uint16_t wrap);
+void pwm_set_gpio_level(uint gpio, uint16_t level);
+void pwm_set_enabled(uint slice_num, bool enabled);
+
+#endif // SIM_HARDWARE_PWM_H
@@ -0,0 +1,90 @@
+#ifndef SIM_HARDWARE_STRUCTS_I2C_H
+#define SIM_HARDWARE_STRUCTS_I2C_H
+
+#include "pico/stdlib.h"
+
+// Registradores do controlador I2C (DW_apb_i2c) usados por lib/i2c_async.c,
+// com os efeitos do hardware modelados em sim_hw.c: ler IC_DATA_CMD tira um
+// byte da FIFO de recepção e escrever põe um comando na de transmissão, ler
+// IC_CLR_* limpa a interrupção, IC_TAR só muda com o controlador desabilitado.
+//
+// Um campo de struct em C não tem efeito colateral, então cada registrador é
+// um par de palavras e o nome do campo é uma macro que indexa pelo retorno de
+// sim_i2c_reg(). A função deixa o valor de leitura na palavra escolhida e, no
+// acesso seguinte (ou quando o controlador anda no relógio virtual), compara a
+// palavra com o que deixou para saber se o firmware leu ou escreveu. Cada
+// expressão pode acessar um registrador só (uma leitura, uma escrita ou um
+// &=/|=), o que lib/i2c_async.c respeita.
+
+#define SIM_I2C_REG_SLOTS 2
+
+typedef volatile uint32_t sim_i2c_reg_t[SIM_I2C_REG_SLOTS];
+
+// Mesma ordem de i2c_hw_t
+enum sim_i2c_reg {
+    SIM_I2C_ENABLE,
+    SIM_I2C_TAR,
+    SIM_I2C_DATA_CMD,
+    SIM_I2C_RXFLR,
+    SIM_I2C_TXFLR,
+    SIM_I2C_INTR_MASK,
+    SIM_I2C_INTR_STAT,
+    SIM_I2C_CLR_STOP_DET,
+    SIM_I2C_CLR_TX_ABRT,
+    SIM_I2C_TX_ABRT_SOURCE,
+    SIM_I2C_RX_TL,
+    SIM_I2C_TX_TL,
+    SIM_I2C_NUM_REGS
+};
+
+typedef struct {
+    sim_i2c_reg_t enable;
+    sim_i2c_reg_t tar;
+    sim_i2c_reg_t data_cmd;
+    sim_i2c_reg_t rxflr;
+    sim_i2c_reg_t txflr;
+    sim_i2c_reg_t intr_mask;
+    sim_i2c_reg_t intr_stat;
+    sim_i2c_reg_t clr_stop_det;
+    sim_i2c_reg_t clr_tx_abrt;
+    sim_i2c_reg_t tx_abrt_source;
+    sim_i2c_reg_t rx_tl;
+    sim_i2c_reg_t tx_tl;
+} i2c_hw_t;
+
+uint sim_i2c_reg(enum sim_i2c_reg reg);
+
+// sim_hw.c acessa as palavras diretamente
+#ifndef SIM_I2C_HW_IMPL
+#define enable enable[sim_i2c_reg(SIM_I2C_ENABLE)]
+#define tar tar[sim_i2c_reg(SIM_I2C_TAR)]
+#define data_cmd data_cmd[sim_i2c_reg(SIM_I2C_DATA_CMD)]
+#define rxflr rxflr[sim_i2c_reg(SIM_I2C_RXFLR)]
+#define txflr txflr[sim_i2c_reg(SIM_I2C_TXFLR)]
+#define intr_mask intr_mask[sim_i2c_reg(SIM_I2C_INTR_MASK)]
+#define intr_stat intr_stat[sim_i2c_reg(SIM_I2C_INTR_STAT)]
+#define clr_stop_det clr_stop_det[sim_i2c_reg(SIM_I2C_CLR_STOP_DET)]
+#define clr_tx_abrt clr_tx_abrt[sim_i2c_reg(SIM_I2C_CLR_TX_ABRT)]
+#define tx_abrt_source tx_abrt_source[sim_i2c_reg(SIM_I2C_TX_ABRT_SOURCE)]
+#define rx_tl rx_tl[sim_i2c_reg(SIM_I2C_RX_TL)]
+#define tx_tl tx_tl[sim_i2c_reg(SIM_I2C_TX_TL)]
+#endif
+
+// Bits de hardware/regs/i2c.h
+#define I2C_IC_DATA_CMD_CMD_BITS             0x00000100u
+#define I2C_IC_DATA_CMD_STOP_BITS            0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS         0x00000400u
+
+#define I2C_IC_INTR_MASK_M_RX_FULL_BITS      0x00000004u
+#define I2C_IC_INTR_MASK_M_TX_EMPTY_BITS     0x00000010u
+#define I2C_IC_INTR_MASK_M_TX_ABRT_BITS      0x00000040u
+#define I2C_IC_INTR_MASK_M_STOP_DET_BITS     0x00000200u
+
+#define I2C_IC_INTR_STAT_R_RX_FULL_BITS      0x00000004u
+#define I2C_IC_INTR_STAT_R_TX_EMPTY_BITS     0x00000010u
+#define I2C_IC_INTR_STAT_R_TX_ABRT_BITS      0x00000040u
+#define I2C_IC_INTR_STAT_R_STOP_DET_BITS     0x00000200u
+
+#define I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS 0x00000001u
+
+#endif // SIM_HARDWARE_STRUCTS_I2C_H
@@ -0,0 +1,29 @@
+#ifndef SIM_HARDWARE_SYNC_H
+#define SIM_HARDWARE_SYNC_H
+
+#include "pico/stdlib.h"
+
+// Na simulação os "núcleos" e as "interrupções" rodam na mesma thread, então
+// seções críticas e WFE/SEV não têm efeito além das barreiras do compilador.
+
+static inline void __mem_fence_acquire(void) { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
+static inline void __mem_fence_release(void) { __atomic_thread_fence(__ATOMIC_RELEASE); }
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __sev(void) {}
+static inline void __wfe(void) { tight_loop_contents(); }
+static inline void __wfi(void) { tight_loop_contents(); }
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+typedef uint32_t spin_lock_t;
+
+static inline uint spin_lock_claim_unused(bool required) { (void)required; return 0; }
+static inline spin_lock_t *spin_lock_init(uint lock_num) {
+    static spin_lock_t locks[32];
+    return &locks[lock_num];
+}
+static inline uint32_t spin_lock_blocking(spin_lock_t *lock) { (void)lock; return 0; }
+static inline void spin_unlock(spin_lock_t *lock, uint32_t saved_irq) { (void)lock; (void)saved_irq; }
+
+#endif // SIM_HARDWARE_SYNC_H
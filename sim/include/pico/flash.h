@@ -0,0 +1,10 @@
+#ifndef SIM_PICO_FLASH_H
+#define SIM_PICO_FLASH_H
+
+#include "pico/stdlib.h"
+
+// Sem segundo núcleo de verdade nem XIP a proteger: só executa func
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms);
+bool flash_safe_execute_core_init(void);
+
+#endif // SIM_PICO_FLASH_H
@@ -0,0 +1,9 @@
+#ifndef SIM_PICO_MULTICORE_H
+#define SIM_PICO_MULTICORE_H
+
+#include "pico/stdlib.h"
+
+// A simulação roda os dois lados do pipeline na mesma thread (sim_main.c)
+void multicore_launch_core1(void (*entry)(void));
+
+#endif // SIM_PICO_MULTICORE_H
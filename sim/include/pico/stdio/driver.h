@@ -0,0 +1,21 @@
+#ifndef SIM_PICO_STDIO_DRIVER_H
+#define SIM_PICO_STDIO_DRIVER_H
+
+#include "pico/stdlib.h"
+
+// Drivers do stdio: na simulação o printf do firmware vai direto para o
+// stdout (sim_printf), então habilitar um driver só fica registrado.
+
+typedef struct stdio_driver stdio_driver_t;
+
+struct stdio_driver {
+    void (*out_chars)(const char *buf, int len);
+    void (*out_flush)(void);
+    int (*in_chars)(char *buf, int len);
+    void (*set_chars_available_callback)(void (*fn)(void *), void *param);
+    stdio_driver_t *next;
+};
+
+void stdio_set_driver_enabled(stdio_driver_t *driver, bool enabled);
+
+#endif // SIM_PICO_STDIO_DRIVER_H
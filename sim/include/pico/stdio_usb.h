@@ -0,0 +1,10 @@
+#ifndef SIM_PICO_STDIO_USB_H
+#define SIM_PICO_STDIO_USB_H
+
+#include "pico/stdio/driver.h"
+
+// Driver stdio do CDC USB: out_chars escreve no CDC simulado (tusb.h) e
+// in_chars nunca tem dados.
+extern stdio_driver_t stdio_usb;
+
+#endif // SIM_PICO_STDIO_USB_H
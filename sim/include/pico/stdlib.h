@@ -0,0 +1,67 @@
+#ifndef SIM_PICO_STDLIB_H
+#define SIM_PICO_STDLIB_H
+
+// Shim do pico/stdlib.h para a simulação no host: tempo virtual controlado
+// por sim_hw.c (sleep e espera ativa avançam o relógio e disparam eventos).
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define PICO_OK 0
+#define PICO_ERROR_NONE 0
+#define PICO_ERROR_TIMEOUT -1
+#define PICO_ERROR_GENERIC -2
+#define PICO_ERROR_NO_DATA -3
+
+#define __not_in_flash_func(func) func
+#define __time_critical_func(func) func
+
+absolute_time_t get_absolute_time(void);
+void sleep_until(absolute_time_t t);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void tight_loop_contents(void);
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp);
+uint get_core_num(void); // sim_core_num (sim.h)
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline uint64_t time_us_64(void) { return get_absolute_time(); }
+static inline uint32_t time_us_32(void) { return (uint32_t)get_absolute_time(); }
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + (uint64_t)ms * 1000; }
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return delayed_by_us(get_absolute_time(), us); }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return delayed_by_ms(get_absolute_time(), ms); }
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+static inline bool time_reached(absolute_time_t t) { return get_absolute_time() >= t; }
+
+// Timers periódicos (pico/time.h): eventos na fila de sim_hw.c, rodando
+// como interrupção no instante em que o relógio virtual passa
+typedef struct alarm_pool alarm_pool_t;
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t *rt);
+
+struct repeating_timer {
+    int64_t delay_us;
+    alarm_pool_t *pool;
+    int32_t alarm_id; // 0: cancelado
+    repeating_timer_callback_t callback;
+    void *user_data;
+};
+
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers);
+bool alarm_pool_add_repeating_timer_us(alarm_pool_t *pool, int64_t delay_us, repeating_timer_callback_t callback,
+                                       void *user_data, repeating_timer_t *out);
+bool cancel_repeating_timer(repeating_timer_t *timer);
+
+#include "hardware/gpio.h"
+
+#endif // SIM_PICO_STDLIB_H
@@ -0,0 +1,18 @@
+#ifndef SIM_TUSB_H
+#define SIM_TUSB_H
+
+#include "pico/stdlib.h"
+
+// CDC USB simulado: os bytes escritos vão para o arquivo de sim_usb_cdc_out
+// (opção -T do simulador) e a banda é a de um endpoint full-speed.
+
+extern FILE *sim_usb_cdc_out;
+extern uint32_t sim_usb_cdc_bytes;
+
+bool tud_cdc_connected(void);
+uint32_t tud_cdc_write_available(void);
+uint32_t tud_cdc_write(const void *buf, uint32_t n);
+uint32_t tud_cdc_write_flush(void);
+void tud_task(void);
+
+#endif // SIM_TUSB_H
@@ -0,0 +1,106 @@
+// Verificação no host da agregação de latências (lib/prof.h).
+//
+// Confere que:
+//   - contagem, mínimo, máximo e média batem com os registros feitos;
+//   - 0, 1, 2^k-1, 2^k e UINT32_MAX caem nos baldes log2 esperados, com os
+//     maiores presos em PROF_BUCKETS-1;
+//   - prof_reset() zera tudo e volta o mínimo para UINT32_MAX;
+//   - registros de estágios a partir do número passado a prof_init() são
+//     ignorados, e prof_get() retorna NULL para eles.
+//
+// Uso: colorlux_prof_check
+
+#include <stdio.h>
+#include "prof.h"
+#include "check.h"
+
+static const char *const names[] = {"a", "b", "c"};
+
+static uint32_t hist_total(const prof_stat_t *s) {
+    uint32_t n = 0;
+    for (uint b = 0; b < PROF_BUCKETS; b++)
+        n += s->hist[b];
+    return n;
+}
+
+static void check_stats(void) {
+    prof_init(names, 3);
+    const uint32_t samples[] = {10, 3, 250, 40, 97};
+    for (uint i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+        prof_record(1, samples[i]);
+
+    const prof_stat_t *s = prof_get(1);
+    CHECK(s, "prof_get(1) nulo");
+    if (!s)
+        return;
+    CHECK(s->count == 5, "count %u, esperado 5", s->count);
+    CHECK(s->min_us == 3, "min %u, esperado 3", s->min_us);
+    CHECK(s->max_us == 250, "max %u, esperado 250", s->max_us);
+    CHECK(s->sum_us / s->count == 80, "média %llu, esperado 80",
+          (unsigned long long)(s->sum_us / s->count));
+    CHECK(hist_total(s) == 5, "histograma com %u medidas, esperado 5", hist_total(s));
+    CHECK(s->hist[prof_bucket(250)] == 1, "250 us fora do balde %u", prof_bucket(250));
+
+    // Os outros estágios não são tocados
+    CHECK(prof_get(0)->count == 0 && prof_get(0)->min_us == UINT32_MAX, "estágio 0 alterado");
+}
+
+static void check_buckets(void) {
+    CHECK(prof_bucket(0) == 0, "0 no balde %u, esperado 0", prof_bucket(0));
+    CHECK(prof_bucket(1) == 1, "1 no balde %u, esperado 1", prof_bucket(1));
+    for (uint k = 1; k < 32; k++) {
+        uint32_t lo = 1u << k;
+        uint expect_hi = k < PROF_BUCKETS ? k : PROF_BUCKETS - 1;
+        uint expect_lo = k + 1 < PROF_BUCKETS ? k + 1 : PROF_BUCKETS - 1;
+        CHECK(prof_bucket(lo - 1) == expect_hi, "2^%u-1 no balde %u, esperado %u", k,
+              prof_bucket(lo - 1), expect_hi);
+        CHECK(prof_bucket(lo) == expect_lo, "2^%u no balde %u, esperado %u", k, prof_bucket(lo),
+              expect_lo);
+    }
+    CHECK(prof_bucket(UINT32_MAX) == PROF_BUCKETS - 1, "UINT32_MAX no balde %u, esperado %u",
+          prof_bucket(UINT32_MAX), PROF_BUCKETS - 1);
+
+    // O registro usa o mesmo balde
+    prof_init(names, 3);
+    prof_record(0, UINT32_MAX);
+    prof_record(0, 0);
+    const prof_stat_t *s = prof_get(0);
+    CHECK(s->hist[PROF_BUCKETS - 1] == 1 && s->hist[0] == 1, "UINT32_MAX/0 fora dos baldes extremos");
+    CHECK(s->min_us == 0 && s->max_us == UINT32_MAX, "min %u max %u após 0 e UINT32_MAX",
+          s->min_us, s->max_us);
+}
+
+static void check_reset(void) {
+    prof_init(names, 3);
+    prof_record(2, 123);
+    prof_reset();
+    const prof_stat_t *s = prof_get(2);
+    CHECK(s->count == 0 && s->sum_us == 0 && s->max_us == 0, "prof_reset não zerou o estágio 2");
+    CHECK(s->min_us == UINT32_MAX, "min %u após prof_reset, esperado UINT32_MAX", s->min_us);
+    CHECK(hist_total(s) == 0, "histograma com %u medidas após prof_reset", hist_total(s));
+}
+
+static void check_out_of_range(void) {
+    prof_init(names, 2);
+    prof_record(2, 50);
+    prof_record(PROF_MAX_STAGES, 50);
+    prof_record(UINT32_MAX, 50);
+    CHECK(prof_get(2) == NULL, "prof_get(2) com 2 estágios não é nulo");
+    CHECK(prof_get(PROF_MAX_STAGES) == NULL, "prof_get(PROF_MAX_STAGES) não é nulo");
+    CHECK(prof_get(0)->count == 0 && prof_get(1)->count == 0, "registro fora da faixa foi contado");
+
+    // Mais estágios que PROF_MAX_STAGES ficam limitados
+    static const char *const many[PROF_MAX_STAGES + 4];
+    prof_init(many, PROF_MAX_STAGES + 4);
+    prof_record(PROF_MAX_STAGES, 50);
+    CHECK(prof_get(PROF_MAX_STAGES) == NULL, "prof_init não limitou a PROF_MAX_STAGES");
+    CHECK(prof_get(PROF_MAX_STAGES - 1)->count == 0, "último estágio alterado");
+}
+
+int main(void) {
+    check_stats();
+    check_buckets();
+    check_reset();
+    check_out_of_range();
+    return check_exit("prof");
+}
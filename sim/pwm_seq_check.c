@@ -0,0 +1,208 @@
+// Verificação no host das sequências de PWM por DMA (lib/pwm_seq.h).
+//
+// 1. Geração das tabelas: períodos e notas (TOP) contra as frequências
+//    pedidas, degraus de bipe, rampas com gamma (último valor exato, sem
+//    voltar) e tabelas que não cabem.
+// 2. Reprodução sobre o PWM/DMA simulados: uma vez (para no último valor),
+//    em laço pelo canal de controle (várias voltas sem a CPU), nota pelo
+//    TOP com a duração de cada período, interrupção e troca de padrão.
+//
+// Uso: colorlux_pwm_seq_check
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sim.h"
+#include "hardware/pwm.h"
+#include "color.h"
+#include "pwm_seq.h"
+#include "check.h"
+
+#define SYS_HZ 125000000u
+#define BUZZER_PIN 21
+#define BUZZER_TOP 59609
+#define BUZZER_DIV16 256
+#define RED_PIN 13          // Fatia 6 B; o azul (12) é a 6 A
+#define TABLE_MAX 512
+
+static uint32_t table[TABLE_MAX];
+
+// Período da fatia como o modelo do PWM o conta (us inteiros)
+static uint64_t period_us(uint slice) {
+    return ((uint64_t)pwm_hw->slice[slice].top + 1) * pwm_hw->slice[slice].div / (16 * 125);
+}
+
+static void check_tables(void) {
+    CHECK(pwm_seq_period_ns(SYS_HZ, BUZZER_DIV16, BUZZER_TOP) == 7630080,
+          "período do buzzer: %u ns", pwm_seq_period_ns(SYS_HZ, BUZZER_DIV16, BUZZER_TOP));
+    CHECK(pwm_seq_period_ns(SYS_HZ, 16, 0xffff) == 524288, "período do LED");
+    CHECK(pwm_seq_periods(7630080, 150) == 20, "150 ms: %u períodos", pwm_seq_periods(7630080, 150));
+    CHECK(pwm_seq_periods(7630080, 1) == 1, "menos de um período não vira 0");
+
+    // Notas: erro de frequência pelo arredondamento do TOP (abaixo de ~119 Hz
+    // o TOP satura com divisor 16)
+    double worst = 0;
+    for (uint32_t hz = 150; hz <= 5000; hz += 10) {
+        uint16_t top = pwm_seq_tone_top(SYS_HZ, BUZZER_DIV16, hz);
+        double real = (double)SYS_HZ * 16 / BUZZER_DIV16 / (top + 1);
+        double err = real > hz ? (real - hz) / hz : (hz - real) / hz;
+        if (err > worst) worst = err;
+    }
+    CHECK(worst < 0.001, "erro de frequência de %.3f%%", worst * 100);
+    CHECK(pwm_seq_tone_top(SYS_HZ, BUZZER_DIV16, 10) == 65535, "nota grave demais não satura o TOP");
+    printf("notas de 150 a 5000 Hz: erro máximo de %.4f%%\n", worst * 100);
+
+    // Degraus
+    CHECK(pwm_seq_build_hold(table, TABLE_MAX, 7, TABLE_MAX + 1) == 0, "degrau maior que a tabela");
+    uint32_t n = pwm_seq_build_hold(table, TABLE_MAX, PWM_SEQ_CC(0, 1000), 20);
+    n += pwm_seq_build_hold(table + n, TABLE_MAX - n, PWM_SEQ_CC(0, 0), 20);
+    CHECK(n == 40 && table[19] == 1000u << 16 && table[20] == 0, "bipe de 20 + 20 períodos");
+
+    // Rampas: de (a0, b0) a (a1, b1) em períodos, último valor exato
+    static const uint8_t ends[][4] = {{0, 255, 255, 0}, {10, 10, 200, 11}, {255, 0, 254, 1}, {7, 7, 7, 7}};
+    static const uint32_t lengths[] = {1, 3, 16, 500};
+    for (uint e = 0; e < sizeof(ends) / sizeof(ends[0]); e++) {
+        for (uint l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+            const uint8_t *v = ends[e];
+            n = pwm_seq_build_ramp(table, TABLE_MAX, lengths[l], v[0], v[1], v[2], v[3]);
+            CHECK(n == lengths[l], "rampa de %u: %u valores", lengths[l], n);
+            CHECK(table[n - 1] == PWM_SEQ_CC(color_pwm_level(v[2]), color_pwm_level(v[3])),
+                  "rampa (%u,%u)->(%u,%u) em %u: último valor %08x", v[0], v[1], v[2], v[3], n, table[n - 1]);
+            uint32_t prev = PWM_SEQ_CC(color_pwm_level(v[0]), color_pwm_level(v[1]));
+            bool monotonic = true;
+            for (uint32_t i = 0; i < n; i++) {
+                int da = (int)(table[i] & 0xffff) - (int)(prev & 0xffff);
+                int db = (int)(table[i] >> 16) - (int)(prev >> 16);
+                if ((v[2] >= v[0] ? da < 0 : da > 0) || (v[3] >= v[1] ? db < 0 : db > 0))
+                    monotonic = false;
+                prev = table[i];
+            }
+            CHECK(monotonic, "rampa (%u,%u)->(%u,%u) em %u voltou", v[0], v[1], v[2], v[3], n);
+        }
+    }
+    CHECK(pwm_seq_build_ramp(table, 10, 11, 0, 0, 255, 255) == 0, "rampa maior que a tabela");
+    CHECK(pwm_seq_build_ramp(table, 10, 0, 0, 0, 255, 255) == 0, "rampa de 0 períodos");
+
+    // Nota: um TOP por período da própria nota
+    n = pwm_seq_build_tone(table, TABLE_MAX, SYS_HZ, BUZZER_DIV16, 440, 250);
+    CHECK(n >= 109 && n <= 111, "440 Hz por 250 ms: %u períodos", n);
+    CHECK(table[0] == pwm_seq_tone_top(SYS_HZ, BUZZER_DIV16, 440) && table[n - 1] == table[0], "nota: TOP");
+    CHECK(pwm_seq_build_tone(table, TABLE_MAX, SYS_HZ, BUZZER_DIV16, 0, 250) == 0, "nota de 0 Hz");
+    CHECK(pwm_seq_build_tone(table, 100, SYS_HZ, BUZZER_DIV16, 440, 250) == 0, "nota maior que a tabela");
+}
+
+// Uma vez: rampa no LED vermelho/azul, um valor por período, para no último
+static void check_one_shot(pwm_seq_t *s) {
+    uint slice = s->slice;
+    uint32_t n = pwm_seq_build_ramp(table, TABLE_MAX, 64, 0, 0, 200, 255);
+    uint64_t p = period_us(slice);
+    uint64_t t0 = sim_now_us();
+    pwm_seq_start(s, PWM_SEQ_REG_CC, table, n, false);
+
+    uint32_t wrong = 0;
+    for (uint32_t k = 1; k <= n; k++) {
+        sim_advance_to(t0 + k * p + p / 2); // Meio do período k: vale table[k - 1]
+        if (pwm_hw->slice[slice].cc != table[k - 1]) wrong++;
+        if (k < n && !pwm_seq_is_busy(s)) wrong++;
+    }
+    CHECK(wrong == 0, "uma vez: %u períodos com valor errado", wrong);
+    CHECK(!pwm_seq_is_busy(s), "uma vez: ocupada depois do último valor");
+    CHECK(sim_pwm_level[RED_PIN] == color_pwm_level(255) && sim_pwm_level[RED_PIN - 1] == color_pwm_level(200),
+          "uma vez: LED terminou em %u/%u", sim_pwm_level[RED_PIN], sim_pwm_level[RED_PIN - 1]);
+    sim_advance_to(sim_now_us() + 10 * p);
+    CHECK(pwm_hw->slice[slice].cc == table[n - 1], "uma vez: saída mudou depois do fim");
+    printf("uma vez: %u valores em %llu us (%llu us por período)\n",
+           n, (unsigned long long)(n * p), (unsigned long long)p);
+}
+
+// Em laço: bipe no buzzer por várias voltas, depois interrompido
+static void check_loop(pwm_seq_t *s) {
+    uint slice = s->slice;
+    pwm_set_clkdiv(slice, BUZZER_DIV16 / 16.0f);
+    pwm_set_wrap(slice, BUZZER_TOP);
+    uint64_t p = period_us(slice);
+    uint32_t n = pwm_seq_build_hold(table, TABLE_MAX, PWM_SEQ_CC(0, BUZZER_TOP * 3 / 10), 20);
+    n += pwm_seq_build_hold(table + n, TABLE_MAX - n, PWM_SEQ_CC(0, 0), 20);
+
+    uint64_t t0 = sim_now_us();
+    pwm_seq_start(s, PWM_SEQ_REG_CC, table, n, true);
+    const uint32_t loops = 5;
+    uint32_t wrong = 0, edges = 0;
+    uint16_t last = sim_pwm_level[BUZZER_PIN];
+    for (uint32_t k = 1; k <= loops * n; k++) {
+        sim_advance_to(t0 + k * p + p / 2);
+        if (pwm_hw->slice[slice].cc != table[(k - 1) % n]) wrong++;
+        if (sim_pwm_level[BUZZER_PIN] != last) edges++;
+        last = sim_pwm_level[BUZZER_PIN];
+    }
+    CHECK(wrong == 0, "laço: %u períodos com valor errado em %u voltas", wrong, loops);
+    CHECK(edges == 2 * loops, "laço: %u bordas em %u voltas", edges, loops);
+    CHECK(pwm_seq_is_busy(s), "laço: parou sozinho");
+    printf("laço: %u voltas de %u períodos (%llu ms cada) sem a CPU\n",
+           loops, n, (unsigned long long)(n * p / 1000));
+
+    pwm_seq_stop(s);
+    uint32_t held = pwm_hw->slice[slice].cc;
+    sim_advance_to(sim_now_us() + 3 * n * p);
+    CHECK(!pwm_seq_is_busy(s), "laço: ocupada depois de interrompida");
+    CHECK(pwm_hw->slice[slice].cc == held, "laço: saída mudou depois de interrompida");
+}
+
+// Notas pelo TOP: duas notas alternadas, cada valor dura um período da nota
+// que ele mesmo define; troca direto para um bipe no CC
+static void check_tone(pwm_seq_t *s) {
+    uint slice = s->slice;
+    uint32_t n = pwm_seq_build_tone(table, TABLE_MAX, SYS_HZ, BUZZER_DIV16, 440, 250);
+    uint32_t low = n;
+    n += pwm_seq_build_tone(table + n, TABLE_MAX - n, SYS_HZ, BUZZER_DIV16, 660, 250);
+
+    pwm_seq_start(s, PWM_SEQ_REG_TOP, table, n, true);
+    uint32_t seen_low = 0, seen_high = 0;
+    uint64_t t0 = sim_now_us();
+    while (sim_now_us() < t0 + 2000000) {
+        sim_advance_to(sim_now_us() + period_us(slice));
+        if (pwm_hw->slice[slice].top == table[0]) seen_low++;
+        else if (pwm_hw->slice[slice].top == table[low]) seen_high++;
+    }
+    CHECK(seen_low && seen_high, "notas: %u períodos graves e %u agudos", seen_low, seen_high);
+    double ratio = (double)seen_high / seen_low;
+    CHECK(ratio > 1.4 && ratio < 1.6, "notas: %u períodos agudos para %u graves", seen_high, seen_low);
+    printf("notas: %u TOPs por volta, %u períodos de 440 Hz e %u de 660 Hz em 2 s\n", n, seen_low, seen_high);
+
+    // Troca de padrão sem esperar a volta terminar
+    pwm_seq_stop(s);
+    pwm_set_wrap(slice, BUZZER_TOP);
+    static uint32_t beep[2] = {PWM_SEQ_CC(0, 1234), PWM_SEQ_CC(0, 0)};
+    t0 = sim_now_us();
+    pwm_seq_start(s, PWM_SEQ_REG_CC, beep, 2, true);
+    uint64_t p = period_us(slice);
+    uint32_t wrong = 0, edges = 0;
+    // O primeiro valor sai no próximo wrap, que pode ter sido agendado ainda
+    // no período da nota: a fase é livre, mas a saída alterna a cada período
+    sim_advance_to(t0 + p + p / 2);
+    uint16_t last = sim_pwm_level[BUZZER_PIN];
+    for (uint32_t k = 2; k <= 10; k++) {
+        sim_advance_to(t0 + k * p + p / 2);
+        uint16_t level = sim_pwm_level[BUZZER_PIN];
+        if (pwm_hw->slice[slice].top != BUZZER_TOP || (level != 1234 && level != 0)) wrong++;
+        if (level != last) edges++;
+        last = level;
+    }
+    CHECK(wrong == 0 && edges == 9, "troca de padrão: %u períodos errados, %u bordas em 9", wrong, edges);
+    pwm_seq_stop(s);
+}
+
+int main(void) {
+    check_tables();
+
+    pwm_seq_t led, buzzer;
+    pwm_seq_init(&led, pwm_gpio_to_slice_num(RED_PIN));
+    pwm_seq_init(&buzzer, pwm_gpio_to_slice_num(BUZZER_PIN));
+    CHECK(led.data_channel != buzzer.data_channel && led.ctrl_channel != buzzer.ctrl_channel, "canais repetidos");
+    CHECK(!pwm_seq_is_busy(&led), "ocupada antes de iniciar");
+
+    check_one_shot(&led);
+    check_loop(&buzzer);
+    check_tone(&buzzer);
+
+    return check_exit("pwm_seq");
+}
@@ -0,0 +1,107 @@
+// Teste de estresse no host da fila entre os núcleos (lib/sample_ring.h) com
+// duas threads de verdade, no lugar dos núcleos 0 e 1: o produtor empurra
+// amostras sem parar (com a fila cheia, cede a CPU e tenta a mesma de novo,
+// para que todas passem pela fila) e o consumidor alterna
+// sample_ring_pop_latest() e sample_ring_pop().
+//
+// Todos os campos de uma amostra derivam do seu seq, então o consumidor
+// confere que:
+//   - nenhuma amostra lida está rasgada (campos de amostras diferentes);
+//   - o seq nunca volta nem se repete (pop_latest não devolve uma mais velha
+//     que a última lida);
+//   - lidas + descartadas pelo pop_latest = empurradas, e cada recusa com a
+//     fila cheia foi contada em dropped.
+//
+// Uso: colorlux_sample_ring_stress [amostras]
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../lib/sample_ring.h"
+#include "check.h"
+
+static sample_ring_t ring;
+static uint32_t total;
+static volatile int producer_done;
+static uint32_t refused;
+
+static sensor_sample_t make_sample(uint32_t seq) {
+    sensor_sample_t s;
+    s.seq = seq;
+    s.r = (uint16_t)seq;
+    s.g = (uint16_t)~seq;
+    s.b = (uint16_t)(seq * 3u);
+    s.c = (uint16_t)(seq >> 16);
+    s.lux = (uint16_t)(seq ^ 0xA5A5u);
+    s.timestamp_us = seq * 2654435761u;
+    return s;
+}
+
+static bool sample_intact(const sensor_sample_t *s) {
+    sensor_sample_t e = make_sample(s->seq);
+    return s->r == e.r && s->g == e.g && s->b == e.b && s->c == e.c && s->lux == e.lux &&
+           s->timestamp_us == e.timestamp_us;
+}
+
+static void *producer(void *arg) {
+    (void)arg;
+    for (uint32_t seq = 1; seq <= total; seq++) {
+        sensor_sample_t s = make_sample(seq);
+        while (!sample_ring_push(&ring, &s)) {
+            refused++;
+            sched_yield();
+        }
+    }
+    __atomic_store_n(&producer_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    total = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000000;
+    if (!total) total = 2000000;
+    sample_ring_init(&ring);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, producer, NULL)) {
+        printf("FALHOU: pthread_create\n");
+        return 1;
+    }
+
+    uint32_t last_seq = 0, reads = 0, latest_reads = 0, skipped = 0, torn = 0, backwards = 0;
+    uint32_t iteration = 0;
+    while (true) {
+        int done = __atomic_load_n(&producer_done, __ATOMIC_ACQUIRE);
+        uint32_t tail = ring.tail;
+        sensor_sample_t s;
+        bool latest = (iteration++ & 3) != 0;
+        bool got = latest ? sample_ring_pop_latest(&ring, &s) : sample_ring_pop(&ring, &s);
+        if (got) {
+            reads++;
+            if (latest) {
+                latest_reads++;
+                skipped += ring.tail - tail - 1; // Pendentes descartadas junto
+            }
+            if (!sample_intact(&s) && !torn++)
+                printf("  amostra %u rasgada\n", s.seq);
+            if (s.seq <= last_seq && !backwards++)
+                printf("  seq %u depois de %u\n", s.seq, last_seq);
+            last_seq = s.seq;
+        } else if (done) {
+            break;
+        }
+        if (!(iteration & 63))
+            sched_yield(); // Com um núcleo só, dá vez ao produtor no meio da fila
+    }
+    pthread_join(thread, NULL);
+
+    printf("%u amostras: %u lidas (%u por pop_latest), %u descartadas pelo pop_latest, %u recusas com a fila cheia\n",
+           total, reads, latest_reads, skipped, refused);
+    CHECK(torn == 0, "%u amostras rasgadas", torn);
+    CHECK(backwards == 0, "%u amostras fora de ordem ou repetidas", backwards);
+    CHECK(reads + skipped == total, "contas não fecham: %u lidas + %u descartadas de %u", reads, skipped, total);
+    CHECK(ring.dropped == refused, "dropped %u com %u recusas", ring.dropped, refused);
+    CHECK(last_seq == total, "última amostra lida %u de %u", last_seq, total);
+
+    return check_exit("sample_ring_stress");
+}
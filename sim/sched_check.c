@@ -0,0 +1,199 @@
+// Verificação no host do escalonador (lib/sched.h) sobre o relógio virtual.
+// As tarefas são stubs que avançam o relógio pelo custo configurado, então
+// início, fim e atraso de cada execução são conhecidos.
+//
+// Confere que:
+//   - com várias tarefas prontas no mesmo instante, roda primeiro a de prazo
+//     absoluto mais cedo (EDF), e o atraso de cada uma é o custo das que
+//     rodaram antes;
+//   - uma tarefa esporádica (period_us = 0) só roda depois de sched_trigger(),
+//     uma vez por disparo, com o atraso contado a partir do disparo;
+//   - uma execução que passa do prazo conta um estouro, e uma que deixa a
+//     tarefa mais de um período atrasada pula as liberações vencidas e
+//     mantém a fase;
+//   - sched_reset_stats() zera as estatísticas sem tirar as tarefas da fila.
+//
+// Uso: colorlux_sched_check
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "sched.h"
+#include "check.h"
+
+typedef struct {
+    char id;
+    uint32_t cost_us;       // Custo de cada execução
+    uint32_t first_cost_us; // Custo só da primeira execução (0 = cost_us)
+    uint32_t calls;
+} stub_t;
+
+static char order[16];
+static uint order_len;
+
+static void stub_fn(void *arg) {
+    stub_t *st = arg;
+    uint32_t cost = st->calls == 0 && st->first_cost_us ? st->first_cost_us : st->cost_us;
+    st->calls++;
+    if (order_len < sizeof(order) - 1)
+        order[order_len++] = st->id;
+    sleep_us(cost);
+}
+
+static void clear_order(void) {
+    order_len = 0;
+    memset(order, 0, sizeof(order));
+}
+
+static sched_task_t task(const char *name, stub_t *st, uint32_t period_us, uint32_t deadline_us) {
+    sched_task_t t = {
+        .name = name,
+        .fn = stub_fn,
+        .arg = st,
+        .period_us = period_us,
+        .deadline_us = deadline_us,
+    };
+    return t;
+}
+
+static sched_t sched;
+
+static void check_edf(void) {
+    stub_t a = {'a', 10}, b = {'b', 10}, c = {'c', 10};
+    sched_task_t ta = task("a", &a, 1000, 500);
+    sched_task_t tb = task("b", &b, 1000, 100);
+    sched_task_t tc = task("c", &c, 1000, 300);
+    sched_init(&sched);
+    sched_add(&sched, &ta);
+    sched_add(&sched, &tb);
+    sched_add(&sched, &tc);
+    uint64_t t0 = sim_now_us();
+
+    clear_order();
+    uint64_t next = sched_run_pending(&sched);
+    CHECK(!strcmp(order, "bca"), "ordem \"%s\", esperado \"bca\"", order);
+    CHECK(next == t0 + 1000, "próxima liberação em +%llu us, esperado +1000",
+          (unsigned long long)(next - t0));
+    CHECK(tb.late_max_us == 0 && tc.late_max_us == 10 && ta.late_max_us == 20,
+          "atrasos b=%u c=%u a=%u, esperado 0/10/20", tb.late_max_us, tc.late_max_us, ta.late_max_us);
+    CHECK(ta.overruns + tb.overruns + tc.overruns == 0, "estouros sem passar do prazo");
+
+    // Nada pronto antes da próxima liberação
+    sim_advance_to(next - 1);
+    clear_order();
+    sched_run_pending(&sched);
+    CHECK(order_len == 0, "\"%s\" rodou antes da liberação", order);
+
+    // Na liberação seguinte as três ficam prontas juntas de novo
+    sim_advance_to(next);
+    clear_order();
+    sched_run_pending(&sched);
+    CHECK(!strcmp(order, "bca"), "segunda rodada \"%s\", esperado \"bca\"", order);
+    CHECK(ta.runs == 2 && tb.runs == 2 && tc.runs == 2, "execuções a=%u b=%u c=%u, esperado 2",
+          ta.runs, tb.runs, tc.runs);
+}
+
+static void check_sporadic(void) {
+    stub_t s = {'s', 5};
+    stub_t p = {'p', 5};
+    sched_task_t ts = task("s", &s, 0, 200);
+    sched_task_t tp = task("p", &p, 1000, 900);
+    sched_init(&sched);
+    sched_add(&sched, &ts);
+    sched_add(&sched, &tp);
+
+    for (int i = 0; i < 3; i++) {
+        sched_run_pending(&sched);
+        sim_advance_to(sim_now_us() + 1000);
+    }
+    sched_run_pending(&sched);
+    CHECK(s.calls == 0, "esporádica rodou %u vezes sem disparo", s.calls);
+    CHECK(!sched_has_pending(&sched), "esporádica pendente sem disparo");
+
+    sched_trigger(&ts);
+    CHECK(sched_has_pending(&sched), "disparo não ficou pendente");
+    sim_advance_to(sim_now_us() + 50);
+    sched_run_pending(&sched);
+    CHECK(s.calls == 1 && ts.runs == 1, "esporádica rodou %u vezes após um disparo", s.calls);
+    CHECK(ts.late_max_us == 50, "atraso %u us após o disparo, esperado 50", ts.late_max_us);
+    CHECK(!sched_has_pending(&sched), "disparo continuou pendente");
+
+    sim_advance_to(sim_now_us() + 1000);
+    sched_run_pending(&sched);
+    CHECK(s.calls == 1, "esporádica rodou de novo sem disparo (%u)", s.calls);
+
+    sched_trigger(&ts);
+    sched_run_pending(&sched);
+    CHECK(s.calls == 2, "%u execuções após o segundo disparo, esperado 2", s.calls);
+}
+
+static void check_overrun(void) {
+    // Primeira execução de 2500 us num período de 1000 us e prazo de 800 us:
+    // estoura, a liberação de +1000 é pulada e a de +2000 roda com 500 us de
+    // atraso, dentro do prazo
+    stub_t o = {'o', 10, 2500};
+    sched_task_t to = task("o", &o, 1000, 800);
+    sched_init(&sched);
+    sched_add(&sched, &to);
+    uint64_t t0 = sim_now_us();
+
+    uint64_t next = sched_run_pending(&sched);
+    CHECK(to.runs == 2, "%u execuções, esperado 2", to.runs);
+    CHECK(to.overruns == 1, "%u estouros, esperado 1", to.overruns);
+    CHECK(to.skipped == 1, "%u liberações puladas, esperado 1", to.skipped);
+    CHECK(to.late_max_us == 500, "atraso máximo %u us, esperado 500", to.late_max_us);
+    CHECK(to.late_sum_us == 500, "soma dos atrasos %llu us, esperado 500",
+          (unsigned long long)to.late_sum_us);
+    CHECK(to.exec_max_us == 2500 && to.exec_sum_us == 2510, "exec máx %u soma %llu, esperado 2500/2510",
+          to.exec_max_us, (unsigned long long)to.exec_sum_us);
+    CHECK(next == t0 + 3000, "próxima liberação em +%llu us, esperado +3000 (fase mantida)",
+          (unsigned long long)(next - t0));
+
+    // Atraso menor que um período não pula nada, só atrasa
+    sim_advance_to(next + 700);
+    sched_run_pending(&sched);
+    CHECK(to.runs == 3 && to.skipped == 1, "execuções %u puladas %u, esperado 3/1", to.runs, to.skipped);
+    CHECK(to.overruns == 1, "%u estouros com 710 us após a liberação, esperado 1", to.overruns);
+    CHECK(to.late_max_us == 700, "atraso máximo %u us, esperado 700", to.late_max_us);
+
+    // O prazo conta da liberação até o fim: 790 us de atraso + 10 us de
+    // execução = 800 fica no limite e não estoura; com 791 estoura
+    sim_advance_to(next + 1000 + 790);
+    sched_run_pending(&sched);
+    CHECK(to.overruns == 1, "estouro no limite do prazo");
+    sim_advance_to(next + 2000 + 791);
+    sched_run_pending(&sched);
+    CHECK(to.overruns == 2, "%u estouros, esperado 2", to.overruns);
+}
+
+static void check_reset(void) {
+    stub_t r = {'r', 300};
+    sched_task_t tr = task("r", &r, 1000, 100);
+    sched_init(&sched);
+    sched_add(&sched, &tr);
+    sim_advance_to(sim_now_us() + 40);
+    sched_run_pending(&sched);
+    CHECK(tr.runs == 1 && tr.overruns == 1, "%u execuções e %u estouros antes do reset, esperado 1/1",
+          tr.runs, tr.overruns);
+
+    sim_advance_to(sim_now_us() + 1000);
+    sched_run_pending(&sched);
+    sched_reset_stats(&sched);
+    CHECK(tr.runs == 0 && tr.overruns == 0 && tr.skipped == 0, "contadores não zerados");
+    CHECK(tr.late_max_us == 0 && tr.late_sum_us == 0 && tr.exec_max_us == 0 && tr.exec_sum_us == 0,
+          "atrasos e tempos de execução não zerados");
+
+    // A tarefa continua na fila, com a mesma fase
+    sim_advance_to(tr.next_release);
+    sched_run_pending(&sched);
+    CHECK(tr.runs == 1 && tr.exec_max_us == 300 && tr.late_max_us == 0,
+          "após o reset: %u execuções, exec %u atraso %u", tr.runs, tr.exec_max_us, tr.late_max_us);
+}
+
+int main(void) {
+    check_edf();
+    check_sporadic();
+    check_overrun();
+    check_reset();
+    return check_exit("sched");
+}
@@ -0,0 +1,128 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+// Núcleo da simulação no host: relógio virtual, fila de eventos, barramentos
+// I2C contabilizados e modelos dos dispositivos da placa.
+//
+// O tempo só anda quando o firmware dorme ou espera (sleep_*, time_reached em
+// laço com tight_loop_contents, __wfe). Eventos agendados (fim de transação
+// I2C, fim de DMA) rodam quando o relógio passa pelo seu instante, como se
+// fossem interrupções.
+
+#define SIM_MAX_EVENTS 16
+#define SIM_MAX_I2C_DEVICES 8
+#define SIM_PIO_WORD_US 30 // 24 bits a 800 kHz; por máquina de estado, ver hardware/pio.h
+#define SIM_PIO_FRAME_WORDS 1024
+
+// Estatísticas por barramento I2C
+typedef struct {
+    uint32_t transactions;
+    uint32_t bytes;       // Bytes de dados, sem o byte de endereço
+    uint32_t nacks;
+    uint64_t busy_us;     // Tempo de barramento ocupado
+} sim_bus_stats_t;
+
+extern sim_bus_stats_t sim_i2c_stats[2];
+
+// Controlador I2C em nível de registrador (lib/i2c_async.c): o que o driver
+// fez com ele. Os bytes e o tempo de barramento entram em sim_i2c_stats.
+typedef struct {
+    uint32_t irqs;            // Entradas no handler
+    uint32_t irq_storms;      // Handler que voltou sem tratar a causa
+    uint32_t tar_writes;      // Trocas de IC_TAR com o controlador desabilitado
+    uint32_t tar_ignored;     // Escritas em IC_TAR com ele habilitado
+    uint32_t restarts;        // RESTART no barramento (flag ou troca de direção)
+    uint32_t stops;
+    uint32_t aborts;          // TX_ABRT por NACK de endereço
+    uint32_t rx_max;          // Maior ocupação da FIFO de recepção
+    uint32_t rx_overflows;    // Leituras sem espaço na FIFO (byte perdido)
+    uint32_t tx_overflows;    // Comandos escritos com a FIFO de transmissão cheia
+    uint32_t tx_dropped;      // Comandos escritos desabilitado ou após abort
+} sim_i2c_hw_stats_t;
+
+extern sim_i2c_hw_stats_t sim_i2c_hw_stats[2];
+
+// Estatísticas do PIO (todas as máquinas de estado)
+typedef struct {
+    uint32_t words;
+    uint32_t transfers;
+} sim_pio_stats_t;
+
+extern sim_pio_stats_t sim_pio_stats;
+
+// Relógio e eventos
+typedef void (*sim_event_fn_t)(void *arg);
+
+uint64_t sim_now_us(void);
+void sim_schedule(uint64_t at_us, sim_event_fn_t fn, void *arg);
+void sim_advance_to(uint64_t t_us);
+bool sim_run_next_event(void);
+
+// Núcleo em execução (get_core_num): quem roda as tarefas do núcleo 1 marca 1
+extern uint sim_core_num;
+
+// Barramento I2C: duração de uma transação (START, endereço, dados, RESTART
+// opcional, STOP) a 9 bits por byte na taxa configurada em i2c_init
+uint32_t sim_i2c_duration_us(uint bus, size_t tx_len, size_t rx_len);
+
+// Entrega uma transação ao dispositivo no endereço e contabiliza o tráfego.
+// Retorna false em NACK (nenhum dispositivo no endereço).
+bool sim_i2c_transfer(uint bus, uint8_t addr, const uint8_t *tx, size_t tx_len,
+                      uint8_t *rx, size_t rx_len);
+
+// Modelos de dispositivo. Uma escrita chega inteira ao fim do trecho (no
+// RESTART ou STOP); a leitura pelo controlador vem byte a byte, então start
+// (opcional, a cada START/RESTART endereçado ao dispositivo) marca o começo
+// de um trecho para modelos que dependem da posição do byte.
+typedef struct {
+    uint bus;
+    uint8_t addr;
+    void (*write)(void *dev, const uint8_t *data, size_t len);
+    void (*read)(void *dev, uint8_t *data, size_t len);
+    void *dev;
+    void (*start)(void *dev);
+} sim_i2c_device_t;
+
+void sim_i2c_attach(const sim_i2c_device_t *device);
+void sim_devices_init(void);
+
+// Cena vista pelos sensores. Contagens RGBC são as da exposição de
+// referência do GY-33 (ganho 1x, 11 ciclos) e escalam com a exposição atual.
+typedef struct {
+    uint32_t lux;
+    uint16_t r, g, b, c;
+} sim_scene_t;
+
+void sim_set_scene(const sim_scene_t *scene);
+
+// Ruído nas conversões dos sensores: desvio de até percent% (distribuição
+// triangular) e, a cada ~64 conversões, um pico isolado de 2x. 0 desliga.
+// Sequência pseudoaleatória fixa, então as execuções são reprodutíveis.
+void sim_set_noise(uint8_t percent);
+
+// Flash (hardware/flash.h): contadores, imagem em arquivo para simular boots
+// a quente entre execuções e corte de energia no meio de uma programação
+typedef struct {
+    uint32_t erases;      // Setores apagados
+    uint32_t programs;    // Páginas programadas
+} sim_flash_stats_t;
+
+extern sim_flash_stats_t sim_flash_stats;
+extern int32_t sim_flash_program_limit; // >= 0: a próxima programação grava só esses bytes
+
+void sim_flash_reset(void);             // Tudo apagado (0xFF)
+bool sim_flash_load(const char *path);  // false se o arquivo não existe
+bool sim_flash_save(const char *path);
+
+// Estado observável das saídas
+extern uint16_t sim_pwm_level[30];
+extern uint32_t sim_pio_last_word[2][4];
+extern uint32_t sim_pio_frame[2][4][SIM_PIO_FRAME_WORDS]; // Palavras da última transferência de DMA
+extern uint32_t sim_pio_frame_len[2][4];                  // (até SIM_PIO_FRAME_WORDS guardadas)
+uint32_t sim_ssd1306_frames(void);                 // Transações de dados
+const uint8_t *sim_ssd1306_gddram(void);           // 128x64, endereçamento em páginas
+
+#endif // SIM_H
@@ -0,0 +1,305 @@
+#include "sim.h"
+#include <string.h>
+
+// Modelos dos dispositivos da placa no nível de registradores, o suficiente
+// para que o firmware veja as mesmas respostas e os mesmos tempos que no
+// hardware. Todos são atualizados preguiçosamente a cada acesso pelo tempo
+// virtual decorrido.
+
+static sim_scene_t scene = {200, 300, 400, 250, 1000};
+
+void sim_set_scene(const sim_scene_t *s) {
+    scene = *s;
+}
+
+static uint8_t noise_percent;
+static uint32_t noise_state = 0x12345678;
+
+void sim_set_noise(uint8_t percent) {
+    noise_percent = percent;
+}
+
+static uint32_t noise_next(void) {
+    noise_state = noise_state * 1664525u + 1013904223u;
+    return noise_state >> 8;
+}
+
+static uint32_t sim_noisy(uint32_t value) {
+    if (!noise_percent)
+        return value;
+    if ((noise_next() & 63) == 0)
+        return value * 2; // Pico isolado (reflexo, interferência)
+    // Soma de duas uniformes em [-256, 256): triangular em [-512, 512)
+    int32_t n = (int32_t)(noise_next() & 511) + (int32_t)(noise_next() & 511) - 512;
+    int64_t v = (int64_t)value + (int64_t)value * noise_percent * n / (100 * 512);
+    return v < 0 ? 0 : (uint32_t)v;
+}
+
+// ---------------------------------------------------------------------------
+// SSD1306 (i2c1, 0x3C): parser de comandos e GDDRAM 128x64
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint8_t gddram[128 * 8]; // [coluna * 8 + página]
+    uint8_t mode;            // 0 horizontal, 1 vertical, 2 página
+    uint8_t col_start, col_end, col;
+    uint8_t page_start, page_end, page;
+    uint8_t cmd[3];          // Comando em montagem (pode cruzar transações)
+    uint8_t cmd_len, cmd_need;
+    uint32_t data_transactions;
+} sim_ssd1306_t;
+
+static sim_ssd1306_t ssd1306;
+
+static uint8_t ssd1306_args(uint8_t cmd) {
+    switch (cmd) {
+    case 0x21: case 0x22:
+        return 2;
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static void ssd1306_exec(sim_ssd1306_t *d) {
+    switch (d->cmd[0]) {
+    case 0x20:
+        d->mode = d->cmd[1] & 3;
+        break;
+    case 0x21:
+        d->col_start = d->col = d->cmd[1] & 0x7F;
+        d->col_end = d->cmd[2] & 0x7F;
+        break;
+    case 0x22:
+        d->page_start = d->page = d->cmd[1] & 7;
+        d->page_end = d->cmd[2] & 7;
+        break;
+    }
+}
+
+static void ssd1306_command_byte(sim_ssd1306_t *d, uint8_t b) {
+    if (d->cmd_len == 0) d->cmd_need = ssd1306_args(b);
+    d->cmd[d->cmd_len++] = b;
+    if (d->cmd_len > d->cmd_need) {
+        ssd1306_exec(d);
+        d->cmd_len = 0;
+    }
+}
+
+static void ssd1306_data_byte(sim_ssd1306_t *d, uint8_t b) {
+    d->gddram[d->col * 8 + d->page] = b;
+    if (d->mode == 1) {
+        if (d->page++ == d->page_end) {
+            d->page = d->page_start;
+            d->col = (d->col == d->col_end) ? d->col_start : d->col + 1;
+        }
+    } else {
+        if (d->col++ == d->col_end) {
+            d->col = d->col_start;
+            if (d->mode == 0) d->page = (d->page == d->page_end) ? d->page_start : d->page + 1;
+        }
+    }
+}
+
+static void ssd1306_write(void *dev, const uint8_t *data, size_t len) {
+    sim_ssd1306_t *d = dev;
+    bool counted = false;
+    size_t i = 0;
+    while (i < len) {
+        uint8_t control = data[i++];
+        bool single = control & 0x80; // Co: só um byte segue este controle
+        bool is_data = control & 0x40;
+        size_t end = single ? (i < len ? i + 1 : i) : len;
+        if (is_data && !counted && end > i) {
+            d->data_transactions++;
+            counted = true;
+        }
+        for (; i < end; i++) {
+            if (is_data) ssd1306_data_byte(d, data[i]);
+            else ssd1306_command_byte(d, data[i]);
+        }
+    }
+}
+
+static void ssd1306_read(void *dev, uint8_t *data, size_t len) {
+    (void)dev;
+    memset(data, 0, len);
+}
+
+uint32_t sim_ssd1306_frames(void) {
+    return ssd1306.data_transactions;
+}
+
+const uint8_t *sim_ssd1306_gddram(void) {
+    return ssd1306.gddram;
+}
+
+// ---------------------------------------------------------------------------
+// BH1750 (i2c0, 0x23): modo contínuo em alta resolução e medição única em
+// baixa resolução (depois dela o sensor desliga)
+// ---------------------------------------------------------------------------
+
+#define SIM_BH1750_CONV_US 120000 // Tempo típico de conversão
+#define SIM_BH1750_LRES_US 16000  // Típico da medição em baixa resolução
+
+typedef struct {
+    bool powered;
+    bool continuous;
+    uint64_t next_conversion;
+    uint64_t one_time_at;         // 0: nenhuma medição única em andamento
+    uint16_t data;
+    uint32_t read_index;          // Byte do trecho de leitura em andamento
+} sim_bh1750_t;
+
+static sim_bh1750_t bh1750;
+
+static void bh1750_update(sim_bh1750_t *d) {
+    uint64_t now = sim_now_us();
+    while (d->continuous && now >= d->next_conversion) {
+        uint32_t raw = sim_noisy(scene.lux * 6 / 5);
+        d->data = raw > 0xFFFF ? 0xFFFF : (uint16_t)raw;
+        d->next_conversion += SIM_BH1750_CONV_US;
+    }
+    if (d->one_time_at && now >= d->one_time_at) {
+        uint32_t raw = sim_noisy(scene.lux * 6 / 5) & ~3u; // Degraus de 4 lx, aproximados
+        d->data = raw > 0xFFFF ? 0xFFFF : (uint16_t)raw;
+        d->one_time_at = 0;
+        d->powered = false;
+    }
+}
+
+static void bh1750_write(void *dev, const uint8_t *data, size_t len) {
+    sim_bh1750_t *d = dev;
+    bh1750_update(d);
+    for (size_t i = 0; i < len; i++) {
+        switch (data[i]) {
+        case 0x00: d->powered = false; d->continuous = false; break;
+        case 0x01: d->powered = true; break;
+        case 0x10:
+            if (d->powered) {
+                d->continuous = true;
+                d->next_conversion = sim_now_us() + SIM_BH1750_CONV_US;
+            }
+            break;
+        case 0x23:
+            if (d->powered) {
+                d->continuous = false;
+                d->one_time_at = sim_now_us() + SIM_BH1750_LRES_US;
+            }
+            break;
+        }
+    }
+}
+
+static void bh1750_start(void *dev) {
+    sim_bh1750_t *d = dev;
+    d->read_index = 0;
+}
+
+static void bh1750_read(void *dev, uint8_t *data, size_t len) {
+    sim_bh1750_t *d = dev;
+    bh1750_update(d);
+    for (size_t i = 0; i < len; i++, d->read_index++)
+        data[i] = (d->read_index == 0) ? d->data >> 8 : (d->read_index == 1) ? d->data & 0xFF : 0xFF;
+}
+
+// ---------------------------------------------------------------------------
+// TCS34725 / GY-33 (i2c0, 0x29)
+// ---------------------------------------------------------------------------
+
+#define SIM_TCS_CYCLE_US 2400
+#define SIM_TCS_REF_SENSITIVITY 11 // Ganho 1x, 11 ciclos
+
+typedef struct {
+    uint8_t regs[0x20];
+    uint8_t addr;          // Registrador apontado pelo último comando
+    bool auto_inc;
+    uint64_t cycle_end;    // Fim da integração em andamento
+    uint8_t cycle_atime;   // Configuração capturada no início da integração
+    uint8_t cycle_gain;
+} sim_tcs34725_t;
+
+static sim_tcs34725_t tcs;
+
+static const uint8_t tcs_gain_mult[4] = {1, 4, 16, 60};
+
+static void tcs_start_cycle(sim_tcs34725_t *d, uint64_t start) {
+    d->cycle_atime = d->regs[0x01];
+    d->cycle_gain = d->regs[0x0F] & 3;
+    d->cycle_end = start + (uint64_t)(256 - d->cycle_atime) * SIM_TCS_CYCLE_US;
+}
+
+static uint16_t tcs_counts(uint16_t ref, uint32_t cycles, uint32_t gain) {
+    uint32_t full_scale = cycles >= 64 ? 0xFFFF : cycles * 1024;
+    uint32_t counts = sim_noisy((uint32_t)((uint64_t)ref * gain * cycles / SIM_TCS_REF_SENSITIVITY));
+    return counts > full_scale ? full_scale : (uint16_t)counts;
+}
+
+static void tcs_update(sim_tcs34725_t *d) {
+    uint64_t now = sim_now_us();
+    bool running = (d->regs[0x00] & 0x03) == 0x03; // PON + AEN
+    while (running && now >= d->cycle_end) {
+        uint32_t cycles = 256 - d->cycle_atime;
+        uint32_t gain = tcs_gain_mult[d->cycle_gain];
+        const uint16_t ch[4] = {
+            tcs_counts(scene.c, cycles, gain), tcs_counts(scene.r, cycles, gain),
+            tcs_counts(scene.g, cycles, gain), tcs_counts(scene.b, cycles, gain),
+        };
+        for (int i = 0; i < 4; i++) {
+            d->regs[0x14 + 2 * i] = ch[i] & 0xFF;
+            d->regs[0x15 + 2 * i] = ch[i] >> 8;
+        }
+        d->regs[0x13] |= 0x01;                      // AVALID
+        if (d->regs[0x00] & 0x10) d->regs[0x13] |= 0x10; // AINT (PERS = 0)
+        tcs_start_cycle(d, d->cycle_end);
+    }
+}
+
+static void tcs_write(void *dev, const uint8_t *data, size_t len) {
+    sim_tcs34725_t *d = dev;
+    tcs_update(d);
+    if (len == 0 || !(data[0] & 0x80)) return;
+
+    uint8_t type = (data[0] >> 5) & 3;
+    if (type == 3) {
+        if ((data[0] & 0x1F) == 0x06) d->regs[0x13] &= ~0x10; // Limpa AINT
+        return;
+    }
+    d->addr = data[0] & 0x1F;
+    d->auto_inc = (type == 1);
+
+    for (size_t i = 1; i < len; i++) {
+        uint8_t reg = d->addr;
+        bool was_running = (d->regs[0x00] & 0x03) == 0x03;
+        d->regs[reg] = data[i];
+        if (reg == 0x00 && !was_running && (data[i] & 0x03) == 0x03) {
+            tcs_start_cycle(d, sim_now_us() + SIM_TCS_CYCLE_US); // Espera de inicialização
+        }
+        if (d->auto_inc) d->addr = (d->addr + 1) & 0x1F;
+    }
+}
+
+static void tcs_read(void *dev, uint8_t *data, size_t len) {
+    sim_tcs34725_t *d = dev;
+    tcs_update(d);
+    for (size_t i = 0; i < len; i++) {
+        data[i] = d->regs[d->addr];
+        if (d->auto_inc) d->addr = (d->addr + 1) & 0x1F;
+    }
+}
+
+void sim_devices_init(void) {
+    memset(&ssd1306, 0, sizeof(ssd1306));
+    ssd1306.col_end = 127;
+    ssd1306.page_end = 7;
+    memset(&bh1750, 0, sizeof(bh1750));
+    memset(&tcs, 0, sizeof(tcs));
+    tcs.regs[0x01] = 0xFF;
+    tcs.regs[0x12] = 0x44; // ID do TCS34725
+
+    sim_i2c_attach(&(sim_i2c_device_t){1, 0x3C, ssd1306_write, ssd1306_read, &ssd1306});
+    sim_i2c_attach(&(sim_i2c_device_t){0, 0x23, bh1750_write, bh1750_read, &bh1750, bh1750_start});
+    sim_i2c_attach(&(sim_i2c_device_t){0, 0x29, tcs_write, tcs_read, &tcs});
+}
@@ -0,0 +1,1109 @@
+#define SIM_I2C_HW_IMPL // Acesso direto aos registradores de hardware/structs/i2c.h
+#include "sim.h"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "hardware/pwm.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include "pico/multicore.h"
+#include "pico/bootrom.h"
+#include "tusb.h"
+#include "pico/stdio_usb.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// Relógio virtual e eventos
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint64_t at;
+    sim_event_fn_t fn;
+    void *arg;
+    bool active;
+} sim_event_t;
+
+static uint64_t now_us;
+static sim_event_t events[SIM_MAX_EVENTS];
+static bool in_event; // Um evento ("interrupção") não pode esperar por outro
+
+uint64_t sim_now_us(void) {
+    return now_us;
+}
+
+void sim_schedule(uint64_t at_us, sim_event_fn_t fn, void *arg) {
+    for (int i = 0; i < SIM_MAX_EVENTS; i++) {
+        if (!events[i].active) {
+            events[i] = (sim_event_t){at_us, fn, arg, true};
+            return;
+        }
+    }
+    fprintf(stderr, "sim: fila de eventos cheia\n");
+    abort();
+}
+
+static sim_event_t *next_event(void) {
+    sim_event_t *next = NULL;
+    for (int i = 0; i < SIM_MAX_EVENTS; i++) {
+        if (events[i].active && (!next || events[i].at < next->at)) next = &events[i];
+    }
+    return next;
+}
+
+static void run_event(sim_event_t *ev) {
+    if (ev->at > now_us) now_us = ev->at;
+    ev->active = false;
+    in_event = true;
+    ev->fn(ev->arg);
+    in_event = false;
+}
+
+void sim_advance_to(uint64_t t_us) {
+    if (!in_event) {
+        sim_event_t *ev;
+        while ((ev = next_event()) && ev->at <= t_us) run_event(ev);
+    }
+    if (t_us > now_us) now_us = t_us;
+}
+
+bool sim_run_next_event(void) {
+    sim_event_t *ev = in_event ? NULL : next_event();
+    if (!ev) return false;
+    run_event(ev);
+    return true;
+}
+
+absolute_time_t get_absolute_time(void) {
+    return now_us;
+}
+
+void sleep_until(absolute_time_t t) {
+    sim_advance_to(t);
+}
+
+void sleep_us(uint64_t us) {
+    sim_advance_to(now_us + us);
+}
+
+void sleep_ms(uint32_t ms) {
+    sim_advance_to(now_us + (uint64_t)ms * 1000);
+}
+
+// Espera ativa: salta direto para o próximo evento, ou anda 1 us se não há
+void tight_loop_contents(void) {
+    if (!sim_run_next_event()) now_us++;
+}
+
+// WFE até um evento (transação I2C, DMA...) ou até o alarme do prazo
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp) {
+    sim_event_t *ev = in_event ? NULL : next_event();
+    if (ev && ev->at < timeout_timestamp) {
+        run_event(ev);
+        return false;
+    }
+    if (now_us < timeout_timestamp) now_us = timeout_timestamp;
+    return true;
+}
+
+// Timer periódico: delay_us < 0 conta entre inícios de chamada, > 0 entre o
+// fim de uma e o início da seguinte (como no SDK)
+struct alarm_pool {
+    uint max_timers;
+};
+
+static alarm_pool_t sim_alarm_pool;
+
+static void repeating_timer_fire(void *arg) {
+    repeating_timer_t *rt = arg;
+    if (!rt->alarm_id) return;
+    uint64_t start = now_us;
+    if (!rt->callback(rt)) {
+        rt->alarm_id = 0;
+        return;
+    }
+    if (rt->alarm_id)
+        sim_schedule(rt->delay_us < 0 ? start - rt->delay_us : now_us + rt->delay_us, repeating_timer_fire, rt);
+}
+
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers) {
+    sim_alarm_pool.max_timers = max_timers;
+    return &sim_alarm_pool;
+}
+
+bool alarm_pool_add_repeating_timer_us(alarm_pool_t *pool, int64_t delay_us, repeating_timer_callback_t callback,
+                                       void *user_data, repeating_timer_t *out) {
+    if (!delay_us) delay_us = 1;
+    *out = (repeating_timer_t){delay_us, pool, 1, callback, user_data};
+    sim_schedule(now_us + (uint64_t)(delay_us < 0 ? -delay_us : delay_us), repeating_timer_fire, out);
+    return true;
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    bool active = timer->alarm_id != 0;
+    timer->alarm_id = 0; // O evento já agendado vê o cancelamento e não reagenda
+    return active;
+}
+
+bool stdio_init_all(void) {
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    sleep_us(timeout_us);
+    return PICO_ERROR_TIMEOUT;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    (void)clk_index;
+    return 125000000;
+}
+
+uint sim_core_num;
+
+uint get_core_num(void) {
+    return sim_core_num;
+}
+
+void multicore_launch_core1(void (*entry)(void)) {
+    (void)entry; // sim_main.c intercala os dois núcleos explicitamente
+}
+
+void reset_usb_boot(uint32_t gpio_activity_pin_mask, uint32_t disable_interface_mask) {
+    (void)gpio_activity_pin_mask;
+    (void)disable_interface_mask;
+    exit(0);
+}
+
+// ---------------------------------------------------------------------------
+// GPIO e PWM
+// ---------------------------------------------------------------------------
+
+#define SIM_NUM_GPIOS 30
+
+static bool gpio_out[SIM_NUM_GPIOS];
+uint16_t sim_pwm_level[SIM_NUM_GPIOS];
+
+void gpio_init(uint gpio) { (void)gpio; }
+void gpio_set_dir(uint gpio, bool out) { (void)gpio; (void)out; }
+void gpio_pull_up(uint gpio) { (void)gpio; }
+void gpio_set_function(uint gpio, enum gpio_function fn) { (void)gpio; (void)fn; }
+void gpio_put(uint gpio, bool value) { if (gpio < SIM_NUM_GPIOS) gpio_out[gpio] = value; }
+bool gpio_get(uint gpio) { return gpio < SIM_NUM_GPIOS ? gpio_out[gpio] : false; }
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback) {
+    (void)gpio; (void)event_mask; (void)enabled; (void)callback;
+}
+
+uint pwm_gpio_to_slice_num(uint gpio) { return (gpio >> 1) & 7u; }
+uint pwm_gpio_to_channel(uint gpio) { return gpio & 1u; }
+
+// Valores de reset: divisor 1 e TOP 0xffff
+static pwm_hw_t pwm_hw_inst = {.slice = {[0 ... NUM_PWM_SLICES - 1] = {.div = 1 << 4, .top = 0xffff}}};
+pwm_hw_t *const pwm_hw = &pwm_hw_inst;
+
+pwm_config pwm_get_default_config(void) {
+    pwm_config c = {0, 1 << 4, 0xffff};
+    return c;
+}
+
+void pwm_init(uint slice_num, pwm_config *c, bool start) {
+    (void)start;
+    pwm_hw->slice[slice_num].div = c->div;
+    pwm_hw->slice[slice_num].top = c->top;
+}
+
+void pwm_set_clkdiv(uint slice_num, float divider) { pwm_hw->slice[slice_num].div = (uint32_t)(divider * 16); }
+void pwm_set_wrap(uint slice_num, uint16_t wrap) { pwm_hw->slice[slice_num].top = wrap; }
+void pwm_set_enabled(uint slice_num, bool enabled) { (void)slice_num; (void)enabled; }
+
+// Novo CC de uma fatia: os níveis de todos os pinos ligados a ela
+static void sim_pwm_write_cc(uint slice_num, uint32_t cc) {
+    pwm_hw->slice[slice_num].cc = cc;
+    for (uint gpio = 0; gpio < SIM_NUM_GPIOS; gpio++) {
+        if (pwm_gpio_to_slice_num(gpio) == slice_num)
+            sim_pwm_level[gpio] = (uint16_t)(pwm_gpio_to_channel(gpio) ? cc >> 16 : cc);
+    }
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t level) {
+    if (gpio >= SIM_NUM_GPIOS) return;
+    uint slice_num = pwm_gpio_to_slice_num(gpio);
+    uint32_t cc = pwm_hw->slice[slice_num].cc;
+    if (pwm_gpio_to_channel(gpio))
+        cc = (cc & 0xffffu) | (uint32_t)level << 16;
+    else
+        cc = (cc & 0xffff0000u) | level;
+    sim_pwm_write_cc(slice_num, cc);
+}
+
+// Período da fatia a 125 MHz: (TOP + 1) * DIV contagens
+static uint64_t sim_pwm_period_us(uint slice_num) {
+    uint64_t us = ((uint64_t)pwm_hw->slice[slice_num].top + 1) * pwm_hw->slice[slice_num].div / (16 * 125);
+    return us ? us : 1;
+}
+
+// ---------------------------------------------------------------------------
+// PIO
+// ---------------------------------------------------------------------------
+
+pio_hw_t pio0_hw_inst = {.index = 0};
+pio_hw_t pio1_hw_inst = {.index = 1};
+
+sim_pio_stats_t sim_pio_stats;
+uint32_t sim_pio_last_word[2][4];
+uint32_t sim_pio_frame[2][4][SIM_PIO_FRAME_WORDS];
+uint32_t sim_pio_frame_len[2][4];
+static uint8_t pio_claimed_sm[2];
+static uint32_t pio_word_us[2][4] = {
+    {SIM_PIO_WORD_US, SIM_PIO_WORD_US, SIM_PIO_WORD_US, SIM_PIO_WORD_US},
+    {SIM_PIO_WORD_US, SIM_PIO_WORD_US, SIM_PIO_WORD_US, SIM_PIO_WORD_US},
+};
+
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    (void)pio; (void)program;
+    return 0;
+}
+
+void pio_remove_program(PIO pio, const pio_program_t *program, uint loaded_offset) {
+    (void)pio; (void)program; (void)loaded_offset;
+}
+
+void pio_sm_unclaim(PIO pio, uint sm) {
+    pio_claimed_sm[pio->index] &= (uint8_t)~(1u << sm);
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    for (uint sm = 0; sm < 4; sm++) {
+        if (!(pio_claimed_sm[pio->index] & (1u << sm))) {
+            pio_claimed_sm[pio->index] |= 1u << sm;
+            return (int)sm;
+        }
+    }
+    if (required) abort();
+    return -1;
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+    return pio->index * 8 + (is_tx ? 0 : 4) + sm;
+}
+
+void pio_gpio_init(PIO pio, uint pin) { (void)pio; (void)pin; }
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out) {
+    (void)pio; (void)sm; (void)pin_base; (void)pin_count; (void)is_out;
+}
+// shiftctrl guarda o limite de autopull e pinctrl o número de pinos de OUT
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config) {
+    (void)initial_pc;
+    uint32_t bits = config->shiftctrl ? config->shiftctrl : 32;
+    uint32_t slots = config->pinctrl ? bits / 8 : bits;
+    pio_word_us[pio->index][sm] = slots * 5 / 4;
+}
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) { (void)pio; (void)sm; (void)enabled; }
+
+void sm_config_set_set_pins(pio_sm_config *c, uint set_base, uint set_count) { (void)c; (void)set_base; (void)set_count; }
+void sm_config_set_out_pins(pio_sm_config *c, uint out_base, uint out_count) { (void)out_base; c->pinctrl = out_count; }
+void sm_config_set_sideset_pins(pio_sm_config *c, uint sideset_base) { (void)c; (void)sideset_base; }
+void sm_config_set_clkdiv(pio_sm_config *c, float div) { (void)c; (void)div; }
+void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join) { (void)c; (void)join; }
+void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold) {
+    (void)shift_right; (void)autopull;
+    c->shiftctrl = pull_threshold;
+}
+void sm_config_set_out_special(pio_sm_config *c, bool sticky, bool has_enable_pin, uint enable_pin_index) {
+    (void)c; (void)sticky; (void)has_enable_pin; (void)enable_pin_index;
+}
+void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap) { (void)c; (void)wrap_target; (void)wrap; }
+
+// Escrita direta na FIFO: a CPU bloqueia pelo tempo de uma palavra
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data) {
+    sim_pio_last_word[pio->index][sm] = data;
+    sim_pio_stats.words++;
+    sleep_us(pio_word_us[pio->index][sm]);
+}
+
+// ---------------------------------------------------------------------------
+// IRQ e DMA
+// ---------------------------------------------------------------------------
+
+#define SIM_MAX_SHARED_HANDLERS 4
+
+static irq_handler_t irq_handlers[NUM_IRQS][SIM_MAX_SHARED_HANDLERS];
+static bool irq_enabled[NUM_IRQS];
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    memset(irq_handlers[num], 0, sizeof(irq_handlers[num]));
+    irq_handlers[num][0] = handler;
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    (void)order_priority;
+    for (int i = 0; i < SIM_MAX_SHARED_HANDLERS; i++) {
+        if (!irq_handlers[num][i]) {
+            irq_handlers[num][i] = handler;
+            return;
+        }
+    }
+    abort();
+}
+
+static void i2c_ctrl_irq_enabled(uint bus);
+
+void irq_set_enabled(uint num, bool enabled) {
+    irq_enabled[num] = enabled;
+    // Interrupção por nível: o que ficou pendente com ela desligada dispara
+    if (enabled && (num == I2C0_IRQ || num == I2C1_IRQ)) i2c_ctrl_irq_enabled(num == I2C1_IRQ);
+}
+
+static void irq_raise(uint num) {
+    if (!irq_enabled[num]) return;
+    for (int i = 0; i < SIM_MAX_SHARED_HANDLERS; i++) {
+        if (irq_handlers[num][i]) irq_handlers[num][i]();
+    }
+}
+
+typedef struct {
+    bool claimed;
+    bool busy;
+    bool irq0_enabled;
+    bool irq0_status;
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint32_t transfer_count;        // Recarregado a cada disparo, como TRANS_COUNT
+    // Destino de PWM: um valor por período da fatia
+    int pwm_slice;
+    uint32_t pwm_index;
+    bool pwm_event_pending;
+} sim_dma_channel_t;
+
+static sim_dma_channel_t dma_channels[NUM_DMA_CHANNELS];
+static dma_hw_t dma_hw_inst;
+dma_hw_t *const dma_hw = &dma_hw_inst;
+
+int dma_claim_unused_channel(bool required) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        if (!dma_channels[ch].claimed) {
+            dma_channels[ch].claimed = true;
+            return (int)ch;
+        }
+    }
+    if (required) abort();
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    dma_channels[channel].claimed = false;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    dma_channel_config c = {DMA_SIZE_32, 0x3f, true, false, channel};
+    return c;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) { c->ctrl = size; }
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) { c->read_increment = incr; }
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) { c->write_increment = incr; }
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) { c->dreq = dreq; }
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to) { c->chain_to = chain_to; }
+
+static void dma_start(uint channel);
+
+static void dma_complete(void *arg) {
+    sim_dma_channel_t *ch = arg;
+    ch->busy = false;
+    if (ch->irq0_enabled) {
+        ch->irq0_status = true;
+        irq_raise(DMA_IRQ_0);
+    }
+    uint channel = (uint)(ch - dma_channels);
+    if (ch->config.chain_to != channel)
+        dma_start(ch->config.chain_to);
+}
+
+static void dma_pwm_step(void *arg) {
+    sim_dma_channel_t *ch = arg;
+    ch->pwm_event_pending = false;
+    if (!ch->busy) return; // Abortado
+
+    const volatile uint32_t *src = ch->read_addr;
+    uint32_t v = src[ch->config.read_increment ? ch->pwm_index : 0];
+    pwm_slice_hw_t *slice = &pwm_hw->slice[ch->pwm_slice];
+    if (ch->write_addr == &slice->cc)
+        sim_pwm_write_cc((uint)ch->pwm_slice, v);
+    else
+        slice->top = v;
+
+    if (++ch->pwm_index < ch->transfer_count) {
+        ch->pwm_event_pending = true;
+        sim_schedule(sim_now_us() + sim_pwm_period_us((uint)ch->pwm_slice), dma_pwm_step, ch);
+    } else {
+        dma_complete(ch);
+    }
+}
+
+// Memória -> FIFO TX de PIO: as palavras saem no ritmo do DREQ, e o canal
+// termina quando a última entra na FIFO.
+// Memória -> CC/TOP de PWM: um valor a cada wrap, o primeiro no próximo.
+// Memória -> al3_read_addr_trig de outro canal: redispara esse canal lendo
+// da tabela apontada (no host o ponteiro tem 64 bits e é lido inteiro).
+static void dma_start(uint channel) {
+    sim_dma_channel_t *ch = &dma_channels[channel];
+    const volatile uint32_t *src = ch->read_addr;
+    uint32_t transfer_count = ch->transfer_count;
+
+    for (uint n = 0; n < NUM_DMA_CHANNELS; n++) {
+        if (ch->write_addr == &dma_hw->ch[n].al3_read_addr_trig) {
+            dma_channels[n].read_addr = *(const volatile void *const volatile *)ch->read_addr;
+            ch->busy = true;
+            dma_complete(ch);
+            dma_start(n);
+            return;
+        }
+    }
+
+    for (uint s = 0; s < NUM_PWM_SLICES; s++) {
+        if (ch->write_addr == &pwm_hw->slice[s].cc || ch->write_addr == &pwm_hw->slice[s].top) {
+            if (ch->config.ctrl != DMA_SIZE_32 || ch->config.dreq != pwm_get_dreq(s)) break;
+            ch->pwm_slice = (int)s;
+            ch->pwm_index = 0;
+            ch->busy = transfer_count > 0;
+            if (ch->busy && !ch->pwm_event_pending) {
+                ch->pwm_event_pending = true;
+                sim_schedule(sim_now_us() + sim_pwm_period_us(s), dma_pwm_step, ch);
+            }
+            return;
+        }
+    }
+
+    PIO pio = NULL;
+    uint sm = 0;
+    for (uint i = 0; i < 4; i++) {
+        if (ch->write_addr == &pio0->txf[i]) { pio = pio0; sm = i; }
+        if (ch->write_addr == &pio1->txf[i]) { pio = pio1; sm = i; }
+    }
+    if (!pio || ch->config.ctrl != DMA_SIZE_32) {
+        fprintf(stderr, "sim: destino de DMA não modelado\n");
+        abort();
+    }
+
+    for (uint32_t i = 0; i < transfer_count; i++) {
+        sim_pio_last_word[pio->index][sm] = src[ch->config.read_increment ? i : 0];
+        if (i < SIM_PIO_FRAME_WORDS) sim_pio_frame[pio->index][sm][i] = sim_pio_last_word[pio->index][sm];
+    }
+    sim_pio_frame_len[pio->index][sm] = transfer_count;
+    sim_pio_stats.words += transfer_count;
+    sim_pio_stats.transfers++;
+
+    uint32_t paced = transfer_count > 8 ? transfer_count - 8 : 0; // FIFO TX com join
+    ch->busy = true;
+    sim_schedule(sim_now_us() + (uint64_t)paced * pio_word_us[pio->index][sm], dma_complete, ch);
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count) {
+    dma_channels[channel].read_addr = read_addr;
+    dma_channels[channel].transfer_count = transfer_count;
+    dma_start(channel);
+}
+
+void dma_channel_set_config(uint channel, const dma_channel_config *config, bool trigger) {
+    dma_channels[channel].config = *config;
+    if (trigger) dma_start(channel);
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    dma_channels[channel].config = *config;
+    dma_channels[channel].write_addr = write_addr;
+    dma_channels[channel].read_addr = read_addr;
+    dma_channels[channel].transfer_count = transfer_count;
+    if (trigger) dma_start(channel);
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return dma_channels[channel].busy;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) {
+    while (dma_channels[channel].busy) tight_loop_contents();
+}
+
+void dma_channel_abort(uint channel) {
+    dma_channels[channel].busy = false;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    dma_channels[channel].irq0_enabled = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    return dma_channels[channel].irq0_status;
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    dma_channels[channel].irq0_status = false;
+}
+
+// ---------------------------------------------------------------------------
+// I2C
+// ---------------------------------------------------------------------------
+
+i2c_inst_t i2c0_inst = {0, 100000};
+i2c_inst_t i2c1_inst = {1, 100000};
+
+sim_bus_stats_t sim_i2c_stats[2];
+sim_i2c_hw_stats_t sim_i2c_hw_stats[2];
+
+static sim_i2c_device_t i2c_devices[SIM_MAX_I2C_DEVICES];
+static uint num_i2c_devices;
+
+// Escrita com nostop=true fica pendente até a leitura (repeated start)
+static uint8_t pending_tx[2][64];
+static size_t pending_tx_len[2];
+
+void sim_i2c_attach(const sim_i2c_device_t *device) {
+    if (num_i2c_devices == SIM_MAX_I2C_DEVICES) abort();
+    i2c_devices[num_i2c_devices++] = *device;
+}
+
+static void i2c_ctrl_reset(uint bus);
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    i2c_ctrl_reset(i2c->index);
+    return baudrate;
+}
+
+uint32_t sim_i2c_duration_us(uint bus, size_t tx_len, size_t rx_len) {
+    uint32_t bits = 2; // START e STOP
+    if (tx_len) bits += 9 * (1 + (uint32_t)tx_len);
+    if (rx_len) bits += 9 * (1 + (uint32_t)rx_len) + (tx_len ? 1 : 0);
+    uint baud = bus ? i2c1_inst.baudrate : i2c0_inst.baudrate;
+    return (uint32_t)(((uint64_t)bits * 1000000 + baud - 1) / baud);
+}
+
+static sim_i2c_device_t *i2c_find_device(uint bus, uint8_t addr) {
+    for (uint i = 0; i < num_i2c_devices; i++) {
+        sim_i2c_device_t *d = &i2c_devices[i];
+        if (d->bus == bus && d->addr == addr) return d;
+    }
+    return NULL;
+}
+
+bool sim_i2c_transfer(uint bus, uint8_t addr, const uint8_t *tx, size_t tx_len,
+                      uint8_t *rx, size_t rx_len) {
+    sim_bus_stats_t *stats = &sim_i2c_stats[bus];
+    stats->transactions++;
+    stats->bytes += (uint32_t)(tx_len + rx_len);
+    stats->busy_us += sim_i2c_duration_us(bus, tx_len, rx_len);
+
+    sim_i2c_device_t *d = i2c_find_device(bus, addr);
+    if (!d) {
+        stats->nacks++;
+        return false;
+    }
+    if (tx_len) {
+        if (d->start) d->start(d->dev);
+        d->write(d->dev, tx, tx_len);
+    }
+    if (rx_len) {
+        if (d->start) d->start(d->dev);
+        d->read(d->dev, rx, rx_len);
+    }
+    return true;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    uint bus = i2c->index;
+    if (nostop) {
+        if (len > sizeof(pending_tx[bus])) abort();
+        memcpy(pending_tx[bus], src, len);
+        pending_tx_len[bus] = len;
+        return (int)len;
+    }
+    bool ack = sim_i2c_transfer(bus, addr, src, len, NULL, 0);
+    sleep_us(sim_i2c_duration_us(bus, len, 0));
+    return ack ? (int)len : PICO_ERROR_GENERIC;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)nostop;
+    uint bus = i2c->index;
+    size_t tx_len = pending_tx_len[bus];
+    pending_tx_len[bus] = 0;
+    bool ack = sim_i2c_transfer(bus, addr, pending_tx[bus], tx_len, dst, len);
+    sleep_us(sim_i2c_duration_us(bus, tx_len, len));
+    return ack ? (int)len : PICO_ERROR_GENERIC;
+}
+
+// ---------------------------------------------------------------------------
+// Controlador I2C em nível de registrador (hardware/structs/i2c.h)
+// ---------------------------------------------------------------------------
+//
+// O bastante do DW_apb_i2c em modo mestre para rodar lib/i2c_async.c: FIFOs
+// de 16 entradas; um comando de IC_DATA_CMD por tempo de byte no relógio
+// virtual, com START, RESTART (pelo flag ou na troca de direção) e STOP pelo
+// flag, e o barramento retido enquanto a FIFO de transmissão estiver vazia
+// sem STOP; NACK de endereço gera TX_ABRT, descarta a FIFO de transmissão até
+// a leitura de IC_CLR_TX_ABRT e manda STOP, com STOP_DET um bit depois. As
+// interrupções são por nível: o handler roda de novo enquanto INTR_STAT não
+// for zero, e um handler que volta sem mudar nada conta em irq_storms.
+
+#define SIM_I2C_FIFO_DEPTH 16
+#define SIM_I2C_SEGMENT_MAX 256
+#define SIM_I2C_TAR_RESET 0x055
+#define SIM_I2C_READ_MARK 0x5A5A0000u // Bits que uma escrita em IC_DATA_CMD nunca tem
+
+typedef struct {
+    uint bus;
+    // Registradores
+    bool enabled;
+    uint32_t tar, intr_mask, rx_tl, tx_tl, abort_source;
+    uint32_t raw_intr;                    // STOP_DET e TX_ABRT, presos até IC_CLR_*
+    bool tx_flushed;                      // Depois de um abort, até IC_CLR_TX_ABRT
+    uint32_t txf[SIM_I2C_FIFO_DEPTH];
+    uint32_t tx_head, tx_count;
+    uint8_t rxf[SIM_I2C_FIFO_DEPTH];
+    uint32_t rx_head, rx_count;
+    // Barramento
+    bool active;                          // Entre START e STOP
+    bool reading;
+    bool stopping;                        // STOP depois de um abort
+    sim_i2c_device_t *device;             // NULL: endereço sem resposta
+    uint8_t segment[SIM_I2C_SEGMENT_MAX]; // Escrita do trecho em andamento
+    size_t segment_len;
+    uint64_t burst_us;                    // Início dos bits em sequência no barramento
+    uint32_t burst_bits;
+    bool step_pending, sync_pending, in_dispatch;
+    // Último acesso do firmware, interpretado no acesso seguinte
+    bool access_pending;
+    enum sim_i2c_reg access_reg;
+    uint access_slot;
+    uint32_t access_value;
+} sim_i2c_ctrl_t;
+
+static i2c_hw_t i2c_hw_regs[2];
+static sim_i2c_ctrl_t i2c_ctrls[2] = {{.bus = 0}, {.bus = 1}};
+static sim_i2c_ctrl_t *i2c_selected = &i2c_ctrls[0];
+
+_Static_assert(sizeof(i2c_hw_t) == SIM_I2C_NUM_REGS * sizeof(sim_i2c_reg_t), "i2c_hw_t fora da ordem de sim_i2c_reg");
+
+static volatile uint32_t *i2c_reg_word(uint bus, enum sim_i2c_reg reg, uint slot) {
+    return &((sim_i2c_reg_t *)&i2c_hw_regs[bus])[reg][slot];
+}
+
+static void i2c_ctrl_step(void *arg);
+static void i2c_ctrl_sync(void *arg);
+
+static void i2c_ctrl_reset(uint bus) {
+    sim_i2c_ctrl_t *c = &i2c_ctrls[bus];
+    c->enabled = true; // i2c_init() termina com o controlador habilitado
+    c->tar = SIM_I2C_TAR_RESET;
+    c->intr_mask = c->rx_tl = c->tx_tl = c->abort_source = c->raw_intr = 0;
+    c->tx_flushed = c->active = c->stopping = false;
+    c->tx_count = c->rx_count = 0;
+    c->segment_len = 0;
+    c->access_pending = false;
+}
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    i2c_selected = &i2c_ctrls[i2c->index];
+    return &i2c_hw_regs[i2c->index];
+}
+
+static uint32_t i2c_ctrl_raw_intr(const sim_i2c_ctrl_t *c) {
+    uint32_t raw = c->raw_intr;
+    if (c->enabled && c->tx_count <= c->tx_tl) raw |= I2C_IC_INTR_STAT_R_TX_EMPTY_BITS;
+    if (c->rx_count > c->rx_tl) raw |= I2C_IC_INTR_STAT_R_RX_FULL_BITS;
+    return raw;
+}
+
+static uint32_t i2c_ctrl_read(const sim_i2c_ctrl_t *c, enum sim_i2c_reg reg) {
+    switch (reg) {
+    case SIM_I2C_ENABLE: return c->enabled;
+    case SIM_I2C_TAR: return c->tar;
+    case SIM_I2C_DATA_CMD: return SIM_I2C_READ_MARK | (c->rx_count ? c->rxf[c->rx_head] : 0);
+    case SIM_I2C_RXFLR: return c->rx_count;
+    case SIM_I2C_TXFLR: return c->tx_count;
+    case SIM_I2C_INTR_MASK: return c->intr_mask;
+    case SIM_I2C_INTR_STAT: return i2c_ctrl_raw_intr(c) & c->intr_mask;
+    case SIM_I2C_CLR_STOP_DET: return (c->raw_intr & I2C_IC_INTR_STAT_R_STOP_DET_BITS) != 0;
+    case SIM_I2C_CLR_TX_ABRT: return (c->raw_intr & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) != 0;
+    case SIM_I2C_TX_ABRT_SOURCE: return c->abort_source;
+    case SIM_I2C_RX_TL: return c->rx_tl;
+    case SIM_I2C_TX_TL: return c->tx_tl;
+    default: return 0;
+    }
+}
+
+static uint32_t i2c_ctrl_bits_us(const sim_i2c_ctrl_t *c, uint32_t bits) {
+    uint baud = c->bus ? i2c1_inst.baudrate : i2c0_inst.baudrate;
+    return (uint32_t)(((uint64_t)bits * 1000000 + baud - 1) / baud);
+}
+
+// Agenda o próximo passo do barramento: o comando na frente da FIFO, ou o
+// STOP de um abort. Sem nada a fazer o barramento fica parado (ou retido).
+static void i2c_ctrl_schedule(sim_i2c_ctrl_t *c) {
+    if (c->step_pending || !c->enabled || (!c->stopping && !c->tx_count)) return;
+
+    uint32_t bits = 1;
+    if (!c->stopping) {
+        uint32_t cmd = c->txf[c->tx_head];
+        bool read = cmd & I2C_IC_DATA_CMD_CMD_BITS;
+        bits = 9;
+        if (!c->active) {
+            bits += 1 + 9; // START e endereço
+            if (!i2c_find_device(c->bus, (uint8_t)c->tar)) bits = 1 + 9;
+        } else if ((cmd & I2C_IC_DATA_CMD_RESTART_BITS) || read != c->reading) {
+            bits += 1 + 9; // RESTART e endereço
+        }
+        if (cmd & I2C_IC_DATA_CMD_STOP_BITS) bits += 1;
+    }
+
+    // Bits seguidos contam a partir do início da sequência, para o
+    // arredondamento não acumular; depois de uma pausa, recomeça agora
+    uint64_t now = sim_now_us();
+    if (now > c->burst_us + i2c_ctrl_bits_us(c, c->burst_bits)) {
+        c->burst_us = now;
+        c->burst_bits = 0;
+    }
+    c->burst_bits += bits;
+    uint64_t at = c->burst_us + i2c_ctrl_bits_us(c, c->burst_bits);
+    sim_i2c_stats[c->bus].busy_us += at - now;
+    c->step_pending = true;
+    sim_schedule(at, i2c_ctrl_step, c);
+}
+
+static void i2c_ctrl_commit(sim_i2c_ctrl_t *c) {
+    if (!c->access_pending) return;
+    c->access_pending = false;
+    uint32_t v = *i2c_reg_word(c->bus, c->access_reg, c->access_slot);
+    bool written = v != c->access_value;
+    sim_i2c_hw_stats_t *hs = &sim_i2c_hw_stats[c->bus];
+
+    switch (c->access_reg) {
+    case SIM_I2C_ENABLE:
+        if (!written) break;
+        if (c->active && !(v & 1)) {
+            fprintf(stderr, "sim: controlador I2C desabilitado no meio de uma transação\n");
+            abort();
+        }
+        c->enabled = v & 1;
+        if (!c->enabled) {
+            // Desabilitado: FIFOs e interrupções zeradas
+            c->tx_count = c->rx_count = 0;
+            c->raw_intr = 0;
+            c->tx_flushed = false;
+        }
+        break;
+    case SIM_I2C_TAR:
+        if (!written) break;
+        if (c->enabled) {
+            hs->tar_ignored++;
+        } else {
+            c->tar = v & 0x3FF;
+            hs->tar_writes++;
+        }
+        break;
+    case SIM_I2C_DATA_CMD:
+        if (!written) {
+            if (c->rx_count) {
+                c->rx_head = (c->rx_head + 1) % SIM_I2C_FIFO_DEPTH;
+                c->rx_count--;
+            }
+        } else if (!c->enabled || c->tx_flushed) {
+            hs->tx_dropped++;
+        } else if (c->tx_count == SIM_I2C_FIFO_DEPTH) {
+            hs->tx_overflows++;
+        } else {
+            c->txf[(c->tx_head + c->tx_count) % SIM_I2C_FIFO_DEPTH] = v;
+            c->tx_count++;
+            i2c_ctrl_schedule(c);
+        }
+        break;
+    case SIM_I2C_INTR_MASK: c->intr_mask = v; break;
+    case SIM_I2C_RX_TL: c->rx_tl = v; break;
+    case SIM_I2C_TX_TL: c->tx_tl = v; break;
+    case SIM_I2C_CLR_STOP_DET:
+        c->raw_intr &= ~I2C_IC_INTR_STAT_R_STOP_DET_BITS;
+        break;
+    case SIM_I2C_CLR_TX_ABRT:
+        c->raw_intr &= ~I2C_IC_INTR_STAT_R_TX_ABRT_BITS;
+        c->abort_source = 0;
+        c->tx_flushed = false;
+        break;
+    default: break; // Só leitura
+    }
+}
+
+uint sim_i2c_reg(enum sim_i2c_reg reg) {
+    sim_i2c_ctrl_t *c = i2c_selected;
+    i2c_ctrl_commit(c);
+    c->access_pending = true;
+    c->access_reg = reg;
+    c->access_slot ^= 1;
+    c->access_value = i2c_ctrl_read(c, reg);
+    *i2c_reg_word(c->bus, reg, c->access_slot) = c->access_value;
+    // Fora do handler o efeito aparece quando o firmware ceder o processador
+    if (!c->in_dispatch && !c->sync_pending) {
+        c->sync_pending = true;
+        sim_schedule(sim_now_us(), i2c_ctrl_sync, c);
+    }
+    return c->access_slot;
+}
+
+static void i2c_ctrl_dispatch(sim_i2c_ctrl_t *c) {
+    uint irq = c->bus ? I2C1_IRQ : I2C0_IRQ;
+    sim_i2c_ctrl_t *selected = i2c_selected;
+    c->in_dispatch = true;
+    while (irq_enabled[irq] && (i2c_ctrl_raw_intr(c) & c->intr_mask)) {
+        uint32_t before[] = {c->raw_intr, c->intr_mask, c->tx_count, c->rx_count, c->tx_flushed, c->enabled};
+        sim_i2c_hw_stats[c->bus].irqs++;
+        irq_raise(irq);
+        i2c_ctrl_commit(c);
+        uint32_t after[] = {c->raw_intr, c->intr_mask, c->tx_count, c->rx_count, c->tx_flushed, c->enabled};
+        if (!memcmp(before, after, sizeof(before))) {
+            sim_i2c_hw_stats[c->bus].irq_storms++;
+            break;
+        }
+    }
+    c->in_dispatch = false;
+    i2c_selected = selected;
+}
+
+static void i2c_ctrl_sync(void *arg) {
+    sim_i2c_ctrl_t *c = arg;
+    c->sync_pending = false;
+    i2c_ctrl_commit(c);
+    i2c_ctrl_dispatch(c);
+    i2c_ctrl_schedule(c);
+}
+
+static void i2c_ctrl_irq_enabled(uint bus) {
+    sim_i2c_ctrl_t *c = &i2c_ctrls[bus];
+    if (!c->sync_pending) {
+        c->sync_pending = true;
+        sim_schedule(sim_now_us(), i2c_ctrl_sync, c);
+    }
+}
+
+// Fim do trecho de escrita: o dispositivo recebe tudo de uma vez
+static void i2c_ctrl_flush_segment(sim_i2c_ctrl_t *c) {
+    if (c->segment_len && c->device)
+        c->device->write(c->device->dev, c->segment, c->segment_len);
+    c->segment_len = 0;
+}
+
+static void i2c_ctrl_step(void *arg) {
+    sim_i2c_ctrl_t *c = arg;
+    sim_i2c_hw_stats_t *hs = &sim_i2c_hw_stats[c->bus];
+    sim_bus_stats_t *stats = &sim_i2c_stats[c->bus];
+    c->step_pending = false;
+    i2c_ctrl_commit(c);
+
+    if (c->stopping) {
+        c->stopping = false;
+        c->active = false;
+        c->raw_intr |= I2C_IC_INTR_STAT_R_STOP_DET_BITS;
+        hs->stops++;
+        stats->transactions++;
+    } else if (c->enabled && c->tx_count) {
+        uint32_t cmd = c->txf[c->tx_head];
+        c->tx_head = (c->tx_head + 1) % SIM_I2C_FIFO_DEPTH;
+        c->tx_count--;
+        bool read = cmd & I2C_IC_DATA_CMD_CMD_BITS;
+
+        if (!c->active || (cmd & I2C_IC_DATA_CMD_RESTART_BITS) || read != c->reading) {
+            if (c->active) {
+                i2c_ctrl_flush_segment(c);
+                hs->restarts++;
+            } else {
+                c->active = true;
+                c->device = i2c_find_device(c->bus, (uint8_t)c->tar);
+            }
+            c->reading = read;
+            if (!c->device) {
+                // NACK do endereço: abort, FIFO descartada e STOP
+                c->abort_source = I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS;
+                c->raw_intr |= I2C_IC_INTR_STAT_R_TX_ABRT_BITS;
+                c->tx_flushed = true;
+                c->tx_count = 0;
+                c->stopping = true;
+                hs->aborts++;
+                stats->nacks++;
+            } else if (c->device->start) {
+                c->device->start(c->device->dev);
+            }
+        }
+
+        if (c->device) {
+            if (read) {
+                uint8_t byte;
+                c->device->read(c->device->dev, &byte, 1);
+                if (c->rx_count == SIM_I2C_FIFO_DEPTH) {
+                    hs->rx_overflows++;
+                } else {
+                    c->rxf[(c->rx_head + c->rx_count) % SIM_I2C_FIFO_DEPTH] = byte;
+                    c->rx_count++;
+                    if (c->rx_count > hs->rx_max) hs->rx_max = c->rx_count;
+                }
+            } else {
+                if (c->segment_len == SIM_I2C_SEGMENT_MAX) {
+                    fprintf(stderr, "sim: escrita I2C maior que %u bytes\n", SIM_I2C_SEGMENT_MAX);
+                    abort();
+                }
+                c->segment[c->segment_len++] = (uint8_t)cmd;
+            }
+            stats->bytes++;
+            if (cmd & I2C_IC_DATA_CMD_STOP_BITS) {
+                i2c_ctrl_flush_segment(c);
+                c->active = false;
+                c->raw_intr |= I2C_IC_INTR_STAT_R_STOP_DET_BITS;
+                hs->stops++;
+                stats->transactions++;
+            }
+        }
+    }
+
+    i2c_ctrl_dispatch(c);
+    i2c_ctrl_schedule(c);
+}
+
+// ---------------------------------------------------------------------------
+// CDC USB
+// ---------------------------------------------------------------------------
+
+#define SIM_CDC_TX_FIFO 256       // CFG_TUD_CDC_TX_BUFSIZE
+#define SIM_CDC_BYTES_PER_MS 64   // Um pacote bulk full-speed por quadro USB
+
+FILE *sim_usb_cdc_out;
+uint32_t sim_usb_cdc_bytes;
+static uint32_t cdc_fifo_level;
+static uint64_t cdc_drained_at;
+
+// O host esvazia a FIFO do TinyUSB a uma taxa fixa
+static void cdc_update(void) {
+    uint64_t ms = (sim_now_us() - cdc_drained_at) / 1000;
+    uint64_t drained = ms * SIM_CDC_BYTES_PER_MS;
+    cdc_fifo_level = drained >= cdc_fifo_level ? 0 : cdc_fifo_level - (uint32_t)drained;
+    cdc_drained_at += ms * 1000;
+}
+
+bool tud_cdc_connected(void) {
+    return true;
+}
+
+uint32_t tud_cdc_write_available(void) {
+    cdc_update();
+    return SIM_CDC_TX_FIFO - cdc_fifo_level;
+}
+
+uint32_t tud_cdc_write(const void *buf, uint32_t n) {
+    uint32_t available = tud_cdc_write_available();
+    if (n > available) n = available;
+    if (sim_usb_cdc_out) fwrite(buf, 1, n, sim_usb_cdc_out);
+    cdc_fifo_level += n;
+    sim_usb_cdc_bytes += n;
+    return n;
+}
+
+uint32_t tud_cdc_write_flush(void) {
+    return 0;
+}
+
+void tud_task(void) {} // A FIFO esvazia sozinha com o tempo (cdc_update)
+
+static void stdio_usb_out_chars(const char *buf, int len) {
+    tud_cdc_write(buf, (uint32_t)len);
+}
+
+static int stdio_usb_in_chars(char *buf, int len) {
+    (void)buf;
+    (void)len;
+    return PICO_ERROR_NO_DATA;
+}
+
+stdio_driver_t stdio_usb = {
+    .out_chars = stdio_usb_out_chars,
+    .in_chars = stdio_usb_in_chars,
+};
+
+void stdio_set_driver_enabled(stdio_driver_t *driver, bool enabled) {
+    (void)driver;
+    (void)enabled;
+}
+
+// ---------------------------------------------------------------------------
+// Flash
+// ---------------------------------------------------------------------------
+
+#define SIM_FLASH_PROGRAM_US 800   // Por página de 256 bytes
+#define SIM_FLASH_ERASE_US 45000   // Por setor de 4 KB
+
+uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+sim_flash_stats_t sim_flash_stats;
+int32_t sim_flash_program_limit = -1;
+uint32_t sim_flash_binary_size = 256 * 1024;
+
+void sim_flash_reset(void) {
+    memset(sim_flash, 0xFF, sizeof(sim_flash));
+}
+
+bool sim_flash_load(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+    size_t n = fread(sim_flash, 1, sizeof(sim_flash), f);
+    fclose(f);
+    return n == sizeof(sim_flash);
+}
+
+bool sim_flash_save(const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+    size_t n = fwrite(sim_flash, 1, sizeof(sim_flash), f);
+    fclose(f);
+    return n == sizeof(sim_flash);
+}
+
+// As restrições de alinhamento do SDK valem aqui também, para pegar o erro
+// no host em vez de na placa
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > sizeof(sim_flash)) {
+        fprintf(stderr, "sim: flash_range_erase desalinhado: 0x%x + %zu\n", flash_offs, count);
+        abort();
+    }
+    memset(sim_flash + flash_offs, 0xFF, count);
+    sim_flash_stats.erases += count / FLASH_SECTOR_SIZE;
+    sim_advance_to(now_us + SIM_FLASH_ERASE_US * (count / FLASH_SECTOR_SIZE));
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > sizeof(sim_flash)) {
+        fprintf(stderr, "sim: flash_range_program desalinhado: 0x%x + %zu\n", flash_offs, count);
+        abort();
+    }
+    size_t n = count;
+    if (sim_flash_program_limit >= 0) {
+        n = (size_t)sim_flash_program_limit < count ? (size_t)sim_flash_program_limit : count;
+        sim_flash_program_limit = -1;
+    }
+    for (size_t i = 0; i < n; i++)
+        sim_flash[flash_offs + i] &= data[i]; // NOR: só zera bits
+    sim_flash_stats.programs += count / FLASH_PAGE_SIZE;
+    sim_advance_to(now_us + SIM_FLASH_PROGRAM_US * (count / FLASH_PAGE_SIZE));
+}
+
+int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    func(param);
+    return PICO_OK;
+}
+
+bool flash_safe_execute_core_init(void) {
+    return true;
+}
@@ -0,0 +1,219 @@
+// Simulação do firmware no host.
+//
+// Compila Luminosidade-Cores.c e lib/ contra os shims de sim/include e roda
+// os escalonadores reais dos dois núcleos (lib/sched.h) sobre um relógio
+// virtual, com modelos do SSD1306, BH1750 e TCS34725. Para cada amostra
+// publicada imprime o intervalo desde a anterior e o tráfego por barramento,
+// o que permite medir o efeito de uma mudança sem a placa.
+//
+// Os dois núcleos rodam intercalados na mesma thread: o tempo gasto pelas
+// tarefas do núcleo 1 (I2C bloqueante do display) também atrasa o núcleo 0
+// e aparece separado na coluna "core1".
+//
+// Uso: colorlux_sim [-v] [-t ms] [-q] [-p] [-n ruído%] [-F] [-f flash.bin] [-T arquivo]
+//   -v  mostra os printf do firmware (no hardware eles vão em quadros de
+//       texto da telemetria, fora do fluxo de -T)
+//   -t  tempo simulado em ms (padrão 3000)
+//   -q  só o resumo final
+//   -p  imprime a latência por estágio e as estatísticas das tarefas no fim
+//   -n  ruído nas leituras dos sensores, em % (ver sim_set_noise)
+//   -F  começa com o filtro das leituras desligado, como o comando 'f'
+//   -f  imagem da flash: lida no início (se existir) e gravada no fim, para
+//       simular um boot a quente com a calibração da execução anterior
+//   -T  grava o fluxo de telemetria do CDC USB (ver tools/telemetry_decode.py)
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "tusb.h"
+
+static bool sim_verbose;
+
+static int sim_printf(const char *fmt, ...) {
+    if (!sim_verbose) return 0;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vprintf(fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+#define printf sim_printf
+#define main firmware_main
+#include "../Luminosidade-Cores.c"
+#undef main
+#undef printf
+
+// Roteiro de iluminação: cada fase vale a partir do instante indicado
+typedef struct {
+    uint32_t at_ms;
+    const char *name;
+    sim_scene_t scene;
+} sim_phase_t;
+
+static const sim_phase_t phases[] = {
+    {   0, "interior", { 200,  300,  400,  250,  1000}},
+    { 800, "escuro",   {   0,    2,    2,    1,     6}},
+    {1600, "sol",      {5000, 9000, 8000, 6000, 24000}},
+    {2400, "vermelho", { 150,  600,  120,   90,   820}},
+};
+#define NUM_PHASES (sizeof(phases) / sizeof(phases[0]))
+
+typedef struct {
+    sim_bus_stats_t i2c[2];
+    sim_pio_stats_t pio;
+} sim_snapshot_t;
+
+static sim_snapshot_t snapshot(void) {
+    sim_snapshot_t s = {{sim_i2c_stats[0], sim_i2c_stats[1]}, sim_pio_stats};
+    return s;
+}
+
+int main(int argc, char **argv) {
+    uint32_t duration_ms = 3000;
+    bool quiet = false;
+    bool profile = false;
+    const char *flash_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-v")) sim_verbose = true;
+        else if (!strcmp(argv[i], "-q")) quiet = true;
+        else if (!strcmp(argv[i], "-p")) profile = true;
+        else if (!strcmp(argv[i], "-T") && i + 1 < argc) {
+            sim_usb_cdc_out = fopen(argv[++i], "wb");
+            if (!sim_usb_cdc_out) {
+                perror(argv[i]);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) duration_ms = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc) sim_set_noise((uint8_t)atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-F")) filter_bypass = true;
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc) flash_path = argv[++i];
+        else {
+            fprintf(stderr, "uso: %s [-v] [-t ms] [-q] [-p] [-n ruído%%] [-F] [-f flash.bin] [-T arquivo]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    sim_devices_init();
+    sim_flash_reset();
+    if (flash_path && sim_flash_load(flash_path) && !quiet)
+        printf("flash carregada de %s\n", flash_path);
+
+    sim_set_scene(&phases[0].scene);
+
+    // O boot do firmware; o núcleo 1 inicia as saídas logo depois do lançamento
+    boot_core0();
+    sim_core_num = 1;
+    outputs_init();
+    sim_core_num = 0;
+
+    uint64_t start_us = sim_now_us();
+    uint64_t end_us = start_us + (uint64_t)duration_ms * 1000;
+    uint64_t last_us = start_us;
+    uint32_t phase = 0, samples = 0;
+    uint32_t last_head = sample_ring.head;
+    uint8_t last_step = gy33_get_exposure_step();
+    uint64_t step_changed_us = start_us;
+    uint64_t core1_us = 0, core1_total_us = 0;
+    sim_snapshot_t first = snapshot(), last = first;
+
+    if (!quiet) {
+        printf("%8s %5s %4s %5s %5s %5s %5s %5s | %6s | %-15s | %-15s | %4s | %6s\n",
+               "t_ms", "seq", "exp", "lux", "R", "G", "B", "C",
+               "dt_us", "i2c0 txn/B/us", "i2c1 txn/B/us", "pio", "core1");
+    }
+
+    while (sim_now_us() < end_us) {
+        uint32_t t_ms = (uint32_t)((sim_now_us() - start_us) / 1000);
+        while (phase + 1 < NUM_PHASES && t_ms >= phases[phase + 1].at_ms) {
+            sim_set_scene(&phases[++phase].scene);
+            if (!quiet) printf("--- %s\n", phases[phase].name);
+        }
+
+        uint64_t next0 = sched_run_pending(&sensors_sched);
+        uint64_t t1 = sim_now_us();
+        sim_core_num = 1;
+        uint64_t next1 = sched_run_pending(&outputs_sched);
+        sim_core_num = 0;
+        core1_us += sim_now_us() - t1;
+
+        if (sample_ring.head != last_head) {
+            const sensor_sample_t *latest = &sample_ring.items[(sample_ring.head - 1) & (SAMPLE_RING_SIZE - 1)];
+            last_head = sample_ring.head;
+            samples++;
+            if (gy33_get_exposure_step() != last_step) {
+                last_step = gy33_get_exposure_step();
+                step_changed_us = sim_now_us();
+            }
+
+            sim_snapshot_t now = snapshot();
+            if (!quiet) {
+                char bus0[24], bus1[24];
+                snprintf(bus0, sizeof(bus0), "%u/%u/%llu",
+                         now.i2c[0].transactions - last.i2c[0].transactions,
+                         now.i2c[0].bytes - last.i2c[0].bytes,
+                         (unsigned long long)(now.i2c[0].busy_us - last.i2c[0].busy_us));
+                snprintf(bus1, sizeof(bus1), "%u/%u/%llu",
+                         now.i2c[1].transactions - last.i2c[1].transactions,
+                         now.i2c[1].bytes - last.i2c[1].bytes,
+                         (unsigned long long)(now.i2c[1].busy_us - last.i2c[1].busy_us));
+                printf("%8.1f %5u %4u %5u %5u %5u %5u %5u | %6llu | %-15s | %-15s | %4u | %6llu\n",
+                       (sim_now_us() - start_us) / 1000.0, (unsigned)latest->seq, gy33_get_exposure_step(),
+                       latest->lux, latest->r, latest->g, latest->b, latest->c,
+                       (unsigned long long)(sim_now_us() - last_us), bus0, bus1,
+                       now.pio.words - last.pio.words, (unsigned long long)core1_us);
+            }
+            last = now;
+            last_us = sim_now_us();
+            core1_total_us += core1_us;
+            core1_us = 0;
+        }
+
+        // Os dois núcleos em WFE até a próxima liberação ou interrupção
+        if (sched_has_pending(&sensors_sched) || sched_has_pending(&outputs_sched))
+            continue;
+        best_effort_wfe_or_timeout(next0 < next1 ? next0 : next1);
+    }
+    core1_total_us += core1_us;
+
+    double elapsed_s = (sim_now_us() - start_us) / 1e6;
+    sim_snapshot_t total = snapshot();
+    printf("\nresumo: %.3f s simulados, %u amostras (%.1f/s)\n", elapsed_s, samples, samples / elapsed_s);
+    for (int bus = 0; bus < 2; bus++) {
+        sim_bus_stats_t d = {
+            total.i2c[bus].transactions - first.i2c[bus].transactions,
+            total.i2c[bus].bytes - first.i2c[bus].bytes,
+            total.i2c[bus].nacks - first.i2c[bus].nacks,
+            total.i2c[bus].busy_us - first.i2c[bus].busy_us,
+        };
+        printf("i2c%d: %u transações, %u bytes, %u NACK, %.1f%% ocupado, %.1f bytes/amostra\n",
+               bus, d.transactions, d.bytes, d.nacks, 100.0 * d.busy_us / (elapsed_s * 1e6),
+               samples ? (double)d.bytes / samples : 0.0);
+    }
+    printf("pio: %u palavras em %u transferências DMA\n",
+           total.pio.words - first.pio.words, total.pio.transfers - first.pio.transfers);
+    printf("telemetria: %u bytes no CDC, %u quadros descartados\n",
+           sim_usb_cdc_bytes, telemetry_dropped());
+    printf("núcleo 1: %.1f%% ocupado\n", 100.0 * core1_total_us / (elapsed_s * 1e6));
+    printf("boot: sensores %.1f ms, display %.1f ms, primeira amostra %.1f ms, primeiro quadro %.1f ms%s\n",
+           boot_mark_us(BOOT_SENSORS_STARTED) / 1000.0, boot_mark_us(BOOT_DISPLAY_READY) / 1000.0,
+           boot_mark_us(BOOT_FIRST_SAMPLE) / 1000.0, boot_mark_us(BOOT_FIRST_FRAME) / 1000.0,
+           boot_in_order() ? "" : " (fora de ordem)");
+    printf("exposição: passo %u, última troca em %.1f ms; flash: %u páginas programadas, %u setores apagados\n",
+           last_step, (step_changed_us - start_us) / 1000.0, sim_flash_stats.programs, sim_flash_stats.erases);
+    if (profile) {
+        printf("\n");
+        prof_dump();
+        printf("\n");
+        sched_dump(&sensors_sched);
+        sched_dump(&outputs_sched);
+    }
+    if (sim_usb_cdc_out) fclose(sim_usb_cdc_out);
+    if (flash_path && !sim_flash_save(flash_path))
+        perror(flash_path);
+    return 0;
+}
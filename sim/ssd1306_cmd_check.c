@@ -0,0 +1,94 @@
+// Verificação no host das listas de comandos do SSD1306
+// (ssd1306_command_list em lib/ssd1306.c) pela contabilidade do I2C simulado.
+//
+// Confere que:
+//   - ssd1306_config() manda a sequência de inicialização numa transação só,
+//     com um byte de controle, em vez de uma transação por comando;
+//   - o posicionamento da janela do flush é uma transação;
+//   - listas maiores que SSD1306_CMD_LIST_MAX viram ceil(n / máximo)
+//     transações, e um comando cortado entre duas delas chega inteiro ao
+//     display (a janela posicionada assim recebe os dados no lugar certo).
+//
+// Uso: colorlux_ssd1306_cmd_check
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "ssd1306.h"
+#include "check.h"
+
+#define SSD1306_NOP 0xE3
+#define INIT_COMMANDS 25 // Bytes de ssd1306_init_sequence
+
+static sim_bus_stats_t mark;
+
+static void bus_mark(void) {
+    mark = sim_i2c_stats[1];
+}
+
+static void bus_expect(const char *name, uint32_t txns, uint32_t bytes) {
+    uint32_t t = sim_i2c_stats[1].transactions - mark.transactions;
+    uint32_t b = sim_i2c_stats[1].bytes - mark.bytes;
+    uint32_t us = (uint32_t)(sim_i2c_stats[1].busy_us - mark.busy_us);
+    printf("%-24s %2u transações %4u bytes %5u us\n", name, t, b, us);
+    CHECK(t == txns && b == bytes, "%s: %u transações e %u bytes, esperado %u e %u", name, t, b, txns, bytes);
+}
+
+int main(void) {
+    static ssd1306_t ssd;
+    sim_devices_init();
+    i2c_init(i2c1, 400 * 1000);
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c1);
+
+    bus_mark();
+    ssd1306_config(&ssd);
+    bus_expect("config", 1, INIT_COMMANDS + 1);
+    uint64_t list_us = sim_i2c_stats[1].busy_us - mark.busy_us;
+
+    // O mesmo número de comandos um a um (controle + comando cada)
+    bus_mark();
+    for (int i = 0; i < INIT_COMMANDS; i++)
+        ssd1306_command(&ssd, SSD1306_NOP);
+    bus_expect("config, um por comando", INIT_COMMANDS, 2 * INIT_COMMANDS);
+    uint64_t single_us = sim_i2c_stats[1].busy_us - mark.busy_us;
+    CHECK(list_us * 2 < single_us, "lista em %llu us, um a um em %llu us",
+          (unsigned long long)list_us, (unsigned long long)single_us);
+
+    // Primeiro flush: janela (uma transação) e dados (outra)
+    ssd1306_fill(&ssd, false);
+    bus_mark();
+    ssd1306_send_data(&ssd);
+    bus_expect("flush inteiro", 2, 7 + 1 + WIDTH * HEIGHT / 8);
+
+    uint8_t cmds[3 * SSD1306_CMD_LIST_MAX];
+    memset(cmds, SSD1306_NOP, sizeof(cmds));
+    bus_mark();
+    ssd1306_command_list(&ssd, cmds, sizeof(cmds));
+    bus_expect("3 x máximo", 3, sizeof(cmds) + 3);
+
+    bus_mark();
+    ssd1306_command_list(&ssd, cmds, SSD1306_CMD_LIST_MAX + 1);
+    bus_expect("máximo + 1", 2, SSD1306_CMD_LIST_MAX + 1 + 2);
+
+    // SET_COL_ADDR cortado entre a primeira e a segunda transação
+    uint32_t n = 0;
+    while (n < SSD1306_CMD_LIST_MAX - 1)
+        cmds[n++] = SSD1306_NOP;
+    const uint8_t window[] = {SET_COL_ADDR, 40, 43, SET_PAGE_ADDR, 2, 3};
+    memcpy(cmds + n, window, sizeof(window));
+    n += sizeof(window);
+    bus_mark();
+    ssd1306_command_list(&ssd, cmds, n);
+    bus_expect("janela cortada", 2, n + 2);
+
+    const uint8_t data[] = {0x40, 1, 2, 3, 4, 5, 6, 7, 8};
+    i2c_write_blocking(i2c1, 0x3C, data, sizeof(data), false);
+    const uint8_t *gddram = sim_ssd1306_gddram();
+    bool placed = true;
+    for (int i = 0; i < 8; i++)
+        if (gddram[(40 + i / 2) * 8 + 2 + i % 2] != data[1 + i])
+            placed = false;
+    CHECK(placed, "dados fora da janela posicionada pela lista cortada");
+
+    return check_exit("ssd1306_cmd");
+}
@@ -0,0 +1,132 @@
+// Verificação no host das janelas sujas do SSD1306 (ssd1306_send_data em
+// lib/ssd1306.c) sobre o I2C e o modelo do display de sim_devices.c.
+//
+// Para cada cenário confere a janela escolhida (quadro inteiro, retângulo
+// envolvente ou uma por página) pelo número de transações e bytes no
+// barramento, e que a GDDRAM simulada termina igual ao framebuffer:
+//   - depois de ssd1306_invalidate() vai o quadro inteiro;
+//   - redesenhar o mesmo conteúdo (ou sujar e desfazer) não gera tráfego;
+//   - um pixel vai numa janela de um byte;
+//   - dois pixels em cantos opostos vão em janelas por página;
+//   - um retângulo que cruza páginas vai no retângulo envolvente;
+//   - uma faixa suja é recortada ao que difere do já enviado;
+//   - mudar quase tudo volta ao quadro inteiro;
+//   - o custo de uma janela no barramento (endereços incluídos) é
+//     SSD1306_WINDOW_COST e, nos casos em que retângulo envolvente e janelas
+//     por página ficam a um byte um do outro, vai o que move menos bytes.
+//
+// Uso: colorlux_ssd1306_dirty_check
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "ssd1306.h"
+#include "check.h"
+
+// Bytes de uma janela no barramento sem os dois de endereço, como
+// sim_i2c_stats: controle + 6 comandos, depois controle + dados
+#define WINDOW_BYTES(cols, rows) (SSD1306_WINDOW_COST - 2 + (cols) * (rows))
+#define FULL_BYTES WINDOW_BYTES(WIDTH, HEIGHT / 8)
+
+static ssd1306_t ssd;
+
+// Envia e compara o tráfego com o esperado (windows transações de janela)
+static void flush_expect(const char *name, uint32_t windows, uint32_t bytes) {
+    uint32_t txns0 = sim_i2c_stats[1].transactions, bytes0 = sim_i2c_stats[1].bytes;
+    ssd1306_send_data(&ssd);
+    uint32_t txns = sim_i2c_stats[1].transactions - txns0;
+    uint32_t sent = sim_i2c_stats[1].bytes - bytes0;
+    printf("%-22s %2u transações %5u bytes\n", name, txns, sent);
+    CHECK(txns == 2 * windows && sent == bytes, "%s: %u transações e %u bytes, esperado %u e %u",
+          name, txns, sent, 2 * windows, bytes);
+    CHECK(!memcmp(sim_ssd1306_gddram(), ssd.ram_buffer + 1, WIDTH * HEIGHT / 8),
+          "%s: GDDRAM diferente do framebuffer", name);
+}
+
+// Bytes no barramento contando os de endereço (um por transação)
+static uint32_t bus_bytes(void) {
+    return sim_i2c_stats[1].bytes + sim_i2c_stats[1].transactions;
+}
+
+// Apaga uma coluna na página 0 e duas na página 1, gap colunas adiante (a
+// tela está toda acesa): retângulo envolvente de gap + 2 colunas por 2
+// páginas ou duas janelas de 1 e 2 colunas. Confere que foi a opção com
+// menos bytes no barramento, pelo custo de janela medido.
+static void check_choice(const char *name, uint8_t gap, uint32_t window_bus) {
+    uint8_t x = 40;
+    ssd1306_pixel(&ssd, x, 0, false);
+    ssd1306_pixel(&ssd, x + gap, 8, false);
+    ssd1306_pixel(&ssd, x + gap + 1, 8, false);
+    uint32_t box = window_bus + 2 * (gap + 2);
+    uint32_t per_page = 2 * window_bus + 1 + 2;
+    uint32_t before = bus_bytes();
+    ssd1306_send_data(&ssd);
+    uint32_t used = bus_bytes() - before;
+    printf("%-22s retângulo %u bytes, por página %u, enviou %u\n", name, box, per_page, used);
+    CHECK(used == (box <= per_page ? box : per_page), "%s: %u bytes no barramento, retângulo %u, por página %u",
+          name, used, box, per_page);
+    ssd1306_fill(&ssd, true);
+    ssd1306_send_data(&ssd);
+}
+
+int main(void) {
+    sim_devices_init();
+    i2c_init(i2c1, 400 * 1000);
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, i2c1);
+    ssd1306_config(&ssd);
+
+    ssd1306_fill(&ssd, false);
+    flush_expect("invalidate", 1, FULL_BYTES);
+
+    ssd1306_fill(&ssd, false);
+    ssd1306_draw_string(&ssd, "   ", 0, 0);
+    flush_expect("mesmo conteúdo", 0, 0);
+
+    ssd1306_pixel(&ssd, 10, 20, true);
+    ssd1306_pixel(&ssd, 10, 20, false);
+    flush_expect("sujo e desfeito", 0, 0);
+
+    ssd1306_pixel(&ssd, 10, 20, true);
+    flush_expect("um pixel", 1, WINDOW_BYTES(1, 1));
+
+    ssd1306_pixel(&ssd, 0, 0, true);
+    ssd1306_pixel(&ssd, WIDTH - 1, HEIGHT - 1, true);
+    flush_expect("cantos opostos", 2, 2 * WINDOW_BYTES(1, 1));
+
+    // Linhas 16..39 = páginas 2..4, colunas 30..70
+    ssd1306_rect(&ssd, 16, 30, 41, 24, true, true);
+    flush_expect("retângulo", 1, WINDOW_BYTES(41, 3));
+
+    // Na página 2 as colunas 30..70 já estão acesas pelo retângulo: a faixa
+    // suja é a linha inteira, mas só se recortam as pontas iguais
+    ssd1306_hline(&ssd, 0, WIDTH - 1, 16, true);
+    flush_expect("linha", 1, WINDOW_BYTES(WIDTH, 1));
+
+    // Redesenhar a linha não muda nada; só o pixel novo vai
+    ssd1306_hline(&ssd, 0, WIDTH - 1, 16, true);
+    ssd1306_pixel(&ssd, 60, 50, true);
+    flush_expect("faixa recortada", 1, WINDOW_BYTES(1, 1));
+
+    ssd1306_hline(&ssd, 20, 100, 8, true);
+    ssd1306_hline(&ssd, 20, 100, 8, false);
+    ssd1306_pixel(&ssd, 90, 8, true);
+    flush_expect("ponta recortada", 1, WINDOW_BYTES(1, 1));
+
+    ssd1306_fill(&ssd, true);
+    flush_expect("quase tudo", 1, FULL_BYTES);
+
+    // Custo de uma janela medido no barramento: um byte de dados
+    ssd1306_pixel(&ssd, 5, 5, false);
+    uint32_t before = bus_bytes();
+    ssd1306_send_data(&ssd);
+    uint32_t window_bus = bus_bytes() - before - 1;
+    CHECK(window_bus == SSD1306_WINDOW_COST, "janela custa %u bytes no barramento, SSD1306_WINDOW_COST = %u",
+          window_bus, SSD1306_WINDOW_COST);
+    ssd1306_pixel(&ssd, 5, 5, true);
+    ssd1306_send_data(&ssd);
+
+    check_choice("retângulo mais barato", 4, window_bus);
+    check_choice("páginas mais baratas", 6, window_bus);
+
+    return check_exit("ssd1306_dirty");
+}
@@ -0,0 +1,242 @@
+// Verificação e benchmark no host das primitivas de desenho do SSD1306
+// (lib/ssd1306.c), que escrevem bytes de página inteiros, contra uma
+// referência pixel a pixel (a implementação anterior, com recorte).
+//
+// 1. Com o framebuffer cheio de lixo e coordenadas sorteadas (inclusive fora
+//    da tela), cada primitiva (vline e rect preenchido, que usam o span;
+//    hline; line; rect vazado; draw_char) tem que deixar o framebuffer igual
+//    ao da referência, e todo byte alterado tem que estar na faixa suja.
+// 2. Mede ciclos do host por chamada de cada primitiva e da referência (só
+//    para comparação relativa; o M0+ não tem cache nem execução fora de ordem).
+//
+// Uso: colorlux_ssd1306_raster_check [chamadas]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "ssd1306.h"
+#include "font.h"
+#include "check.h"
+
+#define RANDOM_CASES 20000
+
+// --- Referência pixel a pixel ---
+
+static void ref_pixel(ssd1306_t *ssd, int x, int y, bool value) {
+    if (x < 0 || y < 0 || x >= ssd->width || y >= ssd->height)
+        return;
+    uint8_t *byte = ssd->ram_buffer + 1 + x * ssd->pages + (y >> 3);
+    if (value)
+        *byte |= 1 << (y & 7);
+    else
+        *byte &= ~(1 << (y & 7));
+}
+
+static void ref_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
+    for (int x = x0; x <= x1; ++x)
+        ref_pixel(ssd, x, y, value);
+}
+
+static void ref_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+    for (int y = y0; y <= y1; ++y)
+        ref_pixel(ssd, x, y, value);
+}
+
+static void ref_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+    if (!width || !height)
+        return;
+    int right = left + width - 1, bottom = top + height - 1;
+    for (int x = left; x <= right; ++x) {
+        ref_pixel(ssd, x, top, value);
+        ref_pixel(ssd, x, bottom, value);
+    }
+    for (int y = top; y <= bottom; ++y) {
+        ref_pixel(ssd, left, y, value);
+        ref_pixel(ssd, right, y, value);
+    }
+    if (fill)
+        for (int x = left + 1; x < right; ++x)
+            for (int y = top + 1; y < bottom; ++y)
+                ref_pixel(ssd, x, y, value);
+}
+
+static void ref_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    int x = x0, y = y0;
+    int dx = abs(x1 - x0), dy = abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+    int err = dx - dy;
+    while (true) {
+        ref_pixel(ssd, x, y, value);
+        if (x == x1 && y == y1)
+            break;
+        int e2 = err * 2;
+        if (e2 > -dy) { err -= dy; x += sx; }
+        if (e2 < dx) { err += dx; y += sy; }
+    }
+}
+
+static void ref_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y) {
+    const uint8_t *glyph = font + ((c >= ' ' && c <= '~') ? (c - ' ') * 8 : 0);
+    for (int i = 0; i < 8; ++i)
+        for (int j = 0; j < 8; ++j)
+            ref_pixel(ssd, x + i, y + j, glyph[i] & (1 << j));
+}
+
+// --- Comparação ---
+
+typedef enum { PRIM_VLINE, PRIM_HLINE, PRIM_LINE, PRIM_RECT, PRIM_FILL_RECT, PRIM_CHAR, PRIM_COUNT } prim_t;
+
+static const char *const prim_names[PRIM_COUNT] = {
+    "vline (span)", "hline", "line", "rect", "rect cheio (span)", "draw_char"
+};
+
+typedef struct {
+    uint8_t a, b, c, d;
+    bool value;
+    char ch;
+} prim_args_t;
+
+static void run_prim(ssd1306_t *ssd, prim_t prim, const prim_args_t *p, bool reference) {
+    switch (prim) {
+    case PRIM_VLINE:
+        (reference ? ref_vline : ssd1306_vline)(ssd, p->a, p->b, p->c, p->value);
+        break;
+    case PRIM_HLINE:
+        (reference ? ref_hline : ssd1306_hline)(ssd, p->a, p->b, p->c, p->value);
+        break;
+    case PRIM_LINE:
+        (reference ? ref_line : ssd1306_line)(ssd, p->a, p->b, p->c, p->d, p->value);
+        break;
+    case PRIM_RECT:
+    case PRIM_FILL_RECT:
+        (reference ? ref_rect : ssd1306_rect)(ssd, p->a, p->b, p->c, p->d, p->value, prim == PRIM_FILL_RECT);
+        break;
+    case PRIM_CHAR:
+        (reference ? ref_draw_char : ssd1306_draw_char)(ssd, p->ch, p->a, p->b);
+        break;
+    default:
+        break;
+    }
+}
+
+static uint32_t seed = 4321;
+
+static uint32_t rnd(uint32_t n) {
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 8) % n;
+}
+
+// Coordenadas até um pouco além da tela, para exercitar o recorte
+static prim_args_t random_args(prim_t prim) {
+    prim_args_t p;
+    p.value = rnd(2);
+    p.ch = (char)(rnd(4) ? ' ' + rnd(95) : rnd(256));
+    switch (prim) {
+    case PRIM_VLINE:
+        p.a = rnd(WIDTH + 8); p.b = rnd(HEIGHT + 8); p.c = p.b + rnd(HEIGHT + 8 - p.b);
+        break;
+    case PRIM_HLINE:
+        p.a = rnd(WIDTH + 8); p.b = p.a + rnd(WIDTH + 8 - p.a); p.c = rnd(HEIGHT + 8);
+        break;
+    case PRIM_LINE:
+        p.a = rnd(WIDTH + 8); p.b = rnd(HEIGHT + 8); p.c = rnd(WIDTH + 8); p.d = rnd(HEIGHT + 8);
+        if (rnd(4) == 0) p.c = p.a; // Verticais e horizontais pelos atalhos
+        if (rnd(4) == 0) p.d = p.b;
+        break;
+    case PRIM_RECT:
+    case PRIM_FILL_RECT:
+        p.a = rnd(HEIGHT + 8); p.b = rnd(WIDTH + 8); p.c = rnd(WIDTH / 2); p.d = rnd(HEIGHT / 2);
+        break;
+    default:
+        p.a = rnd(WIDTH + 4); p.b = rnd(HEIGHT + 4);
+        break;
+    }
+    return p;
+}
+
+static void clear_dirty(ssd1306_t *ssd) {
+    memset(ssd->dirty_min, 0xFF, sizeof(ssd->dirty_min));
+    memset(ssd->dirty_max, 0, sizeof(ssd->dirty_max));
+}
+
+static void check_against_reference(ssd1306_t *fast, ssd1306_t *ref) {
+    static uint8_t before[WIDTH * HEIGHT / 8];
+    uint32_t mismatches[PRIM_COUNT] = {0}, undirty[PRIM_COUNT] = {0};
+    for (uint32_t i = 0; i < RANDOM_CASES; i++) {
+        prim_t prim = (prim_t)(i % PRIM_COUNT);
+        if (i % 64 == 0) {
+            for (size_t j = 1; j < fast->bufsize; j++)
+                fast->ram_buffer[j] = (uint8_t)rnd(256);
+            memcpy(ref->ram_buffer, fast->ram_buffer, fast->bufsize);
+        }
+        prim_args_t p = random_args(prim);
+        memcpy(before, fast->ram_buffer + 1, sizeof(before));
+        clear_dirty(fast);
+        run_prim(fast, prim, &p, false);
+        run_prim(ref, prim, &p, true);
+
+        if (memcmp(fast->ram_buffer, ref->ram_buffer, fast->bufsize)) {
+            if (!mismatches[prim]++)
+                printf("  %s(%u, %u, %u, %u, %d, 0x%02x) difere da referência\n", prim_names[prim],
+                       p.a, p.b, p.c, p.d, p.value, (uint8_t)p.ch);
+            memcpy(fast->ram_buffer, ref->ram_buffer, fast->bufsize);
+        }
+        for (uint32_t j = 0; j < sizeof(before); j++) {
+            uint8_t x = j / fast->pages, page = j % fast->pages;
+            if (before[j] != fast->ram_buffer[1 + j] &&
+                (x < fast->dirty_min[page] || x > fast->dirty_max[page])) {
+                undirty[prim]++;
+                break;
+            }
+        }
+    }
+    for (int prim = 0; prim < PRIM_COUNT; prim++) {
+        CHECK(!mismatches[prim], "%s: %u de %u casos diferentes da referência", prim_names[prim],
+              mismatches[prim], RANDOM_CASES / PRIM_COUNT);
+        CHECK(!undirty[prim], "%s: %u casos com bytes alterados fora da faixa suja", prim_names[prim],
+              undirty[prim]);
+    }
+    printf("referência: %u casos sorteados por primitiva\n", RANDOM_CASES / PRIM_COUNT);
+}
+
+// --- Benchmark ---
+
+static void bench(ssd1306_t *ssd, int calls) {
+    // Casos típicos da interface: barra, separador, traço, moldura, painel, texto
+    static const prim_args_t typical[PRIM_COUNT] = {
+        [PRIM_VLINE] = {64, 3, 60, 0, true, 0},
+        [PRIM_HLINE] = {0, 127, 13, 0, true, 0},
+        [PRIM_LINE] = {5, 60, 120, 10, true, 0},
+        [PRIM_RECT] = {0, 0, 128, 64, true, 0},
+        [PRIM_FILL_RECT] = {20, 10, 100, 30, true, 0},
+        [PRIM_CHAR] = {40, 21, 0, 0, true, 'A'},
+    };
+    printf("\n%-18s %10s %12s %8s  (%s do host por chamada)\n", "primitiva", "atual", "referência",
+           "ganho", HOST_CYCLES_UNIT);
+    for (int prim = 0; prim < PRIM_COUNT; prim++) {
+        double per_call[2];
+        for (int reference = 0; reference < 2; reference++) {
+            uint64_t t0 = host_cycles();
+            for (int i = 0; i < calls; i++)
+                run_prim(ssd, (prim_t)prim, &typical[prim], reference);
+            per_call[reference] = (double)(host_cycles() - t0) / calls;
+        }
+        printf("%-18s %10.0f %12.0f %7.1fx\n", prim_names[prim], per_call[0], per_call[1],
+               per_call[1] / (per_call[0] > 0 ? per_call[0] : 1));
+    }
+}
+
+int main(int argc, char **argv) {
+    int calls = argc > 1 ? atoi(argv[1]) : 20000;
+    if (calls <= 0) calls = 20000;
+
+    static ssd1306_t fast, ref;
+    ssd1306_init(&fast, WIDTH, HEIGHT, false, 0x3C, i2c1);
+    ssd1306_init(&ref, WIDTH, HEIGHT, false, 0x3C, i2c1);
+
+    check_against_reference(&fast, &ref);
+    bench(&fast, calls);
+
+    return check_exit("ssd1306_raster");
+}
@@ -0,0 +1,330 @@
+// Verificação no host da telemetria (lib/telemetry.h) com um decodificador
+// independente, o mesmo algoritmo de tools/telemetry_decode.py.
+//
+// Confere que:
+//   - quadros com payload aleatório (com zeros, de 0 a TELEMETRY_MAX_PAYLOAD
+//     bytes) voltam iguais depois de COBS, CRC-8 e da fila, com seq contínuo;
+//   - o COBS de trechos longos sem zero (blocos 0xFF) não tem 0x00 e volta;
+//   - o CRC-8 acusa qualquer bit trocado no quadro;
+//   - com a fila cheia os quadros inteiros são descartados e a lacuna de seq
+//     no host é igual a telemetry_dropped();
+//   - um destino que aceita poucos bytes por vez não corta nem repete nada;
+//   - o printf do firmware (console_out_chars) vira quadros de texto que
+//     remontam o texto original, e o destino USB (telemetry_usb_sink) não
+//     passa do espaço livre do CDC;
+//   - com a fila cheia, o printf do núcleo 0 a escoa ele mesmo em vez de
+//     esperar o prazo inteiro por si próprio, e o do núcleo 1 não espera e
+//     descarta o quadro.
+//
+// Uso: colorlux_telemetry_check
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "check.h"
+
+static int sim_printf(const char *fmt, ...) {
+    (void)fmt;
+    return 0;
+}
+
+#define printf sim_printf
+#define main firmware_main
+#include "../Luminosidade-Cores.c"
+#undef main
+#undef printf
+
+#define STREAM_MAX 65536
+
+// Fluxo capturado do destino
+static uint8_t stream[STREAM_MAX];
+static uint32_t stream_len;
+static uint32_t sink_limit; // Bytes aceitos por chamada (0 = tudo)
+
+static uint32_t capture_sink(const uint8_t *data, uint32_t len) {
+    if (sink_limit && len > sink_limit)
+        len = sink_limit;
+    if (len > STREAM_MAX - stream_len)
+        len = STREAM_MAX - stream_len;
+    memcpy(stream + stream_len, data, len);
+    stream_len += len;
+    return len;
+}
+
+static void drain_all(void) {
+    while (telemetry_drain(capture_sink))
+        ;
+}
+
+// Retorna o tamanho decodificado ou -1 se o COBS é inválido
+static int cobs_decode(const uint8_t *src, uint32_t len, uint8_t *dst) {
+    uint32_t i = 0, out = 0;
+    while (i < len) {
+        uint8_t code = src[i];
+        if (!code || i + code > len)
+            return -1;
+        memcpy(dst + out, src + i + 1, code - 1u);
+        out += code - 1u;
+        i += code;
+        if (code < 0xFF && i < len)
+            dst[out++] = 0;
+    }
+    return (int)out;
+}
+
+typedef struct {
+    uint8_t type;
+    uint32_t seq;
+    uint32_t time_us;
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    uint8_t len;
+} frame_t;
+
+static uint32_t get_u32(const uint8_t *p) {
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// Separa e valida os quadros do fluxo; conta os inválidos
+static uint32_t decode_stream(frame_t *frames, uint32_t max, uint32_t *bad) {
+    uint32_t count = 0, start = 0;
+    *bad = 0;
+    for (uint32_t i = 0; i < stream_len; i++) {
+        if (stream[i])
+            continue;
+        uint8_t raw[TELEMETRY_MAX_FRAME + 8];
+        uint32_t n = i - start;
+        int len = n <= sizeof(raw) - 2 ? cobs_decode(stream + start, n, raw) : -1;
+        start = i + 1;
+        if (!n)
+            continue;
+        if (len < TELEMETRY_HEADER_SIZE + 1 || len > TELEMETRY_MAX_FRAME ||
+            telemetry_crc8(raw, (uint32_t)len - 1) != raw[len - 1]) {
+            (*bad)++;
+            continue;
+        }
+        if (count == max)
+            break;
+        frame_t *f = &frames[count++];
+        f->type = raw[0];
+        f->seq = get_u32(raw + 1);
+        f->time_us = get_u32(raw + 5);
+        f->len = (uint8_t)(len - TELEMETRY_HEADER_SIZE - 1);
+        memcpy(f->payload, raw + TELEMETRY_HEADER_SIZE, f->len);
+    }
+    return count;
+}
+
+static frame_t frames[1024];
+
+static void reset(void) {
+    telemetry_init();
+    stream_len = 0;
+    sink_limit = 0;
+}
+
+static void check_round_trip(void) {
+    reset();
+    srand(1);
+    static uint8_t sent[200][TELEMETRY_MAX_PAYLOAD];
+    uint8_t lens[200];
+    uint32_t n_sent = 0;
+    for (uint32_t i = 0; i < 200; i++) {
+        lens[i] = (uint8_t)(i % (TELEMETRY_MAX_PAYLOAD + 1));
+        for (uint8_t j = 0; j < lens[i]; j++)
+            sent[i][j] = (rand() % 4) ? (uint8_t)rand() : 0; // Um quarto de zeros
+        // Esvazia antes de encher: aqui nada pode ser descartado
+        if (telemetry_free() < TELEMETRY_MAX_ENCODED)
+            drain_all();
+        CHECK(telemetry_send(TELEMETRY_TYPE_SAMPLE, 1000 + i, sent[i], lens[i]), "quadro %u descartado", i);
+        n_sent++;
+    }
+    drain_all();
+
+    uint32_t bad;
+    uint32_t n = decode_stream(frames, 1024, &bad);
+    CHECK(n == n_sent && bad == 0, "ida e volta: %u de %u quadros, %u inválidos", n, n_sent, bad);
+    for (uint32_t i = 0; i < n && i < n_sent; i++) {
+        const frame_t *f = &frames[i];
+        if (f->seq != i || f->time_us != 1000 + i || f->type != TELEMETRY_TYPE_SAMPLE ||
+            f->len != lens[i] || memcmp(f->payload, sent[i], lens[i])) {
+            CHECK(false, "quadro %u diferente do enviado", i);
+            break;
+        }
+    }
+    printf("ida e volta: %u quadros, %u bytes\n", n, stream_len);
+}
+
+static void check_cobs_long(void) {
+    static uint8_t src[1000], enc[1100], dec[1100];
+    static const uint32_t lens[] = {253, 254, 255, 508, 1000};
+    for (uint32_t k = 0; k < sizeof(lens) / sizeof(lens[0]); k++) {
+        uint32_t len = lens[k];
+        for (uint32_t i = 0; i < len; i++)
+            src[i] = (uint8_t)(1 + i % 255);
+        uint32_t n = telemetry_cobs_encode(src, len, enc);
+        CHECK(memchr(enc, 0, n) == NULL, "COBS de %u bytes contém 0x00", len);
+        CHECK(n == len + 1 + len / 254, "COBS de %u bytes: %u codificados", len, n);
+        int m = cobs_decode(enc, n, dec);
+        CHECK(m == (int)len && !memcmp(src, dec, len), "COBS de %u bytes não volta igual", len);
+    }
+}
+
+static void check_crc(void) {
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    for (uint32_t i = 0; i < sizeof(frame) - 1; i++)
+        frame[i] = (uint8_t)(i * 37);
+    frame[sizeof(frame) - 1] = telemetry_crc8(frame, sizeof(frame) - 1);
+    uint32_t missed = 0;
+    for (uint32_t bit = 0; bit < sizeof(frame) * 8; bit++) {
+        frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+        if (telemetry_crc8(frame, sizeof(frame) - 1) == frame[sizeof(frame) - 1])
+            missed++;
+        frame[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+    }
+    CHECK(missed == 0, "CRC-8 não acusou %u bits trocados", missed);
+}
+
+static void check_drops(void) {
+    reset();
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    memset(payload, 0xA5, sizeof(payload));
+    uint32_t accepted = 0, rejected = 0;
+    for (uint32_t i = 0; i < 100; i++) {
+        if (telemetry_send(TELEMETRY_TYPE_SAMPLE, i, payload, sizeof(payload)))
+            accepted++;
+        else
+            rejected++;
+    }
+    drain_all();
+    // Depois de esvaziar a fila volta a aceitar, e o seq mostra o buraco
+    CHECK(telemetry_send(TELEMETRY_TYPE_SAMPLE, 100, payload, sizeof(payload)), "fila esvaziada recusou quadro");
+    drain_all();
+
+    uint32_t bad;
+    uint32_t n = decode_stream(frames, 1024, &bad);
+    uint32_t gap = 0;
+    for (uint32_t i = 1; i < n; i++)
+        gap += frames[i].seq - frames[i - 1].seq - 1;
+    CHECK(bad == 0, "fila cheia: %u quadros inválidos (quadro cortado)", bad);
+    CHECK(n == accepted + 1, "fila cheia: %u quadros no host, %u aceitos", n, accepted + 1);
+    CHECK(rejected > 0 && gap == rejected && telemetry_dropped() == rejected,
+          "fila cheia: %u recusados, lacuna de seq %u, telemetry_dropped %u", rejected, gap, telemetry_dropped());
+    printf("fila cheia: %u quadros aceitos, %u descartados\n", accepted, rejected);
+}
+
+static void check_partial_sink(void) {
+    reset();
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+    uint32_t sent = 0;
+    for (uint32_t round = 0; round < 20; round++) {
+        for (uint32_t i = 0; i < 10; i++) {
+            memset(payload, (int)(sent & 0xFF), sizeof(payload));
+            if (telemetry_send(TELEMETRY_TYPE_SAMPLE, sent, payload, (uint8_t)(sent % sizeof(payload))))
+                sent++;
+        }
+        sink_limit = 1 + round % 7;
+        telemetry_drain(capture_sink); // Só uma parte: o resto fica para a próxima rodada
+    }
+    sink_limit = 3;
+    drain_all();
+
+    uint32_t bad;
+    uint32_t n = decode_stream(frames, 1024, &bad);
+    bool in_order = true;
+    for (uint32_t i = 0; i < n; i++)
+        if (frames[i].seq != i || frames[i].time_us != i)
+            in_order = false;
+    CHECK(n == sent && bad == 0 && in_order && telemetry_dropped() == 0,
+          "destino parcial: %u de %u quadros, %u inválidos, %u descartados", n, sent, bad, telemetry_dropped());
+}
+
+static void check_console(void) {
+    reset();
+    static char text[600];
+    uint32_t len = 0;
+    while (len < sizeof(text) - 40)
+        len += (uint32_t)snprintf(text + len, sizeof(text) - len, "calib: exposição %u, linha %u\n", len, len / 7);
+
+    console_out_chars(text, (int)len);
+    console_out_chars("", 0);
+    uint8_t sample_payload[4] = {0, 1, 0, 2};
+    telemetry_send(TELEMETRY_TYPE_SAMPLE, 0, sample_payload, sizeof(sample_payload));
+    console_out_chars("fim\n", 4);
+    drain_all();
+
+    uint32_t bad;
+    uint32_t n = decode_stream(frames, 1024, &bad);
+    static char joined[700];
+    uint32_t joined_len = 0, samples = 0;
+    bool fits = true;
+    for (uint32_t i = 0; i < n; i++) {
+        if (frames[i].type == TELEMETRY_TYPE_SAMPLE) {
+            samples++;
+            continue;
+        }
+        if (frames[i].type != TELEMETRY_TYPE_TEXT || !frames[i].len || frames[i].len > TELEMETRY_MAX_PAYLOAD)
+            fits = false;
+        memcpy(joined + joined_len, frames[i].payload, frames[i].len);
+        joined_len += frames[i].len;
+    }
+    memcpy(text + len, "fim\n", 4);
+    len += 4;
+    CHECK(bad == 0 && samples == 1 && fits, "console: %u inválidos, %u amostras, tamanhos %s",
+          bad, samples, fits ? "ok" : "fora do limite");
+    CHECK(joined_len == len && !memcmp(joined, text, len), "console: texto remontado difere (%u de %u bytes)",
+          joined_len, len);
+    printf("console: %u bytes em %u quadros de texto\n", len, n - samples);
+}
+
+static void check_usb_sink(void) {
+    reset();
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD] = {0};
+    while (telemetry_send(TELEMETRY_TYPE_SAMPLE, 0, payload, sizeof(payload)))
+        ;
+    uint32_t before = sim_usb_cdc_bytes;
+    uint32_t room = tud_cdc_write_available();
+    uint32_t n = telemetry_drain(telemetry_usb_sink);
+    CHECK(n == room && sim_usb_cdc_bytes - before == room && tud_cdc_write_available() == 0,
+          "destino USB: %u bytes entregues com %u livres no CDC", n, room);
+    CHECK(telemetry_drain(telemetry_usb_sink) == 0, "destino USB aceitou bytes com o CDC cheio");
+}
+
+static void check_console_full(void) {
+    reset();
+    uint8_t payload = 0;
+    while (telemetry_send(TELEMETRY_TYPE_SAMPLE, 0, &payload, 1)) // Sem espaço nem para o menor quadro
+        ;
+
+    sim_core_num = 1;
+    uint32_t dropped = telemetry_dropped();
+    uint64_t t0 = sim_now_us();
+    console_out_chars("núcleo 1\n", 10);
+    CHECK(sim_now_us() == t0 && telemetry_dropped() == dropped + 1,
+          "console no núcleo 1 com a fila cheia: esperou %llu us, %u descartados",
+          (unsigned long long)(sim_now_us() - t0), telemetry_dropped() - dropped);
+
+    sim_core_num = 0;
+    dropped = telemetry_dropped();
+    uint32_t cdc_before = sim_usb_cdc_bytes;
+    t0 = sim_now_us();
+    console_out_chars("núcleo 0\n", 10);
+    uint64_t waited = sim_now_us() - t0;
+    CHECK(telemetry_dropped() == dropped && sim_usb_cdc_bytes > cdc_before && waited < CONSOLE_OUT_TIMEOUT_US,
+          "console no núcleo 0 com a fila cheia: esperou %llu us, %u descartados, %u bytes no CDC",
+          (unsigned long long)waited, telemetry_dropped() - dropped, sim_usb_cdc_bytes - cdc_before);
+    printf("console com a fila cheia: núcleo 0 escoou em %llu us\n", (unsigned long long)waited);
+}
+
+int main(void) {
+    check_round_trip();
+    check_cobs_long();
+    check_crc();
+    check_drops();
+    check_partial_sink();
+    check_console();
+    check_usb_sink();
+    check_console_full();
+
+    return check_exit("telemetry");
+}
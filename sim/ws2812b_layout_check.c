@@ -0,0 +1,177 @@
+// Verificação no host da geometria da matriz WS2812B (lib/ws2812b.h): o mapa
+// de índices de cada ligação contra fórmulas independentes, o desenho de
+// bitmaps compactados e os dígitos na matriz da placa contra o quadro que o
+// código antigo enviava (LED i da cadeia = glyph[24 - i], com os desenhos
+// guardados com as linhas 1 e 3 espelhadas).
+//
+// Uso: colorlux_ws2812b_layout_check
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "ws2812b.h"
+#include "check.h"
+
+typedef struct {
+    const char *name;
+    ws2812b_layout_t layout;
+} layout_case_t;
+
+static const layout_case_t layouts[] = {
+    {"linhas", WS2812B_LAYOUT_ROW_MAJOR},
+    {"serpentina", WS2812B_LAYOUT_SERPENTINE},
+    {"espelho_x", WS2812B_LAYOUT_FLIP_X},
+    {"espelho_y", WS2812B_LAYOUT_FLIP_Y},
+    {"colunas", WS2812B_LAYOUT_TRANSPOSE},
+    {"rot90", WS2812B_LAYOUT_ROTATE_90},
+    {"rot180", WS2812B_LAYOUT_ROTATE_180},
+    {"rot270", WS2812B_LAYOUT_ROTATE_270},
+    {"serpentina_rot90", WS2812B_LAYOUT_SERPENTINE | WS2812B_LAYOUT_ROTATE_90},
+    {"bitdoglab", WS2812B_LAYOUT_BITDOGLAB},
+};
+
+static const struct { uint16_t w, h; } sizes[] = {{5, 5}, {8, 8}, {16, 8}, {7, 3}, {1, 4}, {32, 8}};
+
+// Referência: coordenadas físicas (coluna, linha) e largura física de cada
+// ligação, escritas diretamente em vez de compostas como em ws2812b.c
+static int reference_index(ws2812b_layout_t layout, int w, int h, int x, int y) {
+    int px, py, pw;
+    switch (layout & ~WS2812B_LAYOUT_SERPENTINE) {
+    case WS2812B_LAYOUT_ROW_MAJOR:  px = x;         py = y;         pw = w; break;
+    case WS2812B_LAYOUT_FLIP_X:     px = w - 1 - x; py = y;         pw = w; break;
+    case WS2812B_LAYOUT_FLIP_Y:     px = x;         py = h - 1 - y; pw = w; break;
+    case WS2812B_LAYOUT_ROTATE_180: px = w - 1 - x; py = h - 1 - y; pw = w; break;
+    case WS2812B_LAYOUT_TRANSPOSE:  px = y;         py = x;         pw = h; break;
+    case WS2812B_LAYOUT_ROTATE_90:  px = h - 1 - y; py = x;         pw = h; break; // Horário
+    case WS2812B_LAYOUT_ROTATE_270: px = y;         py = w - 1 - x; pw = h; break;
+    default: return -1;
+    }
+    if ((layout & WS2812B_LAYOUT_SERPENTINE) && (py % 2))
+        px = pw - 1 - px;
+    return py * pw + px;
+}
+
+static void check_map(const layout_case_t *lc, uint16_t w, uint16_t h) {
+    int n = w * h;
+    uint8_t *seen = calloc(n, 1);
+    int wrong = 0, dup = 0;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int got = ws2812b_layout_index(lc->layout, w, h, (uint16_t)x, (uint16_t)y);
+            if (got != reference_index(lc->layout, w, h, x, y))
+                wrong++;
+            if (got < 0 || got >= n || seen[got]++)
+                dup++;
+        }
+    }
+    CHECK(wrong == 0, "%s %ux%u: %d posições diferentes da referência", lc->name, w, h, wrong);
+    CHECK(dup == 0, "%s %ux%u: o mapa não é uma permutação", lc->name, w, h);
+    free(seen);
+}
+
+// Dígitos como estavam em ws2812b_definitions.h antes dos bitmaps compactados
+static const uint8_t old_digits[10][25] = {
+    {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+    {0, 0, 1, 0, 0, 0, 0, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0},
+    {0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 0},
+    {0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 1, 1, 1, 0},
+    {0, 1, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0},
+    {0, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 1, 1, 1, 0},
+    {0, 1, 1, 1, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 1, 0, 0, 1, 1, 1, 0},
+    {0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0},
+    {0, 1, 1, 1, 0, 0, 1, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 1, 0, 0, 1, 1, 1, 0},
+    {0, 1, 1, 1, 0, 0, 1, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 1, 1, 1, 0},
+};
+
+// Cada dígito desenhado por ws2812b_draw_rgb() na matriz da placa sai com os
+// mesmos bytes, na mesma ordem da cadeia, que o ws2812b_draw_rgb() antigo
+static void check_board_digits(void) {
+    ws2812b_t *board = init_ws2812b(pio0, WS2812B_PIN);
+    CHECK(board != NULL, "init da placa");
+    if (!board) return;
+    const uint32_t on = 20u << 24 | 10u << 16 | 30u << 8;
+    for (int d = 0; d < 10; d++) {
+        ws2812b_wait(board);
+        ws2812b_draw_rgb(board, NUMERIC_GLYPHS[d], 10, 20, 30);
+        const uint32_t *frame = board->frames[board->back]; // Cópia do quadro enviado
+        int wrong = 0;
+        for (int i = 0; i < WS2812B_NUM_LEDS; i++)
+            if (frame[i] != (old_digits[d][24 - i] ? on : 0))
+                wrong++;
+        CHECK(wrong == 0, "dígito %d na placa: %d LEDs diferentes do quadro antigo", d, wrong);
+    }
+}
+
+static uint32_t seed = 777;
+
+static uint32_t rand32(void) {
+    seed = seed * 1103515245u + 12345u;
+    uint32_t hi = seed >> 16;
+    seed = seed * 1103515245u + 12345u;
+    return hi << 16 | seed >> 16;
+}
+
+// Desenho de bitmap: cada LED ligado/apagado conforme o bit do seu pixel lógico
+static void check_draw(ws2812b_layout_t layout, uint16_t w, uint16_t h) {
+    ws2812b_t *ws = init_ws2812b_matrix(pio1, 0, w, h, layout);
+    CHECK(ws != NULL, "init %ux%u", w, h);
+    if (!ws) return;
+    uint n = (uint)w * h;
+    uint32_t *glyph = malloc(sizeof(uint32_t) * WS2812B_BITMAP_WORDS(n));
+    for (uint i = 0; i < WS2812B_BITMAP_WORDS(n); i++)
+        glyph[i] = rand32();
+
+    ws2812b_wait(ws);
+    ws2812b_draw_rgb(ws, glyph, 10, 20, 30);
+    const uint32_t on = 20u << 24 | 10u << 16 | 30u << 8;
+    const uint32_t *frame = ws->frames[ws->back]; // Cópia do quadro enviado
+    int wrong = 0;
+    for (uint y = 0; y < h; y++) {
+        for (uint x = 0; x < w; x++) {
+            uint i = y * w + x;
+            uint32_t want = (glyph[i / 32] >> (i % 32)) & 1 ? on : 0;
+            if (frame[ws2812b_layout_index(layout, w, h, (uint16_t)x, (uint16_t)y)] != want)
+                wrong++;
+        }
+    }
+    CHECK(wrong == 0, "desenho %ux%u: %d LEDs errados", w, h, wrong);
+    CHECK(sim_pio_stats.transfers > 0, "desenho %ux%u: nada enviado", w, h);
+
+    // set_pixel_xy leva ao mesmo lugar que o mapa
+    ws2812b_clear(ws);
+    ws2812b_set_pixel_xy(ws, w - 1, h - 1, 1, 2, 3);
+    CHECK(ws->frames[ws->back][ws2812b_layout_index(layout, w, h, w - 1, h - 1)] == (2u << 24 | 1u << 16 | 3u << 8),
+          "set_pixel_xy %ux%u", w, h);
+    free(glyph);
+}
+
+int main(void) {
+    for (size_t l = 0; l < sizeof(layouts) / sizeof(layouts[0]); l++)
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+            check_map(&layouts[l], sizes[s].w, sizes[s].h);
+
+    check_board_digits();
+
+    // Bitmaps compactados em tempo de compilação: o desenho linha a linha
+    const uint8_t one[25] = {
+        0, 0, 1, 0, 0,
+        0, 1, 1, 0, 0,
+        0, 0, 1, 0, 0,
+        0, 0, 1, 0, 0,
+        0, 1, 1, 1, 0,
+    };
+    uint32_t packed = 0;
+    for (int i = 0; i < 25; i++)
+        packed |= (uint32_t)one[i] << i;
+    CHECK(ONE_GLYPH[0] == packed, "ONE_GLYPH compactado 0x%08x em vez de 0x%08x", ONE_GLYPH[0], packed);
+    CHECK(ZERO_GLYPH[0] == 0x1FFFFFF, "ZERO_GLYPH compactado 0x%08x", ZERO_GLYPH[0]);
+
+    check_draw(WS2812B_LAYOUT_SERPENTINE, 16, 16);
+    check_draw(WS2812B_LAYOUT_ROTATE_90, 32, 8);
+    check_draw(WS2812B_LAYOUT_BITDOGLAB, 5, 5);
+
+    printf("%zu ligações x %zu tamanhos conferidos\n",
+           sizeof(layouts) / sizeof(layouts[0]), sizeof(sizes) / sizeof(sizes[0]));
+    return check_exit("ws2812b_layout");
+}
@@ -0,0 +1,101 @@
+// Verificação no host de ws2812b_present() (lib/ws2812b.c) sobre o DMA e o
+// PIO simulados, olhando as palavras que cada transferência entregou à FIFO.
+//
+// Confere que:
+//   - o quadro composto sai inteiro, na ordem da cadeia, e o callback de fim
+//     roda uma vez por quadro;
+//   - durante o DMA e durante o reset dos LEDs (WS2812B_LATCH_US depois de a
+//     FIFO esvaziar) o resultado é BUSY e nada é transmitido;
+//   - um quadro igual ao último enviado dá SKIPPED, sem transferência;
+//   - depois de um envio, ws2812b_set_pixel() parcial parte do último quadro
+//     (os outros LEDs continuam como estavam), também em envios seguidos.
+//
+// Uso: colorlux_ws2812b_present_check
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "ws2812b.h"
+#include "check.h"
+
+#define GRB(r, g, b) (((uint32_t)(g) << 24) | ((uint32_t)(r) << 16) | ((uint32_t)(b) << 8))
+
+static uint32_t done_calls;
+
+static void on_done(ws2812b_t *ws, void *user_data) {
+    (void)ws;
+    (void)user_data;
+    done_calls++;
+}
+
+static bool sent_equals(const ws2812b_t *ws, const uint32_t *expected) {
+    uint sm = ws->state_machine_id;
+    return sim_pio_frame_len[0][sm] == ws->num_leds &&
+           !memcmp(sim_pio_frame[0][sm], expected, ws->num_leds * sizeof(uint32_t));
+}
+
+int main(void) {
+    sim_devices_init();
+    ws2812b_t *ws = init_ws2812b_matrix(pio0, WS2812B_PIN, WS2812B_WIDTH, WS2812B_HEIGHT, WS2812B_LAYOUT_ROW_MAJOR);
+    ws2812b_set_done_callback(ws, on_done, NULL);
+
+    uint32_t expected[WS2812B_NUM_LEDS];
+    for (uint i = 0; i < WS2812B_NUM_LEDS; i++) {
+        ws2812b_set_pixel(ws, i, (uint8_t)(i * 10), (uint8_t)(255 - i), (uint8_t)(i + 1));
+        expected[i] = GRB(i * 10, 255 - i, i + 1);
+    }
+
+    // Primeiro quadro
+    uint64_t t0 = sim_now_us();
+    CHECK(ws2812b_present(ws) == WS2812B_PRESENT_STARTED, "primeiro quadro não começou");
+    CHECK(sent_equals(ws, expected), "primeiro quadro transmitido difere do composto");
+
+    // Durante o DMA
+    ws2812b_set_pixel(ws, 0, 1, 2, 3);
+    CHECK(ws2812b_present(ws) == WS2812B_PRESENT_BUSY, "present durante o DMA não deu BUSY");
+
+    // Depois do DMA, ainda no reset dos LEDs
+    while (ws->busy && sim_run_next_event())
+        ;
+    uint64_t dma_done_us = sim_now_us() - t0;
+    CHECK(!ws->busy && ws2812b_is_busy(ws), "sem espera pelo reset depois do DMA");
+    CHECK(ws2812b_present(ws) == WS2812B_PRESENT_BUSY, "present durante o reset não deu BUSY");
+    ws2812b_wait(ws);
+    uint64_t ready_us = sim_now_us() - t0;
+    printf("quadro de %u LEDs: DMA em %llu us, livre em %llu us\n", WS2812B_NUM_LEDS,
+           (unsigned long long)dma_done_us, (unsigned long long)ready_us);
+    CHECK(ready_us >= (uint64_t)WS2812B_NUM_LEDS * SIM_PIO_WORD_US + WS2812B_LATCH_US,
+          "novo quadro liberado em %llu us, antes das palavras e do reset", (unsigned long long)ready_us);
+    CHECK(sim_pio_stats.transfers == 1 && ws->frames_sent == 1,
+          "%u transferências e %u quadros depois dos BUSY", sim_pio_stats.transfers, ws->frames_sent);
+    CHECK(done_calls == 1, "callback de fim chamado %u vezes", done_calls);
+
+    // Desfaz a alteração feita durante o BUSY: igual ao último enviado
+    ws2812b_set_pixel(ws, 0, 0, 255, 1);
+    CHECK(ws2812b_present(ws) == WS2812B_PRESENT_SKIPPED, "quadro repetido não deu SKIPPED");
+    CHECK(sim_pio_stats.transfers == 1 && ws->frames_skipped == 1,
+          "quadro repetido: %u transferências, %u pulados", sim_pio_stats.transfers, ws->frames_skipped);
+
+    // Alteração parcial: o resto vem do último quadro
+    ws2812b_set_pixel(ws, 3, 9, 8, 7);
+    expected[3] = GRB(9, 8, 7);
+    CHECK(ws2812b_present(ws) == WS2812B_PRESENT_STARTED, "quadro parcial não começou");
+    CHECK(sent_equals(ws, expected), "quadro parcial não partiu do último enviado");
+
+    // Composto durante a transmissão do anterior, enviado em seguida
+    ws2812b_set_pixel(ws, WS2812B_NUM_LEDS - 1, 4, 5, 6);
+    expected[WS2812B_NUM_LEDS - 1] = GRB(4, 5, 6);
+    ws2812b_wait(ws);
+    CHECK(ws2812b_present(ws) == WS2812B_PRESENT_STARTED, "segundo quadro parcial não começou");
+    CHECK(sent_equals(ws, expected), "segundo quadro parcial perdeu a alteração anterior");
+
+    ws2812b_wait(ws);
+    ws2812b_clear(ws);
+    memset(expected, 0, sizeof(expected));
+    CHECK(ws2812b_present(ws) == WS2812B_PRESENT_STARTED && sent_equals(ws, expected), "quadro apagado");
+    ws2812b_wait(ws);
+    CHECK(done_calls == ws->frames_sent && ws->frames_sent == 4,
+          "%u quadros enviados, %u callbacks", ws->frames_sent, done_calls);
+
+    return check_exit("ws2812b_present");
+}
@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""Decodifica o fluxo de telemetria binária do firmware (lib/telemetry.h).
+
+Lê quadros COBS terminados em 0x00 de um arquivo ou de uma porta serial e
+imprime uma linha CSV por amostra. A saída do printf do firmware chega em
+quadros de texto e vai para o stderr, fora do CSV. Quadros com CRC inválido
+são ignorados e contados; lacunas no número de sequência indicam quadros
+descartados no dispositivo.
+
+Com --log, remonta os blocos do histórico da flash enviados pelo comando
+'d' (lib/flash_log.h) e imprime as amostras gravadas, do mais antigo ao mais
+novo, em vez das amostras ao vivo.
+
+Uso:
+    telemetry_decode.py captura.bin
+    telemetry_decode.py /dev/ttyACM0        # requer pyserial
+    telemetry_decode.py --log captura.bin
+"""
+
+import argparse
+import codecs
+import os
+import stat
+import struct
+import sys
+import zlib
+
+TYPE_SAMPLE = 0x01
+TYPE_TEXT = 0x02
+TYPE_LOG_CHUNK = 0x03
+TYPE_LOG_END = 0x04
+HEADER = struct.Struct("<BII")       # type, seq, time_us
+SAMPLE = struct.Struct("<IIIIIH")    # seq, r, g, b, c, lux
+LOG_CHUNK = struct.Struct("<HB")     # bloco, trecho (+ 32 bytes)
+LOG_CHUNK_SIZE = 32
+LOG_PAGE_SIZE = 256
+LOG_MAGIC = 0x474C
+LOG_HEADER = struct.Struct("<HHIHH")  # magic, len, seq, boot, count
+LOG_FIELD_MASKS = (0xFFFFFFFF,) * 4 + (0xFFFF,)  # r, g, b, c, lux (como flash_log_decode_block)
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("bloco COBS inválido")
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def frames(stream):
+    """Gera os quadros brutos (ainda em COBS) separados pelos zeros."""
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        buf += chunk
+        while True:
+            end = buf.find(b"\x00")
+            if end < 0:
+                break
+            if end:
+                yield bytes(buf[:end])
+            del buf[:end + 1]
+
+
+def varints(data):
+    i = 0
+    while i < len(data):
+        value = shift = 0
+        while True:
+            byte = data[i]
+            i += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        yield value
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def log_block_samples(block):
+    """Amostras (boot, time_ms, r, g, b, c, lux) de um bloco do histórico."""
+    magic, length, seq, boot, count = LOG_HEADER.unpack_from(block)
+    values = varints(block[LOG_HEADER.size:LOG_HEADER.size + length])
+    prev = None
+    for _ in range(count):
+        fields = [next(values) for _ in range(6)]
+        if prev is None:
+            prev = fields
+        else:
+            prev = [prev[0] + fields[0]] + [(p + unzigzag(d)) & mask
+                                            for p, d, mask in zip(prev[1:], fields[1:], LOG_FIELD_MASKS)]
+        yield [boot] + prev
+
+
+def log_block_valid(block):
+    magic, length, seq, boot, count = LOG_HEADER.unpack_from(block)
+    end = LOG_HEADER.size + length
+    if magic != LOG_MAGIC or end + 4 > LOG_PAGE_SIZE:
+        return False
+    return struct.unpack_from("<I", block, end)[0] == zlib.crc32(bytes(block[:end]))
+
+
+def print_log(chunks, stats):
+    """Remonta os blocos, descarta repetições (fica a de mais amostras) e
+    imprime em ordem de seq."""
+    by_seq = {}
+    for block in chunks.values():
+        if not log_block_valid(block):
+            stats["bad_blocks"] += 1
+            continue
+        _, _, seq, _, count = LOG_HEADER.unpack_from(block)
+        if seq not in by_seq or LOG_HEADER.unpack_from(by_seq[seq])[4] < count:
+            by_seq[seq] = block
+    print("boot,time_ms,r,g,b,c,lux")
+    for seq in sorted(by_seq):
+        for sample in log_block_samples(by_seq[seq]):
+            print(",".join(str(v) for v in sample))
+            stats["log_samples"] += 1
+
+
+def open_input(path):
+    if stat.S_ISCHR(os.stat(path).st_mode):
+        import serial  # pyserial
+        return serial.Serial(path, timeout=None)
+    return open(path, "rb")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="arquivo capturado ou porta serial")
+    parser.add_argument("--log", action="store_true", help="histórico da flash em vez das amostras ao vivo")
+    args = parser.parse_args()
+
+    stats = {"frames": 0, "bad": 0, "lost": 0, "bad_blocks": 0, "log_samples": 0}
+    last_seq = None
+    chunks = {}
+    text = codecs.getincrementaldecoder("utf-8")("replace")  # Um caractere pode vir em dois quadros
+
+    if not args.log:
+        print("frame_seq,time_us,sample_seq,r,g,b,c,lux")
+    try:
+        for raw in frames(open_input(args.input)):
+            try:
+                frame = cobs_decode(raw)
+            except ValueError:
+                stats["bad"] += 1
+                continue
+            if len(frame) < HEADER.size + 1 or crc8(frame[:-1]) != frame[-1]:
+                stats["bad"] += 1
+                continue
+
+            ftype, seq, time_us = HEADER.unpack_from(frame)
+            if last_seq is not None and seq != (last_seq + 1) & 0xFFFFFFFF:
+                stats["lost"] += (seq - last_seq - 1) & 0xFFFFFFFF
+            last_seq = seq
+            stats["frames"] += 1
+
+            payload = frame[HEADER.size:-1]
+            if ftype == TYPE_SAMPLE and len(payload) == SAMPLE.size and not args.log:
+                print("%d,%d,%d,%d,%d,%d,%d,%d" % ((seq, time_us) + SAMPLE.unpack(payload)))
+            elif ftype == TYPE_LOG_CHUNK and len(payload) == LOG_CHUNK.size + LOG_CHUNK_SIZE:
+                block, chunk = LOG_CHUNK.unpack_from(payload)
+                page = chunks.setdefault(block, bytearray(b"\xff" * LOG_PAGE_SIZE))
+                page[chunk * LOG_CHUNK_SIZE:(chunk + 1) * LOG_CHUNK_SIZE] = payload[LOG_CHUNK.size:]
+            elif ftype == TYPE_LOG_END and args.log:
+                break
+            elif ftype == TYPE_TEXT:
+                sys.stderr.write(text.decode(payload))
+                sys.stderr.flush()
+    except KeyboardInterrupt:
+        pass
+
+    if args.log:
+        print_log(chunks, stats)
+        print("histórico: %(log_samples)d amostras, %(bad_blocks)d blocos inválidos" % stats, file=sys.stderr)
+    print("%(frames)d quadros, %(lost)d perdidos, %(bad)d inválidos" % stats, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()